@@ -0,0 +1,115 @@
+#pragma once
+
+#include "core/SimulationSnapshot.h"
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+namespace nbody {
+
+class WorkerPool;
+
+/**
+ * @brief Named curve produced by an analysis (e.g. a radial profile)
+ */
+struct AnalysisSeries {
+    std::string name;
+    std::vector<float> x;
+    std::vector<float> y;
+};
+
+/**
+ * @brief Output of one analysis module for one snapshot
+ */
+struct AnalysisResult {
+    std::string module;
+    uint64_t step = 0;
+    double time = 0.0;
+    std::vector<std::pair<std::string, double>> scalars;
+    std::vector<AnalysisSeries> series;
+
+    void AddScalar(const std::string& name, double value) { scalars.emplace_back(name, value); }
+    void AddSeries(AnalysisSeries curve) { series.push_back(std::move(curve)); }
+};
+
+/**
+ * @brief Read-only snapshot plus the reductions every module needs
+ *
+ * The reductions (center of mass, radii about it, radial order and enclosed
+ * mass) are computed once per snapshot in parallel on the analysis workers
+ * and then shared by all modules, which run concurrently and must not modify
+ * the context.
+ */
+class AnalysisContext {
+public:
+    /**
+     * @brief Compute the shared reductions for snapshot
+     * @param pool Workers to split the reductions over
+     */
+    AnalysisContext(const SimulationSnapshot& snapshot, WorkerPool& pool);
+
+    const SimulationSnapshot& GetSnapshot() const { return m_snapshot; }
+    size_t GetBodyCount() const { return m_snapshot.size(); }
+
+    double GetTotalMass() const { return m_totalMass; }
+    glm::dvec2 GetCenterOfMass() const { return m_centerOfMass; }
+    glm::dvec2 GetCenterOfMassVelocity() const { return m_centerOfMassVelocity; }
+
+    /**
+     * @brief Distance of each body from the center of mass
+     */
+    const std::vector<float>& GetRadii() const { return m_radii; }
+
+    /**
+     * @brief Body indices sorted by distance from the center of mass
+     */
+    const std::vector<uint32_t>& GetRadialOrder() const { return m_radialOrder; }
+
+    /**
+     * @brief Mass enclosed by the first i+1 bodies of the radial order
+     */
+    const std::vector<double>& GetEnclosedMass() const { return m_enclosedMass; }
+
+    /**
+     * @brief Radius enclosing the given fraction of the total mass
+     */
+    float GetMassRadius(double fraction) const;
+
+    /**
+     * @brief Position and velocity of a body relative to the center of mass
+     */
+    glm::vec2 GetRelativePosition(size_t index) const;
+    glm::vec2 GetRelativeVelocity(size_t index) const;
+
+private:
+    const SimulationSnapshot& m_snapshot;
+    double m_totalMass = 0.0;
+    glm::dvec2 m_centerOfMass{0.0};
+    glm::dvec2 m_centerOfMassVelocity{0.0};
+    std::vector<float> m_radii;
+    std::vector<uint32_t> m_radialOrder;
+    std::vector<double> m_enclosedMass;
+};
+
+/**
+ * @brief Interface of in-situ analysis modules
+ *
+ * Analyze() is called on a worker thread for every analyzed snapshot,
+ * concurrently with the other modules. A module instance is only ever
+ * running one Analyze() at a time, so it may keep state between calls.
+ */
+class AnalysisModule {
+public:
+    virtual ~AnalysisModule() = default;
+
+    /**
+     * @brief Short identifier, also used for the output file names
+     */
+    virtual const char* GetName() const = 0;
+
+    virtual void Analyze(const AnalysisContext& context, AnalysisResult& result) = 0;
+};
+
+} // namespace nbody
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "analysis/AnalysisModule.h"
+#include "core/SimulationSnapshot.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+namespace nbody {
+
+class Body;
+class WorkerPool;
+
+/**
+ * @brief Configuration for the in-situ analysis pipeline
+ */
+struct AnalysisConfig {
+    int interval = 100;                 // Physics steps between analyzed snapshots
+    int workerCount = 0;                // Analysis worker threads, 0 = hardware threads - 1
+    std::string outputDirectory = "analysis"; // One CSV pair per module, empty = no files
+};
+
+/**
+ * @brief Runs registered analysis modules on snapshots in the background
+ *
+ * Submit() copies the state into a snapshot and returns; a coordinator thread
+ * computes the shared reductions on the worker pool, runs every module on it
+ * concurrently and writes the results. There is one pending slot: if the
+ * previous snapshot is still being analyzed when a new one is submitted, the
+ * pending one is replaced and counted as dropped, so analysis never holds up
+ * the physics step.
+ *
+ * Each module writes <module>.csv (one row of scalars per snapshot) and
+ * <module>_series.csv (step, time, series, x, y rows) to the output directory.
+ */
+class AnalysisPipeline {
+public:
+    explicit AnalysisPipeline(const AnalysisConfig& config = AnalysisConfig());
+    ~AnalysisPipeline();
+
+    /**
+     * @brief Add a module; only allowed before Start()
+     */
+    void Register(std::unique_ptr<AnalysisModule> module);
+
+    /**
+     * @brief Register the radial profile, Lagrangian radii, velocity dispersion and angular momentum modules
+     */
+    void RegisterStandardModules();
+
+    void Start();
+    void Stop();
+
+    /**
+     * @brief Queue the state for analysis if step is a multiple of the interval
+     * @param force Queue regardless of the interval
+     * @return True if the state was queued
+     */
+    bool Submit(const std::vector<std::unique_ptr<Body>>& bodies, uint64_t step, double time, bool force = false);
+
+    /**
+     * @brief Most recent result of every module (copied under the lock)
+     */
+    std::vector<AnalysisResult> GetLatestResults() const;
+
+    void SetInterval(int interval) { m_config.interval = interval > 0 ? interval : 1; }
+    const AnalysisConfig& GetConfig() const { return m_config; }
+
+    uint64_t GetCompletedCount() const { return m_completed.load(); }
+    uint64_t GetDroppedCount() const { return m_dropped.load(); }
+    double GetLastDurationMs() const { return m_lastDurationMs.load(); }
+
+private:
+    void CoordinatorLoop();
+    void Process(const SimulationSnapshot& snapshot);
+    void WriteResult(size_t moduleIndex, const AnalysisResult& result);
+
+    AnalysisConfig m_config;
+    std::vector<std::unique_ptr<AnalysisModule>> m_modules;
+    std::unique_ptr<WorkerPool> m_pool;
+
+    // Snapshot buffers: m_capture is filled by the physics thread, swapped into
+    // m_pending under the lock and from there into m_working by the coordinator
+    SimulationSnapshot m_capture;
+    SimulationSnapshot m_pending;
+    SimulationSnapshot m_working;
+    bool m_hasPending = false;
+
+    // Coordinator-owned output files, two per module (scalars, series)
+    std::vector<std::ofstream> m_scalarFiles;
+    std::vector<std::ofstream> m_seriesFiles;
+
+    std::vector<AnalysisResult> m_latest;   // Guarded by m_mutex
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_coordinator;
+    bool m_stopRequested = false;
+    bool m_started = false;
+
+    std::atomic<uint64_t> m_completed{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<double> m_lastDurationMs{0.0};
+};
+
+} // namespace nbody
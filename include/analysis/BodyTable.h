@@ -0,0 +1,113 @@
+#pragma once
+
+#include "core/LatestOnlyWorker.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <limits>
+
+namespace nbody {
+
+class Body;
+
+/**
+ * @brief Column the body table is sorted and filtered by
+ */
+enum class BodyTableKey {
+    Index,
+    Mass,
+    Speed,
+    KineticEnergy
+};
+
+/**
+ * @brief Which bodies the body table lists, and in what order
+ */
+struct BodyTableQuery {
+    BodyTableKey key = BodyTableKey::Mass;
+    bool descending = true;
+    float minValue = 0.0f;              // Range of the sort key; bodies outside are left out
+    float maxValue = std::numeric_limits<float>::infinity();
+    bool inRegion = false;              // Only bodies inside [regionMin, regionMax]
+    glm::vec2 regionMin{0.0f};
+    glm::vec2 regionMax{0.0f};
+    size_t limit = 100000;              // Rows kept, best first
+
+    bool operator==(const BodyTableQuery& other) const {
+        return key == other.key && descending == other.descending && minValue == other.minValue &&
+               maxValue == other.maxValue && inRegion == other.inRegion && regionMin == other.regionMin &&
+               regionMax == other.regionMax && limit == other.limit;
+    }
+    bool operator!=(const BodyTableQuery& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Sorted rows of the body table
+ */
+struct BodyTableRows {
+    std::vector<uint32_t> indices;      // Body indices in table order, at most query.limit
+    size_t matched = 0;                 // Bodies that passed the filter
+    size_t total = 0;                   // Bodies when the query was taken
+    uint64_t step = 0;                  // Simulation step the keys were taken at
+    double elapsedMs = 0.0;
+};
+
+/**
+ * @brief Sorts and filters the bodies for the body table in the background
+ *
+ * Request() takes one float key per body in a parallel pass, with filtered
+ * bodies marked NaN. That is the only work done on the calling thread: the
+ * worker can't read bodies the simulation is moving, and one key per body is
+ * smaller than any copy of the state it could filter from instead. A
+ * worker thread then gathers the remaining indices and keeps the best
+ * query.limit of them. Every thread partially sorts its own chunk, and the
+ * per-chunk winners are merged with one more partial sort. The full body list
+ * is never sorted, and the table only ever reads the rows on screen.
+ *
+ * A new request aborts the one in progress.
+ */
+class BodyTableSorter {
+public:
+    BodyTableSorter() = default;
+
+    BodyTableSorter(const BodyTableSorter&) = delete;
+    BodyTableSorter& operator=(const BodyTableSorter&) = delete;
+
+    /**
+     * @brief Start sorting the bodies as they are now
+     */
+    void Request(const std::vector<std::unique_ptr<Body>>& bodies, const BodyTableQuery& query, uint64_t step);
+
+    /**
+     * @brief Move the rows out if they changed since the last call
+     */
+    bool FetchRows(BodyTableRows& rows);
+
+    /**
+     * @brief Value of the sort key for one body
+     */
+    static float GetKey(const Body& body, size_t index, BodyTableKey key);
+
+private:
+    struct Job {
+        std::vector<float> keys;        // NaN for filtered bodies
+        BodyTableQuery query;
+        uint64_t step = 0;
+    };
+
+    void Sort(const Job& job, uint64_t generation);
+
+    // Rows are guarded by m_mutex
+    BodyTableRows m_rows;
+    bool m_hasRows = false;
+    std::mutex m_mutex;
+
+    // Last, so the thread stops before the members above go away
+    LatestOnlyWorker<Job> m_worker{[this](Job& job, uint64_t generation) { Sort(job, generation); }};
+
+    static constexpr size_t PARALLEL_THRESHOLD = 65536; // Fewer candidates are sorted on one thread
+};
+
+} // namespace nbody
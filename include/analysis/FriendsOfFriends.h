@@ -0,0 +1,168 @@
+#pragma once
+
+#include "core/IncrementalJob.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace nbody {
+
+class Body;
+
+/**
+ * @brief Configuration for the friends-of-friends group finder
+ */
+struct FoFConfig {
+    float linkingLength = 5.0f;         // Bodies closer than this are friends
+    int minMembers = 5;                 // Smaller groups are reported as ungrouped
+};
+
+/**
+ * @brief One group found by the friends-of-friends finder
+ */
+struct FoFGroup {
+    int memberCount = 0;
+    float mass = 0.0f;
+    glm::vec2 centerOfMass{0.0f};
+    glm::vec2 velocity{0.0f};           // Mass-weighted mean velocity
+};
+
+/**
+ * @brief Output of a friends-of-friends pass
+ */
+struct FoFResult {
+    std::vector<int> groupIds;          // Per body, -1 if not in a group of minMembers or more
+    std::vector<FoFGroup> groups;       // Sorted by mass, heaviest first; index = group ID
+    int ungroupedCount = 0;
+    double elapsedMs = 0.0;             // Work time, not counting frames in between
+};
+
+/**
+ * @brief Parallel friends-of-friends group finder
+ *
+ * Begin() copies positions, velocities and masses, and every later stage works
+ * on that copy only, so a pass can be spread over many frames while the
+ * simulation moves on. Neighbours are found through a spatial hash with cells
+ * of at least the linking length, built with a counting sort. Every body
+ * checks the 3x3 cells around its own and joins the sets of closer bodies in a
+ * concurrent union-find. Roots are always the smallest index of their set and
+ * links are made with a single compare-and-swap on a root, so threads never
+ * lock; FindRoot() halves paths with the same CAS, which can only shorten a
+ * path to the same root.
+ *
+ * As an IncrementalJob, Advance() works through the stages in chunks of
+ * bounded size and returns at the deadline, keeping its place; Find() runs a
+ * whole pass at once.
+ */
+class FriendsOfFriends : public IncrementalJob {
+public:
+    explicit FriendsOfFriends(const FoFConfig& config = FoFConfig()) : m_config(config) {}
+
+    const char* GetName() const override { return "Group finder"; }
+
+    /**
+     * @brief Find the groups among bodies
+     */
+    void Find(const std::vector<std::unique_ptr<Body>>& bodies, FoFResult& result);
+
+    /**
+     * @brief Start a pass over a snapshot of the bodies, dropping one in progress
+     */
+    void Begin(const std::vector<std::unique_ptr<Body>>& bodies) override;
+
+    /**
+     * @brief Continue the pass until the deadline
+     *
+     * Always does at least one chunk, even if the deadline has passed.
+     * @return True once the result is ready
+     */
+    bool Advance(std::chrono::steady_clock::time_point deadline) override;
+
+    /**
+     * @brief Fraction of the current pass done, 0 to 1
+     */
+    float GetProgress() const override;
+
+    /**
+     * @brief Move the result of a finished pass out
+     */
+    void TakeResult(FoFResult& result);
+
+    const FoFConfig& GetConfig() const { return m_config; }
+    void SetConfig(const FoFConfig& config) { m_config = config; }
+
+    /**
+     * @brief Distinct display color for a group ID
+     */
+    static glm::vec3 GetGroupColor(int groupId);
+
+private:
+    enum class Stage {
+        Count,                          // Bodies per hash bucket
+        Offsets,                        // Prefix sum over the buckets
+        Scatter,                        // Bodies sorted by bucket
+        Link,                           // Union-find over the neighbour pairs
+        Roots,                          // Final root and set size of every body
+        Accumulate,                     // Mass, center and velocity of the groups
+        Label,                          // Group IDs by mass
+        Done
+    };
+
+    struct Accumulator {
+        int members = 0;
+        double mass = 0.0;
+        glm::dvec2 position{0.0};
+        glm::dvec2 momentum{0.0};
+    };
+
+    void AdvanceStage();
+    void NextStage(Stage stage, size_t size);
+    void SortGroups();
+    uint32_t FindRoot(uint32_t index);
+    void Unite(uint32_t a, uint32_t b);
+    glm::ivec2 GetCell(const glm::vec2& position) const;
+    uint32_t GetBucket(glm::ivec2 cell) const;
+
+    FoFConfig m_config;
+
+    // Snapshot taken by Begin()
+    std::vector<glm::vec2> m_positions;
+    std::vector<glm::vec2> m_velocities;
+    std::vector<float> m_masses;
+    float m_linkingLength = 0.0f;
+    int m_minMembers = 1;
+
+    // Spatial hash: bodies of bucket b are m_sorted[m_offsets[b]] to m_sorted[m_offsets[b + 1]]
+    glm::vec2 m_origin{0.0f};
+    float m_cellSize = 1.0f;
+    uint32_t m_bucketMask = 0;
+    std::vector<uint32_t> m_bucketOf;
+    std::vector<uint32_t> m_offsets;
+    std::vector<uint32_t> m_fill;
+    std::vector<uint32_t> m_sorted;
+
+    std::unique_ptr<std::atomic<uint32_t>[]> m_parent;
+    size_t m_parentCapacity = 0;
+    std::vector<uint32_t> m_roots;
+    std::vector<int> m_memberCount;
+    std::vector<int> m_slotOfRoot;
+    std::vector<Accumulator> m_accumulators;
+    std::vector<int> m_groupOfSlot;
+
+    Stage m_stage = Stage::Done;
+    size_t m_cursor = 0;                // Next item of the current stage
+    size_t m_stageSize = 0;
+    FoFResult m_result;
+    double m_workMs = 0.0;              // Time spent in Begin() and Advance() this pass
+
+    static constexpr size_t CHUNK_SIZE = 65536;          // Bodies or buckets per step of a stage
+    size_t m_linkChunkSize = 4096;      // Bodies per step of the Link stage, tuned to LINK_CHUNK_MS
+
+    static constexpr double LINK_CHUNK_MS = 0.5;         // Linking cost varies with density
+    static constexpr size_t MIN_LINK_CHUNK_SIZE = 256;
+};
+
+} // namespace nbody
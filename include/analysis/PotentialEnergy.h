@@ -0,0 +1,52 @@
+#pragma once
+
+#include "core/IncrementalJob.h"
+#include "physics/PhysicsEngine.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace nbody {
+
+/**
+ * @brief Total energy of a snapshot, with the O(N²) potential summed a few rows at a time
+ *
+ * Begin() copies positions and masses and takes the kinetic energy and
+ * momenta of the same instant, so the total stays consistent even when a run
+ * covers many frames. Each Advance() chunk sums about PAIRS_PER_CHUNK pairs.
+ */
+class PotentialEnergyJob : public IncrementalJob {
+public:
+    explicit PotentialEnergyJob(const PhysicsEngine& physics) : m_physics(physics) {}
+
+    const char* GetName() const override { return "Energy"; }
+    void Begin(const std::vector<std::unique_ptr<Body>>& bodies) override;
+    bool Advance(std::chrono::steady_clock::time_point deadline) override;
+    float GetProgress() const override;
+
+    /**
+     * @brief Energy of the last finished run
+     */
+    const EnergyStats& GetStats() const { return m_stats; }
+    uint64_t GetStep() const { return m_step; }
+    double GetSimulationTime() const { return m_time; }
+
+private:
+    const PhysicsEngine& m_physics;
+
+    // Current run
+    std::vector<glm::vec2> m_positions;
+    std::vector<float> m_masses;
+    EnergyStats m_running;
+    uint64_t m_runningStep = 0;
+    double m_runningTime = 0.0;
+    size_t m_nextRow = 0;
+    double m_pairsDone = 0.0;
+
+    EnergyStats m_stats;
+    uint64_t m_step = 0;
+    double m_time = 0.0;
+
+    static constexpr double PAIRS_PER_CHUNK = 1 << 17;
+};
+
+} // namespace nbody
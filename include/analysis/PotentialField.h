@@ -0,0 +1,129 @@
+#pragma once
+
+#include "core/LatestOnlyWorker.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace nbody {
+
+class Body;
+class BarnesHutTree;
+struct QuadTreeNode;
+
+/**
+ * @brief Configuration for the potential field overlay
+ */
+struct PotentialFieldConfig {
+    int baseCells = 32;                 // Coarse cells across the view width
+    int maxRefinement = 3;              // Times a cell can be split in four
+    int contourLevels = 16;
+    float theta = 0.7f;                 // Opening angle of the tree walk
+};
+
+/**
+ * @brief Contour lines of the potential over a region
+ */
+struct PotentialContours {
+    std::vector<glm::vec2> segments;    // Line segment endpoints in world space, two per segment
+    std::vector<uint32_t> levelOffsets; // Segments of level i are [levelOffsets[i], levelOffsets[i + 1]) vertices
+    int refinementLevel = 0;            // Refinement passes done so far
+    size_t samples = 0;                 // Potential evaluations so far
+};
+
+/**
+ * @brief Samples the gravitational potential on an adaptive grid in the background
+ *
+ * Request() copies the top of the current Barnes-Hut tree into a flat node
+ * array, cut off where nodes get smaller than the finest grid spacing.
+ * Without a tree, the bodies are summed directly, or binned on a coarse grid
+ * when there are many. A worker thread evaluates the potential from that
+ * copy at the corners of a coarse grid. It then keeps splitting only the cells across which the
+ * potential changes by more than half a contour spacing, or whose centre
+ * departs from the bilinear estimate by as much. Everything between samples
+ * is interpolated.
+ *
+ * Contours are taken in log(-potential), so deep wells don't crowd out the
+ * rest. They are published after the coarse pass and after every refinement
+ * pass, so the overlay sharpens over a few frames. Like the orbit predictor,
+ * a new request aborts the one in progress.
+ */
+class PotentialFieldSampler {
+public:
+    explicit PotentialFieldSampler(const PotentialFieldConfig& config = PotentialFieldConfig()) : m_config(config) {}
+
+    PotentialFieldSampler(const PotentialFieldSampler&) = delete;
+    PotentialFieldSampler& operator=(const PotentialFieldSampler&) = delete;
+
+    /**
+     * @brief Start sampling the region [minimum, maximum]
+     * @param tree Tree of the last force pass, or null to sum the bodies (binned on a grid if there are many)
+     */
+    void Request(const BarnesHutTree* tree, const std::vector<std::unique_ptr<Body>>& bodies,
+                 const glm::vec2& minimum, const glm::vec2& maximum, float G, float softeningLength);
+
+    /**
+     * @brief Copy the contours if they changed since the last call
+     */
+    bool FetchContours(PotentialContours& contours);
+
+    void SetConfig(const PotentialFieldConfig& config) { m_config = config; }
+    const PotentialFieldConfig& GetConfig() const { return m_config; }
+    double GetLastDurationMs() const { return m_lastDurationMs.load(); }
+
+private:
+    struct Node {
+        glm::vec2 centerOfMass{0.0f};
+        float size = 0.0f;              // 0 for single bodies
+        float mass = 0.0f;
+        float softeningSq = 0.0f;
+        int firstChild = -1;            // Four consecutive children, -1 for leaves
+    };
+
+    struct Cell {
+        int x;                          // Lower-left fine grid sample
+        int y;
+        int size;                       // In fine grid samples
+    };
+
+    struct Job {
+        std::vector<Node> nodes;
+        std::vector<int> roots;
+        glm::dvec2 minimum{0.0};
+        glm::dvec2 maximum{0.0};
+        double G = 1.0;
+        PotentialFieldConfig config;
+    };
+
+    void FlattenTree(const QuadTreeNode* root, float minSize, float softeningSq, std::vector<Node>& nodes) const;
+    void BinBodies(const std::vector<std::unique_ptr<Body>>& bodies, float softeningSq,
+                   std::vector<Node>& nodes) const;
+    void Run(const Job& job, uint64_t generation);
+    void Sample(const Job& job, uint64_t generation);
+    double Evaluate(const Job& job, const glm::dvec2& point, std::vector<int>& stack) const;
+    void Contour(const std::vector<double>& values, int width, int height, const glm::dvec2& minimum,
+                 const glm::dvec2& spacing, double lowest, double levelSpacing, int levels,
+                 PotentialContours& contours) const;
+    bool Publish(PotentialContours& contours, uint64_t generation);
+
+    PotentialFieldConfig m_config;
+
+    // Contours are guarded by m_mutex
+    PotentialContours m_contours;
+    uint64_t m_contoursVersion = 0;
+    uint64_t m_fetchedVersion = 0;
+    std::atomic<double> m_lastDurationMs{0.0};
+    std::mutex m_mutex;
+
+    // Last, so the thread stops before the members above go away
+    LatestOnlyWorker<Job> m_worker{[this](Job& job, uint64_t generation) { Run(job, generation); }};
+
+    static constexpr size_t MAX_NODES = 262144;     // Cap on the flattened tree
+    static constexpr size_t MAX_DIRECT_SOURCES = 4096; // Without a tree, more bodies than this are binned
+    static constexpr int BIN_CELLS = 64;            // Grid cells per axis when binning
+};
+
+} // namespace nbody
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "analysis/AnalysisModule.h"
+#include <vector>
+
+namespace nbody {
+
+/**
+ * @brief Surface density and mean radial/tangential velocity in logarithmic radial shells
+ */
+class RadialProfileAnalysis : public AnalysisModule {
+public:
+    explicit RadialProfileAnalysis(int binCount = 24) : m_binCount(binCount) {}
+    const char* GetName() const override { return "radial_profile"; }
+    void Analyze(const AnalysisContext& context, AnalysisResult& result) override;
+
+private:
+    int m_binCount;
+};
+
+/**
+ * @brief Radii enclosing fixed fractions of the total mass
+ */
+class LagrangianRadiiAnalysis : public AnalysisModule {
+public:
+    LagrangianRadiiAnalysis() : m_fractions{0.01, 0.1, 0.25, 0.5, 0.75, 0.9} {}
+    const char* GetName() const override { return "lagrangian_radii"; }
+    void Analyze(const AnalysisContext& context, AnalysisResult& result) override;
+
+private:
+    std::vector<double> m_fractions;
+};
+
+/**
+ * @brief Mass-weighted velocity dispersion, total and split into radial and tangential parts
+ */
+class VelocityDispersionAnalysis : public AnalysisModule {
+public:
+    const char* GetName() const override { return "velocity_dispersion"; }
+    void Analyze(const AnalysisContext& context, AnalysisResult& result) override;
+};
+
+/**
+ * @brief Total angular momentum about the center of mass and the distribution of specific angular momentum
+ */
+class AngularMomentumAnalysis : public AnalysisModule {
+public:
+    explicit AngularMomentumAnalysis(int binCount = 32) : m_binCount(binCount) {}
+    const char* GetName() const override { return "angular_momentum"; }
+    void Analyze(const AnalysisContext& context, AnalysisResult& result) override;
+
+private:
+    int m_binCount;
+};
+
+} // namespace nbody
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace nbody {
+
+/**
+ * @brief Small fixed-size thread pool for background analysis
+ *
+ * Kept separate from the OpenMP team used by the physics step so analysis
+ * work never occupies the threads a step is waiting for. Run() may only be
+ * called from outside the pool.
+ */
+class WorkerPool {
+public:
+    /**
+     * @param threadCount Number of workers, 0 picks one less than the hardware threads
+     */
+    explicit WorkerPool(int threadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief Run all tasks on the workers and wait for them to finish
+     */
+    void Run(std::vector<std::function<void()>>& tasks);
+
+    /**
+     * @brief Split [0, count) into one chunk per worker and run func(begin, end) on each
+     */
+    void ParallelFor(size_t count, const std::function<void(size_t, size_t)>& func);
+
+    int GetThreadCount() const { return static_cast<int>(m_threads.size()); }
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_threads;
+    std::deque<std::function<void()>> m_queue;
+    size_t m_unfinished = 0;
+    bool m_stopRequested = false;
+
+    std::mutex m_mutex;
+    std::condition_variable m_taskAvailable;
+    std::condition_variable m_tasksDone;
+};
+
+} // namespace nbody
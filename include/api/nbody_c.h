@@ -0,0 +1,127 @@
+#ifndef NBODY_C_H
+#define NBODY_C_H
+
+/*
+ * C ABI for the N-body physics core (libnbody).
+ *
+ * Stable, exception-free interface for driving the physics engine from C,
+ * Python (ctypes/cffi), Julia (ccall) and similar. All functions return
+ * NBODY_OK (0) or a negative error code unless documented otherwise; the
+ * message for the last error on an engine is available via nbody_last_error().
+ *
+ * Arrays are flat float buffers: positions and velocities are interleaved
+ * x, y pairs (2 * count floats), masses and densities are count floats.
+ *
+ * An engine may be used from one thread at a time; separate engines are
+ * independent.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #if defined(NBODY_BUILD_SHARED)
+        #define NBODY_API __declspec(dllexport)
+    #else
+        #define NBODY_API __declspec(dllimport)
+    #endif
+#else
+    #define NBODY_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NBODY_API_VERSION 1
+
+/* Error codes */
+#define NBODY_OK 0
+#define NBODY_ERROR_INVALID_ARGUMENT -1
+#define NBODY_ERROR_BUFFER_TOO_SMALL -2
+#define NBODY_ERROR_UNKNOWN_OPTION -3
+#define NBODY_ERROR_INTERNAL -4
+
+typedef struct nbody_engine nbody_engine;
+
+/* Physics configuration; always initialise with nbody_default_config() */
+typedef struct nbody_config {
+    uint32_t struct_size;           /* sizeof(nbody_config), set by nbody_default_config() */
+    float gravitational_constant;
+    float time_step;
+    float time_scale;
+    float softening_length;
+    float damping_factor;
+    int32_t use_barnes_hut;
+    float barnes_hut_theta;
+    int32_t enable_collisions;
+    float restitution;
+    int32_t adaptive_time_step;
+    int32_t regularize_close_encounters;
+    int32_t use_wisdom_holman;
+} nbody_config;
+
+typedef struct nbody_stats {
+    uint32_t struct_size;           /* sizeof(nbody_stats), set by the caller */
+    uint64_t step;                  /* Physics steps taken since the engine was created or reset */
+    double time;                    /* Simulated time */
+    double total_ms;                /* Timings of the last physics step */
+    double force_ms;
+    double integration_ms;
+    double collision_ms;
+    int32_t body_count;
+    int32_t force_calculations;
+    int32_t collisions;
+    double kinetic_energy;          /* Only filled by nbody_get_stats_with_energy() */
+    double potential_energy;
+} nbody_stats;
+
+/* Library */
+NBODY_API int nbody_api_version(void);
+
+/* Lifetime */
+NBODY_API nbody_engine* nbody_create(void);
+NBODY_API void nbody_destroy(nbody_engine* engine);
+NBODY_API const char* nbody_last_error(const nbody_engine* engine);
+
+/* Configuration */
+NBODY_API void nbody_default_config(nbody_config* config);
+NBODY_API int nbody_get_config(const nbody_engine* engine, nbody_config* config);
+NBODY_API int nbody_set_config(nbody_engine* engine, const nbody_config* config);
+/* Set one option by its configuration file key, e.g. ("physics.barnesHutTheta", "0.5") */
+NBODY_API int nbody_set_option(nbody_engine* engine, const char* key, const char* value);
+
+/* Bulk state; densities may be NULL (default density) */
+NBODY_API int nbody_set_bodies(nbody_engine* engine, size_t count,
+                               const float* positions, const float* velocities,
+                               const float* masses, const float* densities);
+NBODY_API int nbody_set_velocities(nbody_engine* engine, size_t count, const float* velocities);
+NBODY_API size_t nbody_get_body_count(const nbody_engine* engine);
+/* capacity is in bodies; returns NBODY_ERROR_BUFFER_TOO_SMALL if it is below the body count */
+NBODY_API int nbody_get_positions(const nbody_engine* engine, float* positions, size_t capacity);
+NBODY_API int nbody_get_velocities(const nbody_engine* engine, float* velocities, size_t capacity);
+NBODY_API int nbody_get_masses(const nbody_engine* engine, float* masses, size_t capacity);
+
+/*
+ * Snapshot views: read-only pointers into a contiguous copy of the state,
+ * refreshed on the first view call after the state changes. A pointer is
+ * only valid until the next call that modifies the engine (step, set_*),
+ * after which it must be fetched again; NULL if the engine has no bodies.
+ */
+NBODY_API const float* nbody_positions_view(nbody_engine* engine);
+NBODY_API const float* nbody_velocities_view(nbody_engine* engine);
+NBODY_API const float* nbody_masses_view(nbody_engine* engine);
+
+/* Advance steps physics steps of delta_time each (before time scale) without returning to the caller */
+NBODY_API int nbody_step(nbody_engine* engine, int steps, float delta_time);
+NBODY_API int nbody_reset_clock(nbody_engine* engine);
+
+/* Statistics */
+NBODY_API int nbody_get_stats(const nbody_engine* engine, nbody_stats* stats);
+NBODY_API int nbody_get_stats_with_energy(const nbody_engine* engine, nbody_stats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NBODY_C_H */
@@ -13,8 +13,23 @@ namespace nbody {
 // Forward declarations
 class Body;
 class PhysicsEngine;
+class BarnesHutTree;
 class Renderer;
 class UIManager;
+class RewindBuffer;
+class CheckpointManager;
+class SharedStatePublisher;
+class PresetCache;
+class AnalysisPipeline;
+class FriendsOfFriends;
+class OrbitPredictor;
+class PotentialFieldSampler;
+class BodyTableSorter;
+class JobScheduler;
+class PotentialEnergyJob;
+struct FoFResult;
+struct PresetKey;
+struct BodyTableQuery;
 
 /**
  * @brief Main application class that manages the N-body simulation
@@ -45,17 +60,54 @@ private:
     std::unique_ptr<PhysicsEngine> m_physics;
     std::unique_ptr<Renderer> m_renderer;
     std::unique_ptr<UIManager> m_ui;
+    std::unique_ptr<RewindBuffer> m_rewind;
+    std::unique_ptr<CheckpointManager> m_checkpoints;
+    std::unique_ptr<JobScheduler> m_jobs;     // Periodic work spread over frames
+    std::unique_ptr<PotentialEnergyJob> m_energyJob;
+    std::unique_ptr<SharedStatePublisher> m_sharedState; // Only while publishing is enabled
+    std::unique_ptr<AnalysisPipeline> m_analysis; // Only while in-situ analysis is enabled
+    std::unique_ptr<FriendsOfFriends> m_groupFinder; // Only while the group finder is enabled
+    std::unique_ptr<FoFResult> m_groups;
+    int m_groupFinderInterval = 10;
+    bool m_colorByGroup = true;
+    std::unique_ptr<OrbitPredictor> m_orbitPredictor; // Only while the predicted orbit overlay is enabled
+    std::unique_ptr<PotentialFieldSampler> m_fieldSampler; // Only while the potential field overlay is enabled
+    std::unique_ptr<BodyTableSorter> m_bodyTable; // Only while the body table window is open
+    std::unique_ptr<BodyTableQuery> m_bodyTableQuery;
+    std::unique_ptr<PresetCache> m_presetCache;
+    uint64_t m_presetCacheBytes = 0;
 
     // Simulation state
     std::vector<std::unique_ptr<Body>> m_bodies;
+    uint64_t m_bodiesGeneration = 1;   // Bumped whenever the bodies move or are edited
+    uint64_t m_forceTreeGeneration = 0; // m_bodiesGeneration right after the last step
+    size_t m_trackedBodyCount = 0;
     bool m_running = false;
     bool m_paused = false;
     
+    // Rewind state
+    int64_t m_rewindFrame = -1;        // Id of the restored frame, -1 while following the live simulation
+    bool m_rewindBranchPending = false; // Truncate newer history when the simulation resumes
+    
     // Timing
     std::chrono::high_resolution_clock::time_point m_lastFrameTime;
     float m_deltaTime = 0.0f;
     float m_fps = 0.0f;
     
+    // Fast forward: physics steps back to back, rendering drops to FAST_FORWARD_FPS
+    bool m_fastForward = false;
+    std::chrono::high_resolution_clock::time_point m_nextFastForwardFrame;
+    
+    // Simulated time and steps per wall-clock second, measured over RATE_WINDOW_SECONDS
+    std::chrono::high_resolution_clock::time_point m_rateWindowStart;
+    double m_rateWindowSimulationTime = 0.0;
+    uint64_t m_rateWindowSteps = 0;
+    double m_simulationRate = 0.0;
+    double m_stepsPerSecond = 0.0;
+    
+    // Trails are sampled by simulated time, so they look the same at any speed
+    double m_lastTrailSample = 0.0;
+    
     // Input state
     glm::vec2 m_mousePosition{0.0f};
     glm::vec2 m_worldMousePosition{0.0f};
@@ -64,6 +116,30 @@ private:
     Body* m_selectedBody = nullptr;
     Body* m_draggedBody = nullptr;
     
+    // Predicted orbit of the selected body
+    float m_predictionHorizon = 20.0f;
+    const Body* m_predictedBody = nullptr;  // Body the current prediction was requested for
+    size_t m_predictedIndex = 0;
+    glm::vec2 m_predictedFrom{0.0f};
+    uint64_t m_predictedGeneration = 0;
+    size_t m_predictedPoints = 0;
+    std::chrono::steady_clock::time_point m_lastPrediction;
+    
+    // Potential field overlay, re-sampled when the view or the simulation moves on
+    glm::vec2 m_fieldMin{0.0f};
+    glm::vec2 m_fieldMax{0.0f};
+    uint64_t m_fieldGeneration = 0;
+    bool m_fieldRequested = false;
+    int m_fieldRefinement = 0;
+    size_t m_fieldSamples = 0;
+    std::chrono::steady_clock::time_point m_lastFieldRequest;
+    
+    // Body table, re-sorted when the query changes or now and then while running
+    bool m_bodyTableDirty = false;
+    uint64_t m_bodyTableGeneration = 0;
+    double m_bodyTableRequestSeconds = 0.0; // Main-thread cost of the last request
+    std::chrono::steady_clock::time_point m_lastBodyTableRequest;
+    
     // Camera state
     glm::vec2 m_cameraPosition{0.0f};
     float m_cameraZoom = 1.0f;
@@ -78,7 +154,17 @@ private:
     void Render();
     void HandleInput();
     void UpdatePhysics(float deltaTime);
+    bool AdvanceFastForward(GLFWwindow* window);
+    void SampleTrails();
+    void UpdateSimulationRate();
+    void MarkBodiesChanged();
+    bool IsIdle() const;
     void UpdateUI();
+    void ApplyGroups();
+    const BarnesHutTree* CurrentForceTree() const;
+    void UpdateOrbitPrediction();
+    void UpdateFieldOverlay();
+    void UpdateBodyTable();
     
     // Event handlers
     void OnMouseMove(double x, double y);
@@ -93,6 +179,9 @@ private:
                  float density, const glm::vec3& color);
     void RemoveBody(Body* body);
     void ClearBodies();
+    void RestoreRewindFrame(int frameIndex);
+    void ResetHistory();
+    void RestoreLatestCheckpoint();
     Body* FindBodyAtPosition(const glm::vec2& position);
     
     // Coordinate conversion
@@ -108,7 +197,37 @@ private:
     void CreateTripleStarSystem();
     void CreateFigureEight();
     void CreateCollisionCourse();
-    void SpawnBodies(int count, int pattern);
+    void SpawnBodies(int count, int pattern, uint32_t seed);
+    bool LoadCachedBodies(const PresetKey& key);
+    void StoreCachedBodies(const PresetKey& key, size_t firstBody);
+    
+    // Seed of the randomized presets, so reloading a preset gives the same (cacheable) bodies
+    static constexpr uint32_t PRESET_SEED = 1;
+    
+    // Fast forward steps with the time step of a 60 FPS frame and redraws at FAST_FORWARD_FPS
+    static constexpr float FAST_FORWARD_STEP = 1.0f / 60.0f;
+    static constexpr double FAST_FORWARD_FPS = 10.0;
+    static constexpr double MINIMIZED_BATCH_SECONDS = 0.1; // Stepping between event polls while minimized
+    static constexpr double RATE_WINDOW_SECONDS = 0.5;
+    
+    // Longest wait for input while nothing changes by itself (paused, no jobs running)
+    static constexpr double IDLE_FRAME_SECONDS = 0.1;
+    
+    // Simulated seconds between trail points, per unit of time scale (every 5th frame at 60 FPS)
+    static constexpr double TRAIL_SAMPLE_INTERVAL = 5.0 / 60.0;
+    
+    // Seconds between predicted orbit refreshes while the simulation runs
+    static constexpr double PREDICTION_REFRESH_SECONDS = 0.25;
+    
+    // Seconds between potential field refreshes while the simulation runs, and
+    // the fraction of the view it may pan or zoom before being re-sampled at once
+    static constexpr double FIELD_REFRESH_SECONDS = 0.5;
+    static constexpr float FIELD_VIEW_TOLERANCE = 0.1f;
+    
+    // Seconds between body table refreshes while the simulation runs, stretched
+    // so that taking the sort keys never costs more than 1/BODY_TABLE_COST_RATIO of the time
+    static constexpr double BODY_TABLE_REFRESH_SECONDS = 1.0;
+    static constexpr double BODY_TABLE_COST_RATIO = 50.0;
     
     // Configuration save/load
     void SaveConfiguration(const std::string& filename);
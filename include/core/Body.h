@@ -31,6 +31,7 @@ public:
     const glm::vec2& GetForce() const { return m_force; }
     float GetMass() const { return m_mass; }
     float GetRadius() const { return m_radius; }
+    float GetDensity() const { return m_density; }
     const glm::vec3& GetColor() const { return m_color; }
     const CircularTrail& GetTrail() const { return m_trail; }
     
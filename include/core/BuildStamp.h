@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+namespace nbody {
+
+/**
+ * @brief Input generations a derived product was last built from
+ *
+ * Inputs such as the bodies, the camera or the display settings carry a
+ * counter that is bumped whenever they change. A derived product (vertex
+ * buffers, overlays, diagnostics) keeps a stamp and is only rebuilt when
+ * Refresh() reports that one of its inputs moved on since the last build.
+ */
+class BuildStamp {
+public:
+    /**
+     * @brief Record the current generations of the inputs
+     * @return True if they differ from the recorded ones, i.e. the product is stale
+     */
+    bool Refresh(uint64_t first, uint64_t second = 0, uint64_t third = 0) {
+        if (m_valid && first == m_first && second == m_second && third == m_third) return false;
+        m_first = first;
+        m_second = second;
+        m_third = third;
+        m_valid = true;
+        return true;
+    }
+
+    /**
+     * @brief Force a rebuild on the next Refresh(), e.g. after losing the built data
+     */
+    void Invalidate() { m_valid = false; }
+
+private:
+    uint64_t m_first = 0;
+    uint64_t m_second = 0;
+    uint64_t m_third = 0;
+    bool m_valid = false;
+};
+
+} // namespace nbody
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "core/SimulationSnapshot.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+
+namespace nbody {
+
+class Body;
+
+/**
+ * @brief Configuration for simulation checkpoints
+ */
+struct CheckpointConfig {
+    std::string directory = "checkpoints";
+    double minIntervalSeconds = 5.0;    // Rate limit between checkpoint starts
+    double autoIntervalSeconds = 0.0;   // Automatic checkpoint period, 0 = manual only
+    int keepCount = 3;                  // Completed checkpoint files kept on disk
+    bool useFork = true;                // Write from a forked child (POSIX only)
+};
+
+/**
+ * @brief Progress of the most recent checkpoint
+ */
+struct CheckpointStatus {
+    enum State { Idle, Writing, Succeeded, Failed };
+
+    State state = Idle;
+    uint64_t step = 0;
+    std::string filename;
+    double pauseMs = 0.0;               // Time the simulation thread was blocked
+    double durationMs = 0.0;            // Start to completion, including the background write
+    int completed = 0;
+    int failed = 0;
+};
+
+/**
+ * @brief Writes binary checkpoints of the simulation without stalling it
+ *
+ * On POSIX systems the simulation process fork()s at a step boundary and the
+ * child serializes its copy-on-write image of the bodies, so the simulation
+ * thread only pays for the fork itself. The child never allocates, never
+ * enters OpenMP and never touches threads it did not inherit (the rewind
+ * encoder, the OpenMP pool), it only walks the body array with raw write()
+ * calls and leaves with _exit(). Completion is picked up by Poll() with
+ * waitpid(WNOHANG). Where fork() is unavailable the checkpoint is written
+ * synchronously.
+ */
+class CheckpointManager {
+public:
+    explicit CheckpointManager(const CheckpointConfig& config = CheckpointConfig());
+    ~CheckpointManager();
+
+    /**
+     * @brief Start a checkpoint of the current state
+     * @param bodies Bodies to write; must not be modified until this call returns
+     * @param step Physics step of the state
+     * @param time Simulated time of the state
+     * @param force Ignore the rate limit (an in-flight checkpoint still blocks a new one)
+     * @return True if a checkpoint was started
+     */
+    bool Request(const std::vector<std::unique_ptr<Body>>& bodies, uint64_t step, double time, bool force = false);
+
+    /**
+     * @brief Start an automatic checkpoint if the auto interval has elapsed
+     */
+    void Update(const std::vector<std::unique_ptr<Body>>& bodies, uint64_t step, double time);
+
+    /**
+     * @brief Reap a finished checkpoint writer without blocking
+     */
+    void Poll();
+
+    /**
+     * @brief Block until an in-flight checkpoint has finished
+     */
+    void Wait();
+
+    bool IsWriting() const { return m_status.state == CheckpointStatus::Writing; }
+    const CheckpointStatus& GetStatus() const { return m_status; }
+    const CheckpointConfig& GetConfig() const { return m_config; }
+    CheckpointConfig& GetMutableConfig() { return m_config; }
+
+    /**
+     * @brief Most recent successfully written checkpoint, empty if none
+     */
+    std::string GetLatestFile() const { return m_files.empty() ? std::string() : m_files.back(); }
+
+    /**
+     * @brief Read a checkpoint file
+     * @return False if the file is missing, truncated or not a checkpoint
+     */
+    static bool Load(const std::string& filename, SimulationSnapshot& snapshot);
+
+    /**
+     * @brief Write a checkpoint file synchronously
+     */
+    static bool Write(const std::string& filename, const std::vector<std::unique_ptr<Body>>& bodies,
+                      uint64_t step, double time);
+
+private:
+    void Finish(bool success);
+
+    CheckpointConfig m_config;
+    CheckpointStatus m_status;
+    std::deque<std::string> m_files;    // Completed checkpoints, oldest first
+    std::string m_tempFilename;
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point m_lastStart;
+    Clock::time_point m_writeStart;
+    bool m_hasStarted = false;
+
+    long m_childPid = -1;
+};
+
+} // namespace nbody
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <string>
+#include <map>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace nbody {
+
+class Body;
+struct PhysicsConfig;
+
+/**
+ * @brief Key=value configuration file shared by the application and headless tools
+ *
+ * Lines starting with '#' are comments. Keys use dotted names such as
+ * "physics.timeStep" or "body.3.mass".
+ */
+class ConfigFile {
+public:
+    /**
+     * @brief Parse a configuration file
+     * @param filename Path to the file
+     * @return True if the file could be opened
+     */
+    bool Load(const std::string& filename);
+
+    /**
+     * @brief Parse a single "key=value" line (comments and blank lines are ignored)
+     */
+    void ParseLine(const std::string& line);
+
+    // Value access; numeric getters throw std::invalid_argument naming the key if the value is malformed
+    bool Has(const std::string& key) const { return m_values.count(key) > 0; }
+    std::string GetString(const std::string& key, const std::string& defaultValue = "") const;
+    float GetFloat(const std::string& key, float defaultValue) const;
+    int GetInt(const std::string& key, int defaultValue) const;
+    bool GetBool(const std::string& key, bool defaultValue) const;
+    void Set(const std::string& key, const std::string& value) { m_values[key] = value; }
+
+    const std::map<std::string, std::string>& GetValues() const { return m_values; }
+
+    /**
+     * @brief Parse a whole value as a number
+     * @throws std::invalid_argument naming the key if the value is empty, has trailing characters or is out of range
+     */
+    static float ParseFloat(const std::string& key, const std::string& value);
+    static int ParseInt(const std::string& key, const std::string& value);
+    static uint32_t ParseUnsigned(const std::string& key, const std::string& value);
+
+    /**
+     * @brief Apply all "physics.*" keys to a physics configuration
+     */
+    void ApplyPhysicsConfig(PhysicsConfig& config) const;
+
+    /**
+     * @brief Apply a single "physics.*" key to a physics configuration
+     * @return False if the key is not a known physics parameter
+     * @throws std::invalid_argument if the value is malformed
+     */
+    static bool ApplyPhysicsValue(const std::string& key, const std::string& value, PhysicsConfig& config);
+
+    /**
+     * @brief Create bodies from "bodies.count" and "body.<i>.*" keys
+     * @param bodies Bodies are appended to this vector
+     */
+    void CreateBodies(std::vector<std::unique_ptr<Body>>& bodies) const;
+
+private:
+    std::map<std::string, std::string> m_values;
+};
+
+} // namespace nbody
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "physics/PhysicsEngine.h"
+#include "core/ConfigFile.h"
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+namespace nbody {
+
+/**
+ * @brief One variant of an ensemble run
+ */
+struct EnsembleMember {
+    int index = 0;
+    uint32_t seed = 0;
+    std::vector<std::pair<std::string, std::string>> overrides; // "physics.*" key/value pairs
+};
+
+/**
+ * @brief Outcome of one ensemble member
+ */
+struct EnsembleResult {
+    int index = 0;
+    uint32_t seed = 0;
+    int bodyCount = 0;
+    int steps = 0;
+    double simulationTime = 0.0;
+    double wallTime = 0.0;          // ms
+    double initialEnergy = 0.0;
+    double finalEnergy = 0.0;
+    double energyError = 0.0;       // |E - E0| / |E0|
+    glm::vec2 centerOfMass{0.0f};
+    std::string method;
+    std::string error;              // Non-empty if the member failed
+};
+
+/**
+ * @brief Aggregate statistics over all ensemble members
+ */
+struct EnsembleSummary {
+    int members = 0;
+    int failed = 0;
+    double wallTime = 0.0;          // ms for the whole ensemble
+    double meanEnergyError = 0.0;
+    double stdEnergyError = 0.0;
+    double minEnergyError = 0.0;
+    double maxEnergyError = 0.0;
+    double bodyStepsPerSecond = 0.0;
+};
+
+/**
+ * @brief Runs many independent simulations concurrently for parameter sweeps
+ *
+ * Each member owns its own PhysicsEngine and bodies and runs on a single core;
+ * nested OpenMP is disabled so the engines' internal parallel loops run serially
+ * and the ensemble scales with the number of members instead.
+ *
+ * Spec file keys (key=value, '#' comments):
+ *   base=<saved configuration>        Initial bodies and physics settings
+ *   steps=<n>                         Physics steps per member
+ *   replicas=<n>                      Seeds per parameter combination
+ *   seed=<n>                          Base seed
+ *   velocityJitter=<f>                Relative velocity perturbation per seed
+ *   threads=<n>                       Worker threads (default: all cores)
+ *   output=<file.csv>                 Per-member results
+ *   sweep.physics.<key>=a,b,c         Values combined as a cartesian product
+ *   member.<i>.physics.<key>=<value>  Override for a single member
+ */
+class EnsembleRunner {
+public:
+    /**
+     * @brief Load an ensemble specification
+     * @param filename Spec file
+     * @return True if the spec and its base configuration could be loaded; malformed values are reported
+     */
+    bool LoadSpec(const std::string& filename);
+
+    /**
+     * @brief Run all members and write the results
+     * @return Aggregate statistics
+     */
+    EnsembleSummary Run();
+
+    const std::vector<EnsembleMember>& GetMembers() const { return m_members; }
+    const std::vector<EnsembleResult>& GetResults() const { return m_results; }
+
+    /**
+     * @brief Entry point for the headless "--ensemble <spec>" mode
+     * @return Process exit code
+     */
+    static int RunFromCommandLine(const std::string& specFile);
+
+private:
+    bool ParseSpec(const std::string& filename);
+    EnsembleResult RunMember(const EnsembleMember& member) const;
+    void BuildMembers(const ConfigFile& spec);
+    bool WriteResults(const std::string& filename) const;
+    EnsembleSummary Summarize(double wallTime) const;
+
+    ConfigFile m_base;
+    std::string m_outputFile = "ensemble_results.csv";
+    int m_steps = 1000;
+    int m_threads = 0;
+    float m_velocityJitter = 0.0f;
+    PhysicsConfig m_baseConfig;
+
+    std::vector<EnsembleMember> m_members;
+    std::vector<EnsembleResult> m_results;
+};
+
+} // namespace nbody
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+
+namespace nbody {
+
+class Body;
+
+/**
+ * @brief Periodic work that is too expensive for one frame
+ *
+ * Begin() copies whatever the job needs from the bodies, and every later call
+ * works on that copy, so a run sees one consistent state however far the
+ * simulation moves on in between. Advance() then works until a deadline and
+ * keeps its place in member state, to be resumed on a later frame.
+ */
+class IncrementalJob {
+public:
+    virtual ~IncrementalJob() = default;
+
+    virtual const char* GetName() const = 0;
+
+    /**
+     * @brief Start a run on a snapshot of the bodies, dropping one in progress
+     */
+    virtual void Begin(const std::vector<std::unique_ptr<Body>>& bodies) = 0;
+
+    /**
+     * @brief Continue the run until the deadline
+     *
+     * Must do at least one unit of work even if the deadline has passed, so
+     * every run finishes however small the time slice.
+     * @return True once the run is complete
+     */
+    virtual bool Advance(std::chrono::steady_clock::time_point deadline) = 0;
+
+    /**
+     * @brief Fraction of the current run done, 0 to 1
+     */
+    virtual float GetProgress() const = 0;
+};
+
+/**
+ * @brief Progress of one scheduled job, for display
+ */
+struct JobStatus {
+    std::string name;
+    bool running = false;
+    float progress = 0.0f;
+    uint64_t step = 0;                  // Step the current or last run started at
+    uint64_t completed = 0;             // Runs finished
+    int lastFrames = 0;                 // Frames the last run was spread over
+    double lastWorkMs = 0.0;            // Time the last run spent working
+};
+
+/**
+ * @brief Runs incremental jobs a slice at a time on the main thread
+ *
+ * Update() is called once per frame. It starts the jobs that are due, then
+ * shares the frame's time slice between the running ones, taking turns at
+ * who goes first. A job finishing calls its completion callback from
+ * Update(), where results can go straight to the renderer and UI.
+ *
+ * Jobs are not owned; the caller keeps them alive until Remove().
+ */
+class JobScheduler {
+public:
+    explicit JobScheduler(double sliceMs = DEFAULT_SLICE_MS) : m_sliceMs(sliceMs) {}
+
+    /**
+     * @brief Schedule a job
+     * @param intervalSteps Steps between the starts of two runs; 0 runs only on Restart()
+     * @param onFinished Called after every completed run; must not add or remove jobs
+     */
+    void Add(IncrementalJob* job, uint64_t intervalSteps, std::function<void()> onFinished);
+    void Remove(IncrementalJob* job);
+    void SetInterval(IncrementalJob* job, uint64_t intervalSteps);
+
+    /**
+     * @brief Start a fresh run of the job on the next Update(), dropping the current one
+     */
+    void Restart(IncrementalJob* job);
+    void RestartAll();
+
+    /**
+     * @brief Start due jobs and advance the running ones within the time slice
+     *
+     * A job is only due once the bodies changed since its last start, as told
+     * by their generation, so nothing runs while the simulation is static.
+     * It is then due when its interval has passed, or at once if the change
+     * was not a step forward (edits, rewinds, resets).
+     */
+    void Update(const std::vector<std::unique_ptr<Body>>& bodies, uint64_t step, uint64_t generation);
+
+    /**
+     * @brief True while a run is in progress or about to start
+     */
+    bool IsBusy() const;
+
+    std::vector<JobStatus> GetStatus() const;
+
+    double GetSliceMs() const { return m_sliceMs; }
+    void SetSliceMs(double sliceMs) { m_sliceMs = sliceMs; }
+
+    static constexpr double DEFAULT_SLICE_MS = 2.0;
+
+private:
+    struct Entry {
+        IncrementalJob* job = nullptr;
+        uint64_t interval = 0;
+        std::function<void()> onFinished;
+        bool running = false;
+        bool started = false;           // At least one run was started
+        bool restartRequested = false;
+        uint64_t startStep = 0;
+        uint64_t startGeneration = 0;   // Generation of the bodies the last run started from
+        int frames = 0;                 // Of the current run
+        double workMs = 0.0;
+        JobStatus status;
+    };
+
+    Entry* Find(IncrementalJob* job);
+    bool IsDue(const Entry& entry, uint64_t step, uint64_t generation) const;
+
+    std::vector<Entry> m_entries;
+    size_t m_firstEntry = 0;            // Goes first in the next slice
+    double m_sliceMs;
+};
+
+} // namespace nbody
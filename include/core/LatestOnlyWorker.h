@@ -0,0 +1,112 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace nbody {
+
+/**
+ * @brief Worker thread that only ever runs the newest of the jobs handed to it
+ *
+ * Submit() never waits: a job replaces the one still pending, and every
+ * Submit() or Cancel() bumps a generation counter. The job in progress is
+ * handed its generation and polls IsCurrent() to give up once it has been
+ * superseded. Results are published by the owner under its own lock after
+ * the same check, so a stale job never overwrites a newer result.
+ *
+ * The owner should declare the worker as its last member, so the thread is
+ * joined before anything the job function touches is destroyed.
+ */
+template <typename Job>
+class LatestOnlyWorker {
+public:
+    using Function = std::function<void(Job& job, uint64_t generation)>;
+
+    /**
+     * @param run Called on the worker thread for every job that is still current when it is picked up
+     */
+    explicit LatestOnlyWorker(Function run) : m_run(std::move(run)) {
+        m_thread = std::thread(&LatestOnlyWorker::WorkerLoop, this);
+    }
+
+    ~LatestOnlyWorker() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopRequested = true;
+            ++m_generation; // Abort the job in progress
+        }
+        m_condition.notify_all();
+        m_thread.join();
+    }
+
+    LatestOnlyWorker(const LatestOnlyWorker&) = delete;
+    LatestOnlyWorker& operator=(const LatestOnlyWorker&) = delete;
+
+    /**
+     * @brief Replace the pending job and abort the one in progress
+     * @return Generation of the new job
+     */
+    uint64_t Submit(Job job) {
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            generation = ++m_generation;
+            m_pending = std::move(job);
+            m_hasPending = true;
+        }
+        m_condition.notify_one();
+        return generation;
+    }
+
+    /**
+     * @brief Drop the pending job and abort the one in progress
+     */
+    void Cancel() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_generation;
+        m_hasPending = false;
+    }
+
+    /**
+     * @brief Whether no job was submitted or cancelled since the one of this generation
+     */
+    bool IsCurrent(uint64_t generation) const {
+        return m_generation.load(std::memory_order_relaxed) == generation;
+    }
+
+private:
+    void WorkerLoop() {
+        while (true) {
+            Job job;
+            uint64_t generation;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_stopRequested || m_hasPending; });
+                if (m_stopRequested) return;
+                job = std::move(m_pending);
+                m_hasPending = false;
+                generation = m_generation.load();
+            }
+            m_run(job, generation);
+        }
+    }
+
+    Function m_run;
+
+    // Pending job is guarded by m_mutex
+    Job m_pending;
+    bool m_hasPending = false;
+    bool m_stopRequested = false;
+    std::atomic<uint64_t> m_generation{0};
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_thread;
+};
+
+} // namespace nbody
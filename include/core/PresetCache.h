@@ -0,0 +1,81 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace nbody {
+
+class Body;
+
+/**
+ * @brief Everything a generated body set depends on
+ *
+ * Generators must be deterministic for a given key: the same name,
+ * parameters, count and seed always produce the same bodies.
+ */
+struct PresetKey {
+    std::string name;
+    std::vector<float> parameters;      // Generator inputs (radius, mass, speed, G, pattern...)
+    int count = 0;
+    uint32_t seed = 0;
+
+    uint64_t Hash() const;
+};
+
+/**
+ * @brief On-disk cache of generated initial conditions
+ *
+ * Each entry is one compact binary file (position, velocity and mass per
+ * body) named after the key hash. Loading memory-maps the file and builds
+ * the bodies straight from the mapped records, so reloading a large preset
+ * costs one pass over the file instead of rerunning the generator.
+ */
+class PresetCache {
+public:
+    explicit PresetCache(const std::string& directory = "assets/cache");
+
+    /**
+     * @brief Append the cached bodies for key
+     * @param bodies Destination; new bodies are added at the end
+     * @param color Color of the new bodies (not part of the cached data)
+     * @return False if there is no valid entry for key
+     */
+    bool Load(const PresetKey& key, std::vector<std::unique_ptr<Body>>& bodies, const glm::vec3& color);
+
+    /**
+     * @brief Write bodies[firstBody..] as the entry for key
+     */
+    bool Store(const PresetKey& key, const std::vector<std::unique_ptr<Body>>& bodies, size_t firstBody = 0);
+
+    /**
+     * @brief Delete all cache files
+     */
+    void Clear();
+
+    std::string GetFilename(const PresetKey& key) const;
+    const std::string& GetDirectory() const { return m_directory; }
+
+    bool IsEnabled() const { return m_enabled; }
+    void SetEnabled(bool enabled) { m_enabled = enabled; }
+
+    int GetHits() const { return m_hits; }
+    int GetMisses() const { return m_misses; }
+    double GetLastLoadMs() const { return m_lastLoadMs; }
+
+    /**
+     * @brief Total size of the cache files in bytes
+     */
+    uint64_t GetDiskUsage() const;
+
+private:
+    std::string m_directory;
+    bool m_enabled = true;
+    int m_hits = 0;
+    int m_misses = 0;
+    double m_lastLoadMs = 0.0;
+};
+
+} // namespace nbody
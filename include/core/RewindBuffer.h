@@ -0,0 +1,166 @@
+#pragma once
+
+#include "core/SimulationSnapshot.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+namespace nbody {
+
+class Body;
+
+/**
+ * @brief Configuration for the rewind buffer
+ */
+struct RewindConfig {
+    size_t memoryBudgetBytes = 256u * 1024u * 1024u; // Oldest segments are evicted above this
+    int captureInterval = 4;            // Physics steps between captured frames
+    int keyframeInterval = 64;          // Delta frames per segment before a new keyframe
+    size_t maxPendingCaptures = 8;      // Captures queued for the encoder before new ones are dropped
+    float positionTolerance = 0.01f;    // Largest allowed quantisation error for positions
+    float velocityTolerance = 0.01f;    // Largest allowed quantisation error for velocities
+};
+
+/**
+ * @brief Bounded in-memory history of the simulation for scrubbing and branching
+ *
+ * The history is stored as segments: one full keyframe followed by delta frames
+ * holding 16-bit quantised position/velocity differences. Deltas are encoded
+ * against the reconstructed previous frame (closed loop), so the quantisation
+ * error never accumulates along a segment. Encoding runs on a background
+ * thread; the physics thread only pays for copying the state into a snapshot.
+ *
+ * Frames are addressed by ids that increase with every stored frame and are
+ * never reused, so an id held across evictions and truncations still names
+ * the same frame (or none). Positions in the retained history shift as old
+ * segments are evicted; use GetFrameId()/GetFrameIndex() to convert.
+ */
+class RewindBuffer {
+public:
+    RewindBuffer();
+    ~RewindBuffer();
+
+    /**
+     * @brief Start the background encoder thread
+     */
+    void Start();
+
+    /**
+     * @brief Stop the encoder thread, dropping pending captures
+     */
+    void Stop();
+
+    /**
+     * @brief Queue the current state for encoding
+     * @param bodies Bodies to capture
+     * @param step Physics step of the state
+     * @param time Simulated time of the state
+     * @return False if the encoder is behind and the capture was dropped
+     */
+    bool Capture(const std::vector<std::unique_ptr<Body>>& bodies, uint64_t step, double time);
+
+    /**
+     * @brief Reconstruct a stored frame
+     * @param frameId Id of the frame, see GetFrameId()
+     * @param snapshot Receives the reconstructed state
+     * @return True if the frame is still retained
+     */
+    bool Restore(uint64_t frameId, SimulationSnapshot& snapshot) const;
+
+    /**
+     * @brief Discard every frame stored after frameId (used when branching from a restored frame)
+     *
+     * If frameId was already evicted, every retained frame is newer and is discarded.
+     */
+    void TruncateAfter(uint64_t frameId);
+
+    /**
+     * @brief Id of the frame at a position in the retained history
+     * @param frameIndex Index between 0 (oldest retained) and GetFrameCount() - 1
+     * @return False if the index is out of range
+     */
+    bool GetFrameId(size_t frameIndex, uint64_t& frameId) const;
+
+    /**
+     * @brief Current position of a frame in the retained history
+     * @return False if the frame was evicted or discarded
+     */
+    bool GetFrameIndex(uint64_t frameId, size_t& frameIndex) const;
+
+    /**
+     * @brief Discard all stored and pending frames
+     */
+    void Clear();
+
+    // Configuration
+    void SetConfig(const RewindConfig& config);
+    RewindConfig GetConfig() const;
+
+    // Statistics
+    size_t GetFrameCount() const;
+    size_t GetMemoryUsage() const;
+    size_t GetSegmentCount() const;
+    uint64_t GetDroppedCaptures() const { return m_droppedCaptures.load(); }
+
+private:
+    struct PendingFrame {
+        SimulationSnapshot state;
+        uint64_t epoch = 0;
+    };
+
+    struct DeltaFrame {
+        uint64_t step = 0;
+        double time = 0.0;
+        glm::vec2 positionScale{0.0f};
+        glm::vec2 velocityScale{0.0f};
+        std::vector<int16_t> data;  // px, py, vx, vy per body
+    };
+
+    struct Segment {
+        SimulationSnapshot keyframe;
+        std::vector<DeltaFrame> deltas;
+        size_t bytes = 0;
+        uint64_t firstId = 0;       // Id of the keyframe; the deltas follow consecutively
+
+        size_t GetFrameCount() const { return 1 + deltas.size(); }
+    };
+
+    // Encoder
+    void WorkerLoop();
+    void Encode(PendingFrame& frame);
+    bool EncodeDelta(const SimulationSnapshot& state, DeltaFrame& delta) const;
+    static void ApplyDelta(const DeltaFrame& delta, SimulationSnapshot& state);
+    void EvictOldSegments();
+    static size_t GetDeltaMemoryUsage(const DeltaFrame& delta);
+
+    RewindConfig m_config;
+
+    // Stored history, guarded by m_mutex
+    std::deque<Segment> m_segments;
+    size_t m_frameCount = 0;
+    size_t m_memoryUsage = 0;
+    uint64_t m_nextFrameId = 0;
+
+    // Pending captures, guarded by m_mutex
+    std::deque<PendingFrame> m_pending;
+    uint64_t m_epoch = 0;       // Incremented whenever stored history is truncated
+
+    // Encoder-owned state (only touched by the worker thread)
+    SimulationSnapshot m_reference; // Reconstructed state of the last encoded frame
+    uint64_t m_referenceEpoch = 0;
+    bool m_hasReference = false;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_worker;
+    bool m_stopRequested = false;
+    std::atomic<uint64_t> m_droppedCaptures{0};
+};
+
+} // namespace nbody
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace nbody {
+
+/**
+ * @brief Memory layout of the shared-memory state ring
+ *
+ * The segment starts with a SharedStateHeader followed by frameSlots frames of
+ * frameStride bytes. Each frame is a SharedFrameHeader followed by SoA arrays
+ * of maxBodies floats: x, y, vx, vy, mass, radius. Frames are protected by a
+ * per-frame seqlock: the writer makes the sequence odd, writes, then makes it
+ * even again, so a reader that sees the same even sequence before and after
+ * reading got a consistent frame. Only plain data and lock-free atomics live
+ * here so the layout is identical in every process that maps it.
+ */
+namespace shared_state {
+
+constexpr uint32_t MAGIC = 0x4E425348;  // "NBSH"
+constexpr uint32_t VERSION = 1;
+constexpr const char* DEFAULT_NAME = "/nbody_state";
+
+enum ArrayIndex : uint32_t {
+    POSITION_X = 0,
+    POSITION_Y,
+    VELOCITY_X,
+    VELOCITY_Y,
+    MASS,
+    RADIUS,
+    ARRAY_COUNT
+};
+
+struct alignas(64) SharedStateHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t frameSlots;
+    uint32_t maxBodies;
+    uint64_t frameStride;                   // Bytes per frame, including its header
+    uint64_t framesOffset;                  // Byte offset of frame 0 from the segment start
+    uint64_t segmentSize;
+    std::atomic<uint64_t> latestFrame;      // Number of the newest complete frame + 1, 0 = none yet
+    std::atomic<uint32_t> closed;           // Set when the writer is gone or moved to a new segment
+    uint32_t writerPid;
+};
+
+struct alignas(64) SharedFrameHeader {
+    std::atomic<uint64_t> sequence;         // Odd while the frame is being written
+    uint64_t frameNumber;
+    uint64_t step;
+    double time;
+    uint32_t bodyCount;
+    uint32_t reserved;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared state needs lock-free 64-bit atomics");
+
+inline size_t ArrayBytes(uint32_t maxBodies) {
+    // Keep every array cache-line aligned
+    return (static_cast<size_t>(maxBodies) * sizeof(float) + 63) & ~static_cast<size_t>(63);
+}
+
+inline size_t FrameStride(uint32_t maxBodies) {
+    return sizeof(SharedFrameHeader) + ArrayBytes(maxBodies) * ARRAY_COUNT;
+}
+
+inline size_t SegmentSize(uint32_t maxBodies, uint32_t frameSlots) {
+    return sizeof(SharedStateHeader) + FrameStride(maxBodies) * frameSlots;
+}
+
+} // namespace shared_state
+
+} // namespace nbody
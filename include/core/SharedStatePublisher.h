@@ -0,0 +1,69 @@
+#pragma once
+
+#include "core/SharedStateLayout.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace nbody {
+
+class Body;
+
+/**
+ * @brief Configuration for publishing the simulation state to shared memory
+ */
+struct SharedStateConfig {
+    std::string name = shared_state::DEFAULT_NAME; // POSIX shared memory object name
+    int publishInterval = 1;            // Physics steps between published frames
+    uint32_t frameSlots = 8;            // Frames in the ring; readers have this many intervals to finish a read
+    uint32_t initialCapacity = 4096;    // Bodies per frame; the segment is recreated when outgrown
+};
+
+/**
+ * @brief Publishes every K-th physics step into a POSIX shared-memory ring
+ *
+ * The simulation writes straight into the mapped frame slots, so publishing
+ * costs one pass over the bodies and no serialization or system calls.
+ * External processes read the ring with SharedStateReader.
+ */
+class SharedStatePublisher {
+public:
+    explicit SharedStatePublisher(const SharedStateConfig& config = SharedStateConfig());
+    ~SharedStatePublisher();
+
+    /**
+     * @brief Create (or replace) the shared memory segment
+     * @return False if shared memory is unavailable
+     */
+    bool Open();
+
+    /**
+     * @brief Mark the segment closed for readers and unlink it
+     */
+    void Close();
+
+    bool IsOpen() const { return m_header != nullptr; }
+
+    /**
+     * @brief Publish the state if step is a multiple of the publish interval
+     * @param force Publish regardless of the interval
+     * @return True if a frame was written
+     */
+    bool Publish(const std::vector<std::unique_ptr<Body>>& bodies, uint64_t step, double time, bool force = false);
+
+    const SharedStateConfig& GetConfig() const { return m_config; }
+    void SetPublishInterval(int interval) { m_config.publishInterval = interval > 0 ? interval : 1; }
+    uint64_t GetFramesPublished() const { return m_framesPublished; }
+
+private:
+    bool Map(uint32_t capacity);
+    void Unmap();
+
+    SharedStateConfig m_config;
+    shared_state::SharedStateHeader* m_header = nullptr;
+    size_t m_mappedSize = 0;
+    uint64_t m_framesPublished = 0;
+};
+
+} // namespace nbody
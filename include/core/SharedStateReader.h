@@ -0,0 +1,98 @@
+#pragma once
+
+#include "core/SharedStateLayout.h"
+#include <string>
+#include <cstdint>
+
+namespace nbody {
+
+/**
+ * @brief Zero-copy view of one published frame
+ *
+ * The arrays point straight into the shared mapping. The writer may reuse the
+ * slot once it wraps around the ring, so check IsValid() after reading: if it
+ * returns false the data read may be torn and should be discarded.
+ */
+struct SharedFrameView {
+    uint64_t frameNumber = 0;
+    uint64_t step = 0;
+    double time = 0.0;
+    uint32_t bodyCount = 0;
+
+    const float* positionX = nullptr;
+    const float* positionY = nullptr;
+    const float* velocityX = nullptr;
+    const float* velocityY = nullptr;
+    const float* mass = nullptr;
+    const float* radius = nullptr;
+
+    /**
+     * @brief Check that the writer has not touched the frame since it was acquired
+     */
+    bool IsValid() const;
+
+    const shared_state::SharedFrameHeader* header = nullptr;
+    uint64_t sequence = 0;
+};
+
+/**
+ * @brief Read-only client for the shared-memory state ring
+ *
+ * Typical use from an external tool:
+ *
+ *     SharedStateReader reader;
+ *     reader.Open();
+ *     SharedFrameView frame;
+ *     if (reader.AcquireLatest(frame)) {
+ *         ... read frame.positionX[i] ...
+ *         if (!frame.IsValid()) { ... discard ... }
+ *     }
+ */
+class SharedStateReader {
+public:
+    SharedStateReader() = default;
+    ~SharedStateReader();
+
+    SharedStateReader(const SharedStateReader&) = delete;
+    SharedStateReader& operator=(const SharedStateReader&) = delete;
+
+    /**
+     * @brief Map the segment read-only
+     * @param name POSIX shared memory object name
+     * @return False if no simulation is publishing under that name
+     */
+    bool Open(const std::string& name = shared_state::DEFAULT_NAME);
+
+    void Close();
+    bool IsOpen() const { return m_header != nullptr; }
+
+    /**
+     * @brief True when the writer has exited or moved to a larger segment; call Open() again
+     */
+    bool IsStale() const;
+
+    /**
+     * @brief Get the newest complete frame
+     * @return False if nothing has been published yet or the writer kept the frame busy
+     */
+    bool AcquireLatest(SharedFrameView& view) const;
+
+    /**
+     * @brief Get a specific frame if it is still in the ring
+     */
+    bool Acquire(uint64_t frameNumber, SharedFrameView& view) const;
+
+    /**
+     * @brief Number of the newest complete frame, or UINT64_MAX if none
+     */
+    uint64_t GetLatestFrameNumber() const;
+
+    uint32_t GetFrameSlots() const { return m_header ? m_header->frameSlots : 0; }
+    uint32_t GetMaxBodies() const { return m_header ? m_header->maxBodies : 0; }
+
+private:
+    const shared_state::SharedStateHeader* m_header = nullptr;
+    size_t m_mappedSize = 0;
+};
+
+} // namespace nbody
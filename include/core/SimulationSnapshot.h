@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace nbody {
+
+class Body;
+
+/**
+ * @brief Plain-data copy of the simulation state at one physics step
+ *
+ * Snapshots are stored as flat arrays (Structure of Arrays) so they can be
+ * handed to background threads without touching the live Body objects.
+ */
+struct SimulationSnapshot {
+    uint64_t step = 0;
+    double time = 0.0;
+
+    std::vector<glm::vec2> positions;
+    std::vector<glm::vec2> velocities;
+    std::vector<float> masses;
+    std::vector<float> densities;
+    std::vector<glm::vec3> colors;
+    std::vector<uint8_t> fixed;
+
+    size_t size() const { return positions.size(); }
+
+    /**
+     * @brief Copy the state of all bodies into this snapshot
+     * @param bodies Bodies to copy
+     * @param stepIndex Physics step the state belongs to
+     * @param simulationTime Simulated time the state belongs to
+     */
+    void Capture(const std::vector<std::unique_ptr<Body>>& bodies, uint64_t stepIndex, double simulationTime);
+
+    /**
+     * @brief Recreate bodies from this snapshot (existing bodies are replaced)
+     * @param bodies Destination body vector
+     */
+    void Restore(std::vector<std::unique_ptr<Body>>& bodies) const;
+
+    /**
+     * @brief Approximate heap memory used by the snapshot in bytes
+     */
+    size_t GetMemoryUsage() const;
+
+    /**
+     * @brief Check whether two snapshots describe the same set of bodies
+     * (same count, masses, densities, colors and flags), i.e. only positions
+     * and velocities may differ between them
+     */
+    bool HasSameBodies(const SimulationSnapshot& other) const;
+};
+
+} // namespace nbody
@@ -1,15 +1,16 @@
 
 #pragma once
 
+#include "core/Body.h"
 #include <glm/glm.hpp>
 #include <vector>
 #include <memory>
 #include <array>
+#include <algorithm>
+#include <cmath>
 
 namespace nbody {
 
-class Body;
-
 /**
  * @brief Spatial partitioning node for Barnes-Hut algorithm
  */
@@ -23,10 +24,12 @@ struct QuadTreeNode {
     // Physical properties
     float totalMass = 0.0f;
     glm::vec2 centerOfMass{0.0f};
+    float maxRadius = 0.0f; // Largest body radius in the subtree, bounds contact tests
     
     // Tree structure
     std::array<std::unique_ptr<QuadTreeNode>, 4> children;
     Body* body = nullptr; // Only valid if isLeaf is true and node is not empty
+    int bodyIndex = -1;   // Index of body in the vector passed to BuildTree
     bool isLeaf = true;
     
     // Bounds checking
@@ -53,6 +56,14 @@ struct QuadTreeNode {
     }
 };
 
+/**
+ * @brief Two overlapping bodies found during a tree walk (first < second)
+ */
+struct ContactPair {
+    int first;
+    int second;
+};
+
 /**
  * @brief Barnes-Hut tree for O(N log N) force calculations
  */
@@ -77,6 +88,31 @@ public:
      */
     glm::vec2 CalculateForce(const Body& body, float theta, float G, float softeningLength) const;
 
+    /**
+     * @brief Calculate force on a body and collect its contacts in the same walk
+     * @param bodyIndex Index of body in the vector passed to BuildTree
+     * @param contacts Receives each overlapping pair once, from the body with the lower index
+     * @return Force vector, identical to CalculateForce
+     *
+     * Leaves opened for the force are also tested for overlap. Nodes accepted by
+     * the opening criterion are still entered when their square lies within
+     * body radius + node maxRadius, so no contact is missed at any theta.
+     */
+    glm::vec2 CalculateForceAndContacts(const Body& body, int bodyIndex, float theta, float G,
+                                        float softeningLength, std::vector<ContactPair>& contacts) const;
+
+    /**
+     * @brief Visit every body in the tree within radius of point
+     * @param visitor Called as visitor(const Body& body, int bodyIndex) for each body found
+     *
+     * Only subtrees whose square intersects the circle are entered. Bodies that
+     * were not inserted (see GetDroppedIndices()) are not visited.
+     */
+    template <typename Visitor>
+    void ForEachBodyInRadius(const glm::vec2& point, float radius, Visitor&& visitor) const {
+        if (m_root) VisitBodiesInRadius(m_root.get(), point, radius * radius, visitor);
+    }
+
     /**
      * @brief Get tree statistics
      */
@@ -99,6 +135,15 @@ public:
      */
     const QuadTreeNode* GetRoot() const { return m_root.get(); }
     
+    /**
+     * @brief Indices of the bodies BuildTree could not insert, in ascending order
+     *
+     * A body within 1e-6 of one already in the tree shares its leaf and is left
+     * out, so tree walks miss it entirely, contacts with third bodies included.
+     * Searches that must be complete check these few bodies directly.
+     */
+    const std::vector<int>& GetDroppedIndices() const { return m_droppedIndices; }
+    
     /**
      * @brief Reserve memory for expected number of nodes (performance optimization)
      */
@@ -106,8 +151,9 @@ public:
 
 private:
     std::unique_ptr<QuadTreeNode> m_root;
+    std::vector<int> m_droppedIndices;
     mutable TreeStats m_stats;    // Tree building
-    void InsertBody(QuadTreeNode* node, Body* body);
+    bool InsertBody(QuadTreeNode* node, Body* body, int bodyIndex);
     void Subdivide(QuadTreeNode* node);
     void UpdateMassAndCenter(QuadTreeNode* node);
     
@@ -119,6 +165,28 @@ private:
                         glm::vec2& center, float& size) const;
     void CountNodes(const QuadTreeNode* node, TreeStats& stats, int depth = 0) const;
     
+    template <typename Visitor>
+    static void VisitBodiesInRadius(const QuadTreeNode* node, const glm::vec2& point, float radiusSq, Visitor& visitor) {
+        // Distance from the point to the node's square
+        float halfSize = node->size * 0.5f;
+        float dx = std::max(std::abs(point.x - node->center.x) - halfSize, 0.0f);
+        float dy = std::max(std::abs(point.y - node->center.y) - halfSize, 0.0f);
+        if (dx * dx + dy * dy > radiusSq) return;
+        
+        if (node->isLeaf) {
+            if (node->body) {
+                glm::vec2 delta = node->body->GetPosition() - point;
+                if (glm::dot(delta, delta) <= radiusSq) {
+                    visitor(*node->body, node->bodyIndex);
+                }
+            }
+            return;
+        }
+        for (const auto& child : node->children) {
+            if (child) VisitBodiesInRadius(child.get(), point, radiusSq, visitor);
+        }
+    }
+    
     // Constants
     static constexpr float SOFTENING_LENGTH = 0.1f; // Increased for better stability and performance
     static constexpr float MIN_NODE_SIZE = 0.1f;
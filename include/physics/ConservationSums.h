@@ -0,0 +1,76 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cmath>
+
+namespace nbody {
+
+/**
+ * @brief Double accumulator with Neumaier compensated summation
+ *
+ * The rounding error of every addition is carried separately, so sums over
+ * millions of terms of mixed sign stay accurate to a few ulps instead of
+ * drifting with the body count.
+ */
+struct CompensatedSum {
+    double sum = 0.0;
+    double compensation = 0.0;
+
+    void Add(double value) {
+        double total = sum + value;
+        if (std::abs(sum) >= std::abs(value)) {
+            compensation += (sum - total) + value;
+        } else {
+            compensation += (value - total) + sum;
+        }
+        sum = total;
+    }
+
+    void Add(const CompensatedSum& other) {
+        Add(other.sum);
+        Add(other.compensation);
+    }
+
+    double Value() const { return sum + compensation; }
+};
+
+/**
+ * @brief Partial sums of the conserved quantities, fed one body at a time
+ *
+ * One instance per thread; cache-line aligned so neighbors in a vector don't
+ * false-share while the integrator writes them.
+ */
+struct alignas(64) ConservationSums {
+    CompensatedSum mass;
+    CompensatedSum kinetic;
+    CompensatedSum momentumX;
+    CompensatedSum momentumY;
+    CompensatedSum angularMomentum;   // About the origin
+    CompensatedSum massMomentX;       // Sum of m * x, for the centre of mass
+    CompensatedSum massMomentY;
+
+    void Add(float bodyMass, const glm::vec2& position, const glm::vec2& velocity) {
+        const double m = bodyMass;
+        const double x = position.x, y = position.y;
+        const double vx = velocity.x, vy = velocity.y;
+        mass.Add(m);
+        kinetic.Add(0.5 * m * (vx * vx + vy * vy));
+        momentumX.Add(m * vx);
+        momentumY.Add(m * vy);
+        angularMomentum.Add(m * (x * vy - y * vx));
+        massMomentX.Add(m * x);
+        massMomentY.Add(m * y);
+    }
+
+    void Add(const ConservationSums& other) {
+        mass.Add(other.mass);
+        kinetic.Add(other.kinetic);
+        momentumX.Add(other.momentumX);
+        momentumY.Add(other.momentumY);
+        angularMomentum.Add(other.angularMomentum);
+        massMomentX.Add(other.massMomentX);
+        massMomentY.Add(other.massMomentY);
+    }
+};
+
+} // namespace nbody
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <queue>
+#include <cstdint>
+
+namespace nbody {
+
+class Body;
+
+/**
+ * @brief Event-driven hard-sphere dynamics for collision-dominated scenes
+ *
+ * Instead of testing for overlaps once per step, bodies move ballistically
+ * and every contact is resolved at its exact time. Pair collision times are
+ * predicted only against bodies in the neighboring cells of a uniform grid
+ * (cells are at least one body diameter wide), and cell-crossing events keep
+ * those predictions up to date as bodies move. Events sit in a priority
+ * queue and are invalidated lazily: each body counts its collisions, and an
+ * event is dropped when popped if a participant has collided since it was
+ * predicted. Each body keeps its own clock and is only advanced when it takes
+ * part in an event.
+ *
+ * Inelastic collapse (a clump colliding ever more often as it loses energy)
+ * is contained per body: once a body has collided maxCollisionsPerBody times
+ * in a step, no more collisions are predicted for it and it passes through
+ * its neighbours until the step ends, while the rest of the scene carries on.
+ */
+class EventDrivenSolver {
+public:
+    struct Settings {
+        float restitution = 1.0f;
+        int maxCollisionsPerBody = 64;  // Collisions of one body in a step before it stops colliding
+        int maxEventsPerBody = 1024;    // Backstop on all events of the step, per body in the scene
+    };
+
+    /**
+     * @brief Move bodies in straight lines for deltaTime, resolving contacts at their exact times
+     *
+     * Fixed and dragged bodies act as immovable obstacles. Overlapping pairs
+     * that are approaching collide immediately.
+     */
+    void Advance(std::vector<std::unique_ptr<Body>>& bodies, const Settings& settings, double deltaTime);
+
+    uint64_t GetCollisionCount() const { return m_collisions; }
+    uint64_t GetCellCrossingCount() const { return m_cellCrossings; }
+    uint64_t GetStaleEventCount() const { return m_staleEvents; }
+    int GetCappedBodyCount() const { return m_cappedBodies; }
+    bool HitEventLimit() const { return m_hitEventLimit; }
+
+private:
+    struct Event {
+        double time;
+        int first;
+        int second;               // Body index, or -1 for a cell crossing
+        uint32_t firstCount;
+        uint32_t secondCount;
+        int newCell;              // Destination of a cell crossing
+
+        bool operator>(const Event& other) const { return time > other.time; }
+    };
+
+    void BuildGrid(const std::vector<std::unique_ptr<Body>>& bodies, double deltaTime);
+    int CellOf(const glm::dvec2& position) const;
+    void InsertIntoCell(int body, int cell);
+    void RemoveFromCell(int body);
+    void AdvanceBody(int body, double time);
+    void PredictCollisions(int body, double now, double endTime, bool onlyHigher);
+    void PredictCellCrossing(int body, double now, double endTime);
+    void Collide(int first, int second, double restitution);
+
+    // Per-body state while a step is running (double precision, own clock)
+    std::vector<glm::dvec2> m_positions;
+    std::vector<glm::dvec2> m_velocities;
+    std::vector<double> m_times;
+    std::vector<double> m_radii;
+    std::vector<double> m_inverseMasses;   // 0 for immovable bodies
+    std::vector<uint32_t> m_counts;        // Collisions so far, for lazy invalidation and the per-body cap
+    uint32_t m_maxCollisions = 0;
+
+    // Uniform grid with intrusive per-cell lists
+    glm::dvec2 m_gridOrigin{0.0};
+    double m_cellSize = 1.0;
+    int m_cellsX = 1;
+    int m_cellsY = 1;
+    std::vector<int> m_cellHeads;
+    std::vector<int> m_next;
+    std::vector<int> m_previous;
+    std::vector<int> m_cellOfBody;
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> m_events;
+
+    uint64_t m_collisions = 0;
+    uint64_t m_cellCrossings = 0;
+    uint64_t m_staleEvents = 0;
+    int m_cappedBodies = 0;
+    bool m_hitEventLimit = false;
+
+    static constexpr int MAX_CELLS_PER_AXIS = 1024;
+};
+
+} // namespace nbody
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace nbody {
+
+/**
+ * @brief Initial state of one body of a few-body preset, in units with G = 1
+ */
+struct FewBodyInitial {
+    double x, y, vx, vy, m;
+};
+
+/**
+ * @brief Look up a named few-body preset ("figure8" or "triple")
+ * @param bodies Replaced with the preset's bodies
+ * @return False if the name is unknown
+ */
+bool GetFewBodyPreset(const std::string& name, std::vector<FewBodyInitial>& bodies);
+
+} // namespace nbody
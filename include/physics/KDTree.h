@@ -0,0 +1,97 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <atomic>
+
+namespace nbody {
+
+class Body;
+
+/**
+ * @brief Node of the balanced KD-tree
+ *
+ * The bounds are the tight box of the node's bodies rather than a fixed
+ * square, so a thin disk or a stream gets thin boxes along its length.
+ */
+struct KDTreeNode {
+    glm::vec2 boundsMin{0.0f};
+    glm::vec2 boundsMax{0.0f};
+    glm::vec2 centerOfMass{0.0f};
+    float totalMass = 0.0f;
+    float bmax = 0.0f;          // Distance from the centre of mass to the farthest corner of the bounds
+    int first = 0;              // Range of the node's bodies in the tree's sorted order
+    int count = 0;
+    int children = -1;          // Index of the left child, the right one follows; -1 for leaves
+
+    bool IsLeaf() const { return children < 0; }
+    bool Contains(const glm::vec2& point) const {
+        return point.x >= boundsMin.x && point.x <= boundsMax.x &&
+               point.y >= boundsMin.y && point.y <= boundsMax.y;
+    }
+};
+
+/**
+ * @brief Balanced KD-tree for Barnes-Hut forces on anisotropic distributions
+ *
+ * Each node splits its bodies at the median along the longer side of its
+ * bounds, so the depth is log2(N / LEAF_SIZE) whatever the shape of the
+ * distribution, where the quadtree's geometric halves go deep along thin
+ * structures and leave most of its square cells empty. The subtrees above
+ * PARALLEL_BUILD_SIZE bodies are built as OpenMP tasks.
+ *
+ * A node is accepted as a point mass when bmax < theta * d / sqrt(2), d
+ * being the distance to its centre of mass (Salmon & Warren's Bmax
+ * criterion, scaled to match the quadtree's accuracy at equal theta). Unlike
+ * the quadtree's size / d test this looks at the actual extent of the mass
+ * around the point it is replaced by. Nodes whose bounds contain the target
+ * are always opened.
+ */
+class KDTree {
+public:
+    /**
+     * @brief Build the tree from a snapshot of the bodies' positions and masses
+     */
+    void BuildTree(const std::vector<std::unique_ptr<Body>>& bodies);
+
+    /**
+     * @brief Acceleration on a body from all other bodies in the tree
+     * @param bodyIndex Index of the body in the vector passed to BuildTree, skipped in the sums
+     * @param interactions Incremented by the number of node and body terms summed
+     * @return Same kernel as BarnesHutTree::CalculateForce
+     */
+    glm::vec2 CalculateForce(const glm::vec2& position, int bodyIndex, float theta, float G,
+                             float softeningLength, int& interactions) const;
+
+    struct TreeStats {
+        int totalNodes = 0;
+        int leafNodes = 0;
+        int maxDepth = 0;
+    };
+
+    const TreeStats& GetStats() const { return m_stats; }
+    const std::vector<KDTreeNode>& GetNodes() const { return m_nodes; }
+
+    static constexpr int LEAF_SIZE = 8;
+    static constexpr int PARALLEL_BUILD_SIZE = 8192;
+
+private:
+    struct Item {
+        glm::vec2 position;
+        float mass;
+        int index;              // In the vector passed to BuildTree
+    };
+
+    void Build(int nodeIndex, int first, int count);
+    void CountNodes();
+
+    std::vector<Item> m_items;          // Bodies in tree order; every node's bodies are contiguous
+    std::vector<KDTreeNode> m_nodes;
+    std::atomic<int> m_nodeCount{0};
+    TreeStats m_stats;
+
+    static constexpr int MAX_STACK = 128; // Walk stack; a balanced tree needs about its depth
+};
+
+} // namespace nbody
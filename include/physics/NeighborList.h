@@ -0,0 +1,65 @@
+#pragma once
+
+#include "physics/BarnesHut.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstdint>
+
+namespace nbody {
+
+class Body;
+
+/**
+ * @brief Persistent contact candidate lists with a skin (Verlet lists)
+ *
+ * Every pair closer than r_i + r_j + skin is stored in CSR form: the
+ * candidates of body i are m_neighbors[m_offsets[i] .. m_offsets[i + 1]),
+ * holding only j > i in ascending order. Two bodies that were not candidates
+ * at the last build can only touch after their gap shrank by more than the
+ * skin, which needs at least one of them to move more than skin / 2, so the
+ * lists are only rebuilt once some body has moved that far.
+ */
+class ContactNeighborList {
+public:
+    /**
+     * @brief Rebuild the lists if any body moved more than skin / 2 since the last build
+     * @return True if the lists were rebuilt
+     */
+    bool Update(const std::vector<std::unique_ptr<Body>>& bodies, float skin);
+
+    /**
+     * @brief Force a rebuild on the next Update
+     */
+    void Invalidate() { m_referenceBodies.clear(); }
+
+    /**
+     * @brief Candidates of body i (all with a larger index)
+     */
+    const uint32_t* BeginNeighbors(size_t i) const { return m_neighbors.data() + m_offsets[i]; }
+    const uint32_t* EndNeighbors(size_t i) const { return m_neighbors.data() + m_offsets[i + 1]; }
+
+    size_t GetBodyCount() const { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+    size_t GetPairCount() const { return m_neighbors.size(); }
+    int GetStepsSinceRebuild() const { return m_stepsSinceRebuild; }
+
+private:
+    bool NeedsRebuild(const std::vector<std::unique_ptr<Body>>& bodies, float skin) const;
+    void Rebuild(const std::vector<std::unique_ptr<Body>>& bodies, float skin);
+
+    BarnesHutTree m_tree;
+    std::vector<uint32_t> m_offsets;    // CSR row starts, one per body plus the end
+    std::vector<uint32_t> m_neighbors;  // CSR column indices
+
+    // State at the last build
+    std::vector<const Body*> m_referenceBodies;
+    std::vector<glm::vec2> m_referencePositions;
+    std::vector<float> m_referenceRadii;
+    float m_skin = 0.0f;
+    int m_stepsSinceRebuild = 0;
+
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> m_threadPairs;
+};
+
+} // namespace nbody
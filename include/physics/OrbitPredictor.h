@@ -0,0 +1,134 @@
+#pragma once
+
+#include "core/LatestOnlyWorker.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace nbody {
+
+class Body;
+class BarnesHutTree;
+struct QuadTreeNode;
+
+/**
+ * @brief Predicts the path of one body on a background thread
+ *
+ * When a prediction is requested, the rest of the system is frozen into a
+ * coarse field:
+ * - the top levels of the Barnes-Hut tree become softened point masses;
+ * - the heaviest bodies near the predicted one are kept as exact point
+ *   masses, and their mass is taken out of the tree node they sit in.
+ *
+ * Without a current tree, a uniform grid takes the place of the top levels.
+ * With only a few bodies, every body is exact. The body is then integrated
+ * through the field with an adaptive Dormand-Prince 5(4) scheme on a worker
+ * thread.
+ *
+ * Requests never wait. A new request replaces a pending one and aborts the
+ * one in progress. The path is published in pieces as it grows, so the
+ * overlay appears straight away and extends while the worker runs.
+ */
+class OrbitPredictor {
+public:
+    struct Settings {
+        float G = 1.0f;
+        float softeningLength = 0.1f;
+        double horizon = 20.0;       // Simulation time to look ahead
+        double tolerance = 1e-8;     // Per-step error relative to the state magnitude
+        int maxPoints = 4096;
+        int exactBodies = 64;        // Heaviest nearby bodies kept as exact point masses
+        int fieldDepth = 4;          // Tree levels (or 2^depth grid cells per axis) in the far field
+    };
+
+    OrbitPredictor() = default;
+
+    OrbitPredictor(const OrbitPredictor&) = delete;
+    OrbitPredictor& operator=(const OrbitPredictor&) = delete;
+
+    /**
+     * @brief Start predicting the path of bodies[index] from its current state
+     * @param tree Tree of the last force pass, or null if the last step did not build one
+     * @param rebuildField Freeze a new field, otherwise reuse the last one (e.g. while the body is dragged)
+     */
+    void Request(const std::vector<std::unique_ptr<Body>>& bodies, size_t index, const BarnesHutTree* tree,
+                 const Settings& settings, bool rebuildField);
+
+    /**
+     * @brief Abort the prediction in progress and drop the path
+     */
+    void Cancel();
+
+    /**
+     * @brief Copy the path if it changed since the last call
+     * @return True if path was updated
+     */
+    bool FetchPath(std::vector<glm::vec2>& path);
+
+    size_t GetSourceCount() const { return m_field.size(); }
+    double GetLastDurationMs() const { return m_lastDurationMs.load(); }
+
+private:
+    struct Source {
+        glm::dvec2 position;
+        double mass;
+        double softeningSq;
+        double radius;               // Contact radius, 0 for aggregated mass
+    };
+
+    struct Cell {
+        glm::dvec2 massMoment{0.0};  // Sum of m * x
+        double mass = 0.0;
+        double initialMass = 0.0;    // Before exact bodies were taken out
+        double softeningSq = 0.0;
+    };
+
+    struct Job {
+        std::vector<Source> field;
+        glm::dvec2 position{0.0};
+        glm::dvec2 velocity{0.0};
+        double radius = 0.0;
+        Settings settings;
+    };
+
+    void BuildField(const std::vector<std::unique_ptr<Body>>& bodies, size_t index, const BarnesHutTree* tree,
+                    const Settings& settings);
+    void CollectTreeCells(const QuadTreeNode* node, int depth, int maxDepth, double softeningSq);
+    int FindTreeCell(const QuadTreeNode* root, const glm::vec2& position, int maxDepth) const;
+    using LeafHeap = std::priority_queue<std::pair<float, const QuadTreeNode*>,
+                                         std::vector<std::pair<float, const QuadTreeNode*>>, std::greater<>>;
+    void FindHeaviestLeaves(const QuadTreeNode* node, const glm::vec2& point, float radius, float minMass,
+                            const Body* exclude, size_t limit, LeafHeap& heaviest) const;
+    void Run(const Job& job, uint64_t generation);
+    void Integrate(const Job& job, uint64_t generation);
+    bool Publish(const std::vector<glm::vec2>& path, uint64_t generation);
+
+    // Frozen field, owned by the requesting thread
+    std::vector<Source> m_field;
+    std::vector<Cell> m_cells;
+    std::vector<const QuadTreeNode*> m_cellNodes;  // Tree node of each cell, when built from the tree
+    bool m_hasField = false;
+
+    // Path is guarded by m_mutex
+    std::vector<glm::vec2> m_path;
+    uint64_t m_pathVersion = 0;
+    uint64_t m_fetchedVersion = 0;
+    std::atomic<double> m_lastDurationMs{0.0};
+    std::mutex m_mutex;
+
+    // Last, so the thread stops before the members above go away
+    LatestOnlyWorker<Job> m_worker{[this](Job& job, uint64_t generation) { Run(job, generation); }};
+
+    static constexpr size_t MAX_EXACT_FIELD = 2048;  // Below this many bodies every body is exact
+    static constexpr float EXACT_MASS_FRACTION = 1e-4f; // Of the total mass, lighter nearby bodies stay aggregated
+    static constexpr size_t PUBLISH_INTERVAL = 64;   // Points between partial publishes
+    static constexpr int MAX_STEPS = 200000;
+};
+
+} // namespace nbody
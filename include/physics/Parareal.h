@@ -0,0 +1,116 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace nbody {
+
+/**
+ * @brief Configuration for a Parareal run of a few-body system
+ */
+struct PararealConfig {
+    std::string preset = "figure8";     // "figure8" or "triple", used unless bodies is set
+    std::string bodies;                 // Optional body file ("bodies.count", "body.<i>.*", "physics.*" keys)
+    double duration = 1000.0;
+    int windows = 10;                   // Consecutive Parareal windows the duration is split into
+    int slices = 0;                     // Time slices per window, 0 = one per thread
+    double fineStep = 1e-4;             // Fourth-order Yoshida step
+    double coarseStep = 1e-2;           // Leapfrog step
+    double tolerance = 1e-10;           // Largest relative state change between iterations
+    int maxIterations = 0;              // Per window, 0 = slices (where Parareal equals the serial fine run)
+    bool reference = false;             // Also run the fine integrator serially for the speedup and error
+    int threads = 0;                    // 0 = all cores
+    std::string output = "parareal.csv";
+};
+
+/**
+ * @brief Convergence of one Parareal iteration
+ */
+struct PararealIteration {
+    int window = 0;
+    int iteration = 0;
+    double change = 0.0;                // Largest relative state change at a slice boundary
+    double energyError = 0.0;           // |E - E0| / |E0| at the end of the window
+    double wallTime = 0.0;              // ms
+};
+
+/**
+ * @brief Parallel-in-time integration for long runs of a few bodies
+ *
+ * A run is split into windows, and each window into one time slice per
+ * core. A cheap leapfrog with a large step (G) sweeps serially across the
+ * slices, the fourth-order fine integrator (F) advances every slice from
+ * its current start state concurrently, and the boundary states are
+ * corrected as
+ *
+ *     U[n+1] = G(U_new[n]) + F(U_old[n]) - G(U_old[n])
+ *
+ * until they stop changing. After k iterations the first k slices equal the
+ * serial fine solution, so the run never takes more than `slices` iterations,
+ * and converging in fewer gives a wall-clock speedup of about
+ * slices / iterations on runs that have no spatial parallelism to exploit.
+ *
+ * Both integrators use fixed steps so they are smooth maps of the start
+ * state, which the correction relies on.
+ */
+class Parareal {
+public:
+    explicit Parareal(const PararealConfig& config) : m_config(config) {}
+
+    /**
+     * @brief Integrate the configured system over the whole duration
+     * @return False if the initial conditions could not be loaded
+     */
+    bool Run();
+
+    /**
+     * @brief Write per-iteration convergence as CSV
+     */
+    bool WriteResults(const std::string& filename) const;
+
+    const std::vector<PararealIteration>& GetIterations() const { return m_iterations; }
+    double GetWallTime() const { return m_wallTime; }
+    double GetFineSliceTime() const { return m_fineSliceTime; }
+    double GetReferenceTime() const { return m_referenceTime; }
+    double GetReferenceError() const { return m_referenceError; }
+    double GetEnergyError() const { return m_energyError; }
+    int GetSlices() const { return m_slices; }
+
+    /**
+     * @brief Entry point for the headless "--parareal [key=value ...]" mode
+     * @return Process exit code
+     */
+    static int RunFromCommandLine(int argc, char** argv, int firstArg);
+
+private:
+    using State = std::vector<double>;  // x, y, vx, vy per body
+
+    bool LoadBodies(State& state);
+    void Coarse(const State& start, double duration, State& end) const;
+    void Fine(const State& start, double duration, State& end) const;
+    void ComputeAccelerations(const State& state, std::vector<double>& acceleration) const;
+    double ComputeEnergy(const State& state) const;
+
+    /**
+     * @brief Largest change between two states relative to the system's size and speed
+     */
+    double Difference(const State& a, const State& b) const;
+
+    PararealConfig m_config;
+    std::vector<double> m_masses;
+    double m_G = 1.0;
+    double m_softening2 = 0.0;
+    double m_lengthScale = 1.0;
+    double m_speedScale = 1.0;
+    int m_slices = 0;
+
+    std::vector<PararealIteration> m_iterations;
+    double m_wallTime = 0.0;            // ms
+    double m_fineSliceTime = 0.0;       // ms, mean of all fine propagations, timed while they run concurrently
+    double m_referenceTime = 0.0;       // ms for the serial fine run, 0 if not run
+    double m_referenceError = 0.0;      // Relative difference from the serial fine end state
+    double m_energyError = 0.0;
+};
+
+} // namespace nbody
@@ -5,13 +5,21 @@
 #include <vector>
 #include <memory>
 #include <chrono>
+#include <string>
+#include <cstdint>
 #include "physics/BarnesHut.h"
+#include "physics/ConservationSums.h"
 
 namespace nbody {
 
 class Body;
 class ComputeShader;
 class GPUPhysicsSolver;
+class CloseEncounterSolver;
+class WisdomHolmanIntegrator;
+class ContactNeighborList;
+class EventDrivenSolver;
+class KDTree;
 struct BodyArrays;
 
 /**
@@ -26,6 +34,14 @@ struct PhysicsStats {
     int bodyCount = 0;
     int forceCalculations = 0;
     int collisions = 0;
+    int regularizedPairs = 0;
+    int regularizedSubsteps = 0;
+    int collisionEvents = 0;          // Collisions plus cell crossings processed by the event-driven engine
+    int cappedBodies = 0;             // Bodies that reached the event-driven collision cap this step
+    bool eventLimitHit = false;       // The event-driven step ran out of events and finished ballistically
+    int sweptCollisions = 0;          // Impacts found inside the step by continuous detection
+    int neighborPairs = 0;            // Contact candidates in the neighbor lists
+    int neighborListAge = 0;          // Steps since the neighbor lists were rebuilt
     std::string method = "Direct";
 };
 
@@ -38,6 +54,12 @@ struct EnergyStats {
     double total = 0.0;
     double initial = 0.0;
     double error = 0.0;
+    
+    // Reduced during the integration pass of the last step
+    double mass = 0.0;
+    glm::dvec2 momentum{0.0};
+    double angularMomentum = 0.0;     // About the origin
+    glm::dvec2 centerOfMass{0.0};
 };
 
 /**
@@ -51,13 +73,25 @@ struct PhysicsConfig {
     float dampingFactor = 1.0f;           // No damping by default
     bool useBarnesHut = true;
     float barnesHutTheta = 0.7f;          // Higher value for better performance (~0.5-1.0)
+    bool useKDTree = false;               // Balanced KD-tree instead of the quadtree, for disks and streams
     bool enableCollisions = true;
+    bool treeCollisions = true;           // Find contacts during the Barnes-Hut walk instead of a separate O(N^2) pass
+    bool useNeighborLists = true;         // Keep contact candidates between steps (takes precedence over treeCollisions)
+    float neighborSkin = 2.0f;            // Extra distance kept in the neighbor lists
+    bool continuousCollisions = false;    // Swept tests so fast bodies can't pass through each other within a step
+    bool useEventDriven = false;          // Event-driven hard spheres for scenes where contacts outweigh gravity
     float restitution = 0.8f;
     bool adaptiveTimeStep = false;
     float maxTimeStep = 0.033f;
     float minTimeStep = 0.001f;
     bool useGPU = false;
     int maxBodiesForDirect = 1000;
+    bool regularizeCloseEncounters = true; // Levi-Civita regularization of bound close pairs
+    float regularizationSteps = 32.0f;    // Pairs with free-fall time below this many steps are regularized
+    int regularizationSubsteps = 64;      // Regularized substeps per pair orbit
+    bool useWisdomHolman = false;         // Symplectic map for systems with one dominant mass
+    float wisdomHolmanOrbitFraction = 0.05f; // Largest Wisdom-Holman step as a fraction of the shortest orbit
+    float wisdomHolmanMassRatio = 10.0f;  // Central mass must exceed the rest by this factor
 };
 
 /**
@@ -109,25 +143,69 @@ public:
     void SetTimeStep(float dt) { m_config.timeStep = dt; }
     void SetBarnesHutTheta(float theta) { m_config.barnesHutTheta = theta; }
     void SetCollisionEnabled(bool enabled) { m_config.enableCollisions = enabled; }
+    void SetTreeCollisions(bool enabled) { m_config.treeCollisions = enabled; }
     void SetRestitution(float restitution) { m_config.restitution = restitution; }
     void SetUseBarnesHut(bool use) { m_config.useBarnesHut = use; }
+    void SetUseKDTree(bool use) { m_config.useKDTree = use; }
     void SetUseGPU(bool use) { m_config.useGPU = use; }
+    void SetRegularizeCloseEncounters(bool enabled) { m_config.regularizeCloseEncounters = enabled; }
+    void SetUseWisdomHolman(bool use) { m_config.useWisdomHolman = use; }
     
     // GPU availability
     bool IsGPUAvailable() const { return m_gpuAvailable; }
     
     // Statistics
     const PhysicsStats& GetStats() const { return m_stats; }
+    
+    /**
+     * @brief Energy, momentum, angular momentum and centre of mass of the bodies
+     *
+     * The kinetic and momentum terms come from the sums the integrator reduced
+     * during the last step, unless the bodies were edited since (see
+     * InvalidateConservation()). Otherwise they are summed here instead. The potential is
+     * always a direct pair sum.
+     */
     EnergyStats CalculateEnergyStats(const std::vector<std::unique_ptr<Body>>& bodies) const;
     
+    /**
+     * @brief CalculateEnergyStats() without the potential, which is left at zero
+     *
+     * Linear in the number of bodies, and free right after a step.
+     */
+    EnergyStats CalculateConservationStats(const std::vector<std::unique_ptr<Body>>& bodies) const;
+    
+    /**
+     * @brief Drop the conservation sums of the last step
+     *
+     * Call whenever the bodies are edited outside Update() (moved, given new
+     * velocities or masses, or replaced by as many others), since the body
+     * count alone cannot tell that the sums are out of date.
+     */
+    void InvalidateConservation() { m_conservationValid = false; }
+    
+    /**
+     * @brief Potential energy of the pairs (i, j > i) for rows i in [firstRow, lastRow)
+     *
+     * Works on copied positions and masses, so the rows of one snapshot can be
+     * summed a range at a time while the simulation moves on.
+     */
+    double CalculatePotentialRows(const std::vector<glm::vec2>& positions, const std::vector<float>& masses,
+                                  size_t firstRow, size_t lastRow) const;
+    
+    // Simulation clock (advanced once per Update)
+    uint64_t GetStepCount() const { return m_stepCount; }
+    double GetSimulationTime() const { return m_simulationTime; }
+    void SetSimulationClock(uint64_t stepCount, double simulationTime);
+    
     // Utility
     void Reset();
     
     // Performance and debugging
     void BenchmarkMethods(std::vector<std::unique_ptr<Body>>& bodies);  // Performance benchmarking
     
-    // Barnes-Hut tree access for visualization
-    const BarnesHutTree* GetBarnesHutTree() const { return m_barnesHutTree.get(); }
+    // Tree access for visualization; each is null unless the last force pass built it
+    const BarnesHutTree* GetBarnesHutTree() const;
+    const KDTree* GetKDTree() const;
     
     // Shared force calculation utility
     static glm::vec2 CalculateGravitationalForce(
@@ -141,6 +219,10 @@ private:
     PhysicsStats m_stats;
     bool m_gpuAvailable = false;
     
+    // Simulation clock
+    uint64_t m_stepCount = 0;
+    double m_simulationTime = 0.0;
+    
     // Timing
     std::chrono::high_resolution_clock::time_point m_frameStart;
     
@@ -150,9 +232,37 @@ private:
     // Barnes-Hut tree for force approximation
     std::unique_ptr<BarnesHutTree> m_barnesHutTree;
     
+    // Balanced KD-tree, the alternative to the quadtree
+    std::unique_ptr<KDTree> m_kdTree;
+    
     // GPU physics solver
     std::unique_ptr<GPUPhysicsSolver> m_gpuSolver;
     
+    // Regularized integration of bound close pairs
+    std::unique_ptr<CloseEncounterSolver> m_closeEncounters;
+    
+    // Wisdom-Holman map for planetary systems
+    std::unique_ptr<WisdomHolmanIntegrator> m_wisdomHolman;
+    
+    // Contact candidates kept between steps
+    std::unique_ptr<ContactNeighborList> m_neighborList;
+    
+    // Event-driven hard-sphere dynamics
+    std::unique_ptr<EventDrivenSolver> m_eventDriven;
+    
+    // Broad phase for continuous collision detection
+    std::unique_ptr<BarnesHutTree> m_sweepTree;
+    
+    // Contacts found by the Barnes-Hut walk, one buffer per thread
+    std::vector<std::vector<ContactPair>> m_contactBuffers;
+    bool m_contactsFromTree = false; // Set when this step's force pass already found the contacts
+    
+    // Conservation sums accumulated by the integrator, one per thread
+    std::vector<ConservationSums> m_threadConservation;
+    EnergyStats m_conservation;      // Reduced at the end of the last step
+    size_t m_conservationBodyCount = 0;
+    bool m_conservationValid = false;
+    
     // Private methods
     void StartTimer();
     void EndTimer(double& timeAccumulator);
@@ -162,16 +272,35 @@ private:
     void CalculateForcesOptimized(std::vector<std::unique_ptr<Body>>& bodies);      // Block-based for cache efficiency
     void CalculateForcesSpatiallyOptimized(std::vector<std::unique_ptr<Body>>& bodies); // Spatial sorting optimization
     void CalculateForcesBarnesHut(std::vector<std::unique_ptr<Body>>& bodies);
+    void CalculateForcesKDTree(std::vector<std::unique_ptr<Body>>& bodies);
     void CalculateForcesGPU(std::vector<std::unique_ptr<Body>>& bodies);
     
     // Integration methods
     void IntegrateEuler(std::vector<std::unique_ptr<Body>>& bodies, float deltaTime);
     void IntegrateLeapfrog(std::vector<std::unique_ptr<Body>>& bodies, float deltaTime);
     void IntegrateVerlet(std::vector<std::unique_ptr<Body>>& bodies, float deltaTime);
+    void IntegrateEventDriven(std::vector<std::unique_ptr<Body>>& bodies, float deltaTime);
+    
+    // Conservation diagnostics
+    void BeginConservationSums();
+    void FinishConservationSums(size_t bodyCount);
+    static void FillConservation(const ConservationSums& sums, EnergyStats& stats);
+    
+    // Close encounters
+    void IntegrateCloseEncounters(std::vector<std::unique_ptr<Body>>& bodies, float deltaTime);
+    glm::vec2 CalculatePairAcceleration(const Body& target, const Body& source) const;
+    
+    // Wisdom-Holman
+    bool IsWisdomHolmanActive(const std::vector<std::unique_ptr<Body>>& bodies) const;
+    void IntegrateWisdomHolman(std::vector<std::unique_ptr<Body>>& bodies, float deltaTime);
     
     // Collision detection
     bool CheckCollision(const Body& a, const Body& b) const;
     void ResolveCollision(Body& a, Body& b);
+    void HandleCollisionsDirect(std::vector<std::unique_ptr<Body>>& bodies);
+    void ResolveTreeContacts(std::vector<std::unique_ptr<Body>>& bodies);
+    void ResolveNeighborContacts(std::vector<std::unique_ptr<Body>>& bodies);
+    void HandleSweptCollisions(std::vector<std::unique_ptr<Body>>& bodies, float deltaTime);
     
     // Adaptive time stepping
     float CalculateAdaptiveTimeStep(const std::vector<std::unique_ptr<Body>>& bodies) const;
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+
+namespace nbody {
+
+/**
+ * @brief Integrates W independent N-body systems at once, one system per SIMD lane
+ *
+ * State is stored as [body][lane] so the innermost loops run across lanes with
+ * unit stride and vectorise (8 doubles fill two AVX2 or one AVX-512 register).
+ * N is a template parameter so the pair loops are fully unrolled.
+ *
+ * Each lane has its own adaptive time step (kick-drift-kick leapfrog with a
+ * step chosen from the shortest free-fall / crossing time of its closest pair)
+ * and its own end time. Finished or disrupted lanes are masked out by giving
+ * them a zero step, so the batch keeps running until every lane is done.
+ * Uses true Newtonian gravity (a = G m / r^2) in double precision.
+ */
+template <int N, int W, typename Real = double>
+class SmallNBatch {
+public:
+    static_assert(N >= 2, "SmallNBatch needs at least two bodies");
+    static_assert(W >= 1, "SmallNBatch needs at least one lane");
+
+    enum LaneStatus : uint8_t {
+        Running = 0,
+        Finished = 1,   // Reached the end time
+        Escaped = 2,    // A body left the escape radius
+        CloseEncounter = 3 // Pair separation fell below the collision radius
+    };
+
+    struct Params {
+        Real G = 1;
+        Real softening = 0;         // Plummer softening length
+        Real eta = 0.01;            // Time step safety factor
+        Real minTimeStep = 1e-9;
+        Real maxTimeStep = 0.01;
+        Real escapeRadius = 0;      // Distance from the centre of mass, 0 disables
+        Real collisionRadius = 0;   // Minimum pair separation, 0 disables
+    };
+
+    alignas(64) Real x[N][W];
+    alignas(64) Real y[N][W];
+    alignas(64) Real vx[N][W];
+    alignas(64) Real vy[N][W];
+    alignas(64) Real ax[N][W];
+    alignas(64) Real ay[N][W];
+    alignas(64) Real m[N][W];
+
+    alignas(64) Real time[W];
+    alignas(64) Real endTime[W];
+    alignas(64) Real minSeparation[W];
+    std::array<uint8_t, W> status;
+    std::array<uint64_t, W> steps;
+
+    SmallNBatch() { Clear(); }
+
+    void Clear() {
+        for (int i = 0; i < N; ++i) {
+            for (int l = 0; l < W; ++l) {
+                x[i][l] = y[i][l] = vx[i][l] = vy[i][l] = ax[i][l] = ay[i][l] = 0;
+                m[i][l] = 0;
+            }
+        }
+        for (int l = 0; l < W; ++l) {
+            time[l] = 0;
+            endTime[l] = 0;
+            minSeparation[l] = std::numeric_limits<Real>::max();
+            status[l] = Finished; // Unused lanes never run
+            steps[l] = 0;
+        }
+    }
+
+    /**
+     * @brief Set the initial state of one body in one lane
+     */
+    void SetBody(int lane, int body, Real px, Real py, Real pvx, Real pvy, Real mass) {
+        x[body][lane] = px;
+        y[body][lane] = py;
+        vx[body][lane] = pvx;
+        vy[body][lane] = pvy;
+        m[body][lane] = mass;
+    }
+
+    /**
+     * @brief Activate a lane and integrate it up to the given time
+     */
+    void StartLane(int lane, Real duration) {
+        time[lane] = 0;
+        endTime[lane] = duration;
+        minSeparation[lane] = std::numeric_limits<Real>::max();
+        status[lane] = Running;
+        steps[lane] = 0;
+    }
+
+    bool AnyRunning() const {
+        for (int l = 0; l < W; ++l) {
+            if (status[l] == Running) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Integrate until every lane is finished or disrupted
+     * @param params Integration parameters shared by all lanes
+     * @param maxSteps Safety limit on batch steps
+     */
+    void Run(const Params& params, uint64_t maxSteps = 100000000ull) {
+        ComputeAccelerations(params);
+        for (uint64_t i = 0; i < maxSteps && AnyRunning(); ++i) {
+            Step(params);
+        }
+    }
+
+    /**
+     * @brief Advance every running lane by its own adaptive step
+     */
+    void Step(const Params& params) {
+        alignas(64) Real dt[W];
+        ComputeTimeSteps(params, dt);
+
+        // Kick (half step)
+        for (int i = 0; i < N; ++i) {
+            #pragma omp simd
+            for (int l = 0; l < W; ++l) {
+                vx[i][l] += ax[i][l] * Real(0.5) * dt[l];
+                vy[i][l] += ay[i][l] * Real(0.5) * dt[l];
+            }
+        }
+
+        // Drift
+        for (int i = 0; i < N; ++i) {
+            #pragma omp simd
+            for (int l = 0; l < W; ++l) {
+                x[i][l] += vx[i][l] * dt[l];
+                y[i][l] += vy[i][l] * dt[l];
+            }
+        }
+
+        ComputeAccelerations(params);
+
+        // Kick (half step)
+        for (int i = 0; i < N; ++i) {
+            #pragma omp simd
+            for (int l = 0; l < W; ++l) {
+                vx[i][l] += ax[i][l] * Real(0.5) * dt[l];
+                vy[i][l] += ay[i][l] * Real(0.5) * dt[l];
+            }
+        }
+
+        #pragma omp simd
+        for (int l = 0; l < W; ++l) {
+            time[l] += dt[l];
+        }
+
+        UpdateStatus(params);
+    }
+
+    /**
+     * @brief Total energy of every lane
+     */
+    void ComputeEnergy(const Params& params, Real* energy) const {
+        const Real eps2 = params.softening * params.softening;
+
+        #pragma omp simd
+        for (int l = 0; l < W; ++l) {
+            energy[l] = 0;
+        }
+
+        for (int i = 0; i < N; ++i) {
+            #pragma omp simd
+            for (int l = 0; l < W; ++l) {
+                energy[l] += Real(0.5) * m[i][l] * (vx[i][l] * vx[i][l] + vy[i][l] * vy[i][l]);
+            }
+            for (int j = i + 1; j < N; ++j) {
+                #pragma omp simd
+                for (int l = 0; l < W; ++l) {
+                    Real dx = x[j][l] - x[i][l];
+                    Real dy = y[j][l] - y[i][l];
+                    Real r = std::sqrt(dx * dx + dy * dy + eps2);
+                    energy[l] -= params.G * m[i][l] * m[j][l] / r;
+                }
+            }
+        }
+    }
+
+private:
+    void ComputeAccelerations(const Params& params) {
+        const Real eps2 = params.softening * params.softening;
+
+        for (int i = 0; i < N; ++i) {
+            #pragma omp simd
+            for (int l = 0; l < W; ++l) {
+                ax[i][l] = 0;
+                ay[i][l] = 0;
+            }
+        }
+
+        // Each pair once, applied to both bodies
+        for (int i = 0; i < N; ++i) {
+            for (int j = i + 1; j < N; ++j) {
+                #pragma omp simd
+                for (int l = 0; l < W; ++l) {
+                    Real dx = x[j][l] - x[i][l];
+                    Real dy = y[j][l] - y[i][l];
+                    Real r2 = dx * dx + dy * dy + eps2;
+                    Real invR = Real(1) / std::sqrt(r2);
+                    Real invR3 = params.G * invR * invR * invR;
+                    ax[i][l] += m[j][l] * dx * invR3;
+                    ay[i][l] += m[j][l] * dy * invR3;
+                    ax[j][l] -= m[i][l] * dx * invR3;
+                    ay[j][l] -= m[i][l] * dy * invR3;
+                }
+            }
+        }
+    }
+
+    void ComputeTimeSteps(const Params& params, Real* dt) const {
+        alignas(64) Real shortest[W];
+
+        #pragma omp simd
+        for (int l = 0; l < W; ++l) {
+            shortest[l] = std::numeric_limits<Real>::max();
+        }
+
+        // Shortest of the free-fall time sqrt(r^3 / G M) and crossing time r / |v| over all pairs
+        for (int i = 0; i < N; ++i) {
+            for (int j = i + 1; j < N; ++j) {
+                #pragma omp simd
+                for (int l = 0; l < W; ++l) {
+                    Real dx = x[j][l] - x[i][l];
+                    Real dy = y[j][l] - y[i][l];
+                    Real dvx = vx[j][l] - vx[i][l];
+                    Real dvy = vy[j][l] - vy[i][l];
+                    Real r2 = dx * dx + dy * dy + params.softening * params.softening;
+                    Real v2 = dvx * dvx + dvy * dvy;
+                    Real mass = params.G * (m[i][l] + m[j][l]);
+                    Real freeFall2 = r2 * std::sqrt(r2) / std::max(mass, std::numeric_limits<Real>::min());
+                    Real crossing2 = r2 / std::max(v2, std::numeric_limits<Real>::min());
+                    shortest[l] = std::min(shortest[l], std::min(freeFall2, crossing2));
+                }
+            }
+        }
+
+        for (int l = 0; l < W; ++l) {
+            Real step = params.eta * std::sqrt(shortest[l]);
+            step = std::clamp(step, params.minTimeStep, params.maxTimeStep);
+            step = std::min(step, endTime[l] - time[l]);
+            dt[l] = status[l] == Running ? std::max(step, Real(0)) : Real(0); // Lane mask
+        }
+    }
+
+    void UpdateStatus(const Params& params) {
+        const Real escape2 = params.escapeRadius * params.escapeRadius;
+        const Real collision2 = params.collisionRadius * params.collisionRadius;
+
+        alignas(64) Real closest2[W];
+        alignas(64) Real farthest2[W];
+        alignas(64) Real comX[W];
+        alignas(64) Real comY[W];
+        alignas(64) Real totalMass[W];
+
+        #pragma omp simd
+        for (int l = 0; l < W; ++l) {
+            closest2[l] = std::numeric_limits<Real>::max();
+            farthest2[l] = 0;
+            comX[l] = comY[l] = totalMass[l] = 0;
+        }
+
+        for (int i = 0; i < N; ++i) {
+            #pragma omp simd
+            for (int l = 0; l < W; ++l) {
+                comX[l] += m[i][l] * x[i][l];
+                comY[l] += m[i][l] * y[i][l];
+                totalMass[l] += m[i][l];
+            }
+            for (int j = i + 1; j < N; ++j) {
+                #pragma omp simd
+                for (int l = 0; l < W; ++l) {
+                    Real dx = x[j][l] - x[i][l];
+                    Real dy = y[j][l] - y[i][l];
+                    closest2[l] = std::min(closest2[l], dx * dx + dy * dy);
+                }
+            }
+        }
+
+        for (int i = 0; i < N; ++i) {
+            #pragma omp simd
+            for (int l = 0; l < W; ++l) {
+                Real dx = x[i][l] - comX[l] / totalMass[l];
+                Real dy = y[i][l] - comY[l] / totalMass[l];
+                farthest2[l] = std::max(farthest2[l], dx * dx + dy * dy);
+            }
+        }
+
+        for (int l = 0; l < W; ++l) {
+            if (status[l] != Running) continue;
+
+            steps[l]++;
+            minSeparation[l] = std::min(minSeparation[l], std::sqrt(closest2[l]));
+
+            if (params.collisionRadius > 0 && closest2[l] < collision2) {
+                status[l] = CloseEncounter;
+            } else if (params.escapeRadius > 0 && farthest2[l] > escape2) {
+                status[l] = Escaped;
+            } else if (time[l] >= endTime[l]) {
+                status[l] = Finished;
+            }
+        }
+    }
+};
+
+} // namespace nbody
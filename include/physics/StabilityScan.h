@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace nbody {
+
+/**
+ * @brief Configuration for a Monte Carlo stability scan of a few-body system
+ */
+struct StabilityScanConfig {
+    std::string preset = "figure8";     // "figure8" or "triple"
+    int samples = 1024;                 // Perturbed variants to integrate
+    double amplitude = 1e-3;            // Standard deviation of position/velocity perturbations
+    double duration = 100.0;            // Integration time per variant (figure-eight period ~6.33)
+    double eta = 0.01;                  // Adaptive time step safety factor
+    double maxTimeStep = 0.01;
+    double escapeFactor = 5.0;          // Escape radius relative to the initial system size
+    double collisionRadius = 1e-3;      // Close encounters below this separation end a variant
+    uint32_t seed = 1;
+    int threads = 0;                    // 0 = all cores
+    std::string output = "stability_scan.csv";
+};
+
+/**
+ * @brief Outcome of one perturbed variant
+ */
+struct StabilitySample {
+    int index = 0;
+    double perturbation = 0.0;          // RMS of the applied perturbation
+    int status = 0;                     // SmallNBatch lane status
+    double survivalTime = 0.0;
+    double energyError = 0.0;           // |E - E0| / |E0|
+    double minSeparation = 0.0;
+    uint64_t steps = 0;
+};
+
+/**
+ * @brief Runs many perturbed copies of a three-body preset through the SIMD batch integrator
+ *
+ * Variants are packed SCAN_LANES at a time into SmallNBatch lanes and the
+ * batches are distributed over cores with OpenMP.
+ */
+class StabilityScan {
+public:
+    explicit StabilityScan(const StabilityScanConfig& config) : m_config(config) {}
+
+    /**
+     * @brief Integrate all variants
+     * @return False if the preset is unknown
+     */
+    bool Run();
+
+    /**
+     * @brief Write per-variant results as CSV
+     */
+    bool WriteResults(const std::string& filename) const;
+
+    const std::vector<StabilitySample>& GetSamples() const { return m_samples; }
+    double GetWallTime() const { return m_wallTime; }
+    uint64_t GetTotalSteps() const { return m_totalSteps; }
+
+    /**
+     * @brief Entry point for the headless "--stability-scan [key=value ...]" mode
+     * @return Process exit code
+     */
+    static int RunFromCommandLine(int argc, char** argv, int firstArg);
+
+    static constexpr int SCAN_LANES = 8;
+
+private:
+    StabilityScanConfig m_config;
+    std::vector<StabilitySample> m_samples;
+    double m_wallTime = 0.0;            // ms
+    uint64_t m_totalSteps = 0;
+};
+
+} // namespace nbody
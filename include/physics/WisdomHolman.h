@@ -0,0 +1,79 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+
+namespace nbody {
+
+class Body;
+
+/**
+ * @brief Wisdom-Holman symplectic map for systems dominated by one central mass
+ *
+ * Uses democratic heliocentric coordinates: heliocentric positions, barycentric
+ * velocities. Each step is kick (planet-planet) / linear drift (central body
+ * recoil) / Kepler drift / linear drift / kick, with the Kepler drift solved
+ * analytically in universal variables. The error scales with the planet to
+ * central mass ratio rather than the step size, so steps can be a sizeable
+ * fraction of the shortest orbit instead of a tiny one.
+ */
+class WisdomHolmanIntegrator {
+public:
+    struct Settings {
+        float G = 1.0f;
+        float softeningLength = 0.1f;   // Used for planet-planet kicks only
+        float dampingFactor = 1.0f;
+        float orbitFraction = 0.05f;    // Largest step as a fraction of the shortest local orbital period
+        float minMassRatio = 10.0f;     // Central mass must exceed the rest of the system by this factor
+    };
+
+    /**
+     * @brief Check whether the system has a dominant body the map can be built around
+     */
+    bool IsApplicable(const std::vector<std::unique_ptr<Body>>& bodies, const Settings& settings) const;
+
+    /**
+     * @brief Advance all bodies by deltaTime, subdividing as needed
+     * @return False (and bodies untouched) if the system is not applicable
+     */
+    bool Step(std::vector<std::unique_ptr<Body>>& bodies, const Settings& settings, float deltaTime);
+
+    int GetSubstepCount() const { return m_substeps; }
+    int GetInteractionCount() const { return m_interactions; }
+    void Clear();
+
+    /**
+     * @brief Advance a Kepler orbit by deltaTime with a universal-variable solver
+     * @param position Position relative to the central mass, updated in place
+     * @param velocity Velocity relative to the central mass, updated in place
+     * @param mu Gravitational parameter G * M
+     * @return False if the solver did not converge (state is left unchanged)
+     */
+    static bool SolveKepler(glm::dvec2& position, glm::dvec2& velocity, double mu, double deltaTime);
+
+private:
+    int FindCentralBody(const std::vector<std::unique_ptr<Body>>& bodies, const Settings& settings) const;
+    void LoadState(const std::vector<std::unique_ptr<Body>>& bodies);
+    void StoreState(std::vector<std::unique_ptr<Body>>& bodies);
+    void Kick(const Settings& settings, double deltaTime);
+
+    // Double precision copy of the inertial state, reused while the bodies are untouched
+    std::vector<const Body*> m_cachedBodies;
+    std::vector<glm::dvec2> m_positions;
+    std::vector<glm::dvec2> m_velocities;
+    std::vector<glm::vec2> m_writtenPositions;
+    std::vector<glm::vec2> m_writtenVelocities;
+    std::vector<double> m_masses;
+
+    // Democratic heliocentric working state, central body excluded
+    std::vector<glm::dvec2> m_heliocentric;
+    std::vector<glm::dvec2> m_barycentric;
+    std::vector<glm::dvec2> m_accelerations;
+    std::vector<double> m_planetMasses;
+
+    int m_substeps = 0;
+    int m_interactions = 0;
+};
+
+} // namespace nbody
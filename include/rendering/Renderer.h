@@ -10,12 +10,16 @@
 #include <unordered_map>
 #include <algorithm> // For std::max
 #include <chrono>
+#include <cstdint>
+#include <cmath>
+#include "core/BuildStamp.h"
 
 namespace nbody {
 
 class Body;
 class PhysicsEngine;
 struct QuadTreeNode;
+struct KDTreeNode;
 
 /**
  * @brief Camera for 2D rendering
@@ -39,6 +43,8 @@ struct Camera {
     
     void Update(float /*deltaTime*/) {
         zoom += (targetZoom - zoom) * zoomSpeed;
+        // Settle exactly, so a camera at rest leaves view-dependent data alone
+        if (std::abs(targetZoom - zoom) <= targetZoom * 1e-4f) zoom = targetZoom;
         zoom = std::max(0.0001f, zoom); // Ensure zoom never goes below minimum
     }
 };
@@ -115,6 +121,15 @@ public:
     RenderStats Render(const std::vector<std::unique_ptr<Body>>& bodies,
                       const PhysicsEngine& physics,
                       const Body* selectedBody = nullptr);
+    
+    /**
+     * @brief Generation of the bodies passed to the next Render()
+     *
+     * Bumped by the caller whenever bodies move, appear, disappear or are
+     * edited. Instances, trails, force vectors and the quadtree overlay are
+     * only rebuilt and uploaded when it (or the camera they depend on) moved on.
+     */
+    void SetStateGeneration(uint64_t generation) { m_stateGeneration = generation; }
 
     /**
      * @brief Handle window resize
@@ -139,6 +154,7 @@ public:
     // Coordinate conversion
     glm::vec2 ScreenToWorld(const glm::vec2& screenPos) const;
     glm::vec2 WorldToScreen(const glm::vec2& worldPos) const;
+    void GetVisibleWorldBounds(glm::vec2& minimum, glm::vec2& maximum) const;
     
     // Rendering options
     void SetShowTrails(bool show) { m_showTrails = show; }
@@ -153,6 +169,43 @@ public:
     bool GetShowQuadTree() const { return m_showQuadTree; }
     bool GetShowUI() const { return m_showUI; }
     
+    /**
+     * @brief Draw bodies with per-body colors instead of their own (e.g. by group)
+     *
+     * Ignored while the body count does not match the number of colors.
+     */
+    void SetBodyColorOverride(std::vector<glm::vec3> colors) {
+        m_bodyColorOverride = std::move(colors);
+        ++m_appearanceGeneration;
+    }
+    void ClearBodyColorOverride() {
+        if (m_bodyColorOverride.empty()) return;
+        m_bodyColorOverride.clear();
+        ++m_appearanceGeneration;
+    }
+    
+    /**
+     * @brief Draw a predicted path as a polyline that fades out towards its end
+     */
+    void SetPredictedPath(std::vector<glm::vec2> path, const glm::vec3& color) {
+        m_predictedPath = std::move(path);
+        m_predictedPathColor = color;
+        m_predictedPathDirty = true;
+    }
+    void ClearPredictedPath() { m_predictedPath.clear(); }
+    
+    /**
+     * @brief Draw contour lines behind the bodies, shallow levels cool and deep levels warm
+     * @param segments Line segment endpoints, two per segment
+     * @param levelOffsets Segments of level i are [levelOffsets[i], levelOffsets[i + 1]) vertices
+     */
+    void SetFieldContours(std::vector<glm::vec2> segments, std::vector<uint32_t> levelOffsets) {
+        m_fieldSegments = std::move(segments);
+        m_fieldLevelOffsets = std::move(levelOffsets);
+        m_fieldContoursDirty = true;
+    }
+    void ClearFieldContours() { m_fieldSegments.clear(); m_fieldLevelOffsets.clear(); }
+    
     // Utility
     void FitAllBodies(const std::vector<std::unique_ptr<Body>>& bodies);
     void CenterOnBody(const Body* body);
@@ -193,12 +246,39 @@ private:
     GLuint m_quadTreeVAO = 0;
     GLuint m_quadTreeVBO = 0;
     
+    GLuint m_predictionVAO = 0;
+    GLuint m_predictionVBO = 0;
+    
+    GLuint m_fieldVAO = 0;
+    GLuint m_fieldVBO = 0;
+    
     // Rendering options
     bool m_showTrails = true;
     bool m_showGrid = false;
     bool m_showForces = false;
     bool m_showQuadTree = false;
     bool m_showUI = true;
+    std::vector<glm::vec3> m_bodyColorOverride;
+    std::vector<glm::vec2> m_predictedPath;
+    glm::vec3 m_predictedPathColor{1.0f};
+    std::vector<glm::vec2> m_fieldSegments;
+    std::vector<uint32_t> m_fieldLevelOffsets;
+    bool m_fieldContoursDirty = false;
+    bool m_predictedPathDirty = false;
+    
+    // Input generations, and the ones each derived buffer was built from
+    uint64_t m_stateGeneration = 0;
+    uint64_t m_appearanceGeneration = 1;    // Color override and selection
+    uint64_t m_cameraGeneration = 1;        // Position, zoom and window size
+    const Body* m_lastSelectedBody = nullptr;
+    glm::vec2 m_lastCameraPosition{0.0f};
+    float m_lastCameraZoom = 0.0f;
+    glm::ivec2 m_lastWindowSize{0};
+    BuildStamp m_instanceStamp;
+    BuildStamp m_trailStamp;
+    BuildStamp m_gridStamp;
+    BuildStamp m_forceStamp;
+    BuildStamp m_quadTreeStamp;
     
     // Performance tracking
     RenderStats m_stats;
@@ -221,6 +301,12 @@ private:
     
     std::vector<BodyInstance> m_bodyInstances;
     std::vector<glm::vec2> m_trailVertices;
+    struct TrailBatch {
+        GLint first;
+        GLsizei count;
+        glm::vec3 color;
+    };
+    std::vector<TrailBatch> m_trailBatches;     // One line list per body with a trail
     std::vector<glm::vec2> m_gridVertices;
     std::vector<glm::vec2> m_forceVertices;
     std::vector<glm::vec2> m_quadTreeVertices;
@@ -237,15 +323,19 @@ private:
     void UpdateForceVertices(const std::vector<std::unique_ptr<Body>>& bodies,
                            const PhysicsEngine& physics);
     void UpdateQuadTreeVertices(const QuadTreeNode* root);
+    void UpdateKDTreeVertices(const std::vector<KDTreeNode>& nodes);
     
     void RenderBodies();
     void RenderTrails(const std::vector<std::unique_ptr<Body>>& bodies);
     void RenderGrid();
     void RenderForces(const std::vector<std::unique_ptr<Body>>& bodies, const PhysicsEngine& physics);
     void RenderQuadTree(const PhysicsEngine& physics);
+    void RenderPredictedPath();
+    void RenderFieldContours();
     
     void StartTimer();
     void EndTimer();
+    void TrackCameraChanges();
     
     // Utility
     void CheckGLError(const std::string& operation) const;
@@ -255,9 +345,11 @@ private:
     // Constants
     static constexpr int MAX_BODIES = 1000000;
     static constexpr int MAX_TRAIL_POINTS = 10000;
+    static constexpr int MAX_KD_TREE_DRAW_DEPTH = 16;  // Two KD levels split about as much as one quadtree level
     static constexpr int CIRCLE_SEGMENTS = 32;
     static constexpr float GRID_SPACING = 1.0f;
     static constexpr float FORCE_SCALE = 0.1f;
+    static constexpr int PREDICTION_FADE_BANDS = 16;
 };
 
 } // namespace nbody
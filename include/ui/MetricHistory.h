@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace nbody {
+
+/**
+ * @brief Time series with full detail for recent samples and coarser detail further back
+ *
+ * Level 0 is a ring of the newest raw samples. Every FAN_IN buckets written
+ * to a level are also merged into one min/max/mean bucket on the next level,
+ * whose ring therefore reaches FAN_IN times further back at a quarter of the
+ * resolution. The last level never drops anything: when it fills up,
+ * neighbouring buckets are merged in pairs. Memory stays fixed however long
+ * the session runs, and the whole run can always be plotted.
+ */
+class MetricHistory {
+public:
+    /**
+     * @brief Aggregate of the samples that fall into one plot column
+     */
+    struct Column {
+        float minimum = 0.0f;
+        float maximum = 0.0f;
+        float mean = 0.0f;
+        bool valid = false;             // False if no sample falls into the column
+    };
+
+    explicit MetricHistory(size_t bucketsPerLevel = 512, int levels = 8);
+
+    void Add(double time, float value);
+    void Clear();
+
+    bool IsEmpty() const { return m_count == 0; }
+    uint64_t GetSampleCount() const { return m_count; }
+    double GetStartTime() const { return m_startTime; }
+    double GetEndTime() const { return m_endTime; }
+    float GetLatest() const { return m_latest; }
+
+    /**
+     * @brief Min/max decimate the samples in [start, end] into columns.size() equal columns
+     *
+     * Every column takes its samples from the finest level that still holds
+     * them, so recent columns are exact and old ones come from coarse buckets.
+     */
+    void Resample(double start, double end, std::vector<Column>& columns) const;
+
+private:
+    struct Bucket {
+        double start = 0.0;             // Time of the first and last sample
+        double end = 0.0;
+        double sum = 0.0;
+        float minimum = 0.0f;
+        float maximum = 0.0f;
+        uint32_t count = 0;
+
+        void Merge(const Bucket& other);
+    };
+
+    struct Level {
+        std::vector<Bucket> buckets;    // Ring on lower levels, oldest-first list on the last
+        size_t next = 0;                // Ring slot written next
+        size_t size = 0;
+        Bucket pending;                 // Merge of the buckets since the last one passed up
+        uint64_t pendingInputs = 0;
+    };
+
+    void Push(size_t level, const Bucket& bucket);
+    void CompactLastLevel();
+    template <typename Function>
+    void ForEachBucket(const Level& level, Function&& function) const;
+
+    std::vector<Level> m_levels;
+    size_t m_capacity;
+    uint64_t m_lastLevelFanIn = 1;      // Inputs per last-level bucket, doubled by every compaction
+    uint64_t m_count = 0;
+    double m_startTime = 0.0;
+    double m_endTime = 0.0;
+    float m_latest = 0.0f;
+
+    static constexpr uint64_t FAN_IN = 4;
+};
+
+} // namespace nbody
@@ -11,6 +11,12 @@
 #include <functional>
 #include <memory>
 #include <chrono>
+#include "core/CheckpointManager.h"
+#include "analysis/AnalysisModule.h"
+#include "analysis/FriendsOfFriends.h"
+#include "analysis/BodyTable.h"
+#include "ui/MetricHistory.h"
+#include "core/IncrementalJob.h"
 
 namespace nbody {
 
@@ -102,6 +108,8 @@ public:
     float GetSpawnMass() const { return m_spawnMass; }
     float GetSpawnSpeed() const { return m_spawnSpeed; }
     int GetSpawnPattern() const { return m_spawnPattern; }
+    uint32_t GetSpawnSeed() const { return static_cast<uint32_t>(m_spawnSeed); }
+    void SetSpawnSeed(uint32_t seed) { m_spawnSeed = static_cast<int>(seed & 0x7fffffff); }
     
     // Physics parameters
     float GetGravitationalConstant() const { return m_gravitationalConstant; }
@@ -110,8 +118,16 @@ public:
     float GetSofteningLength() const { return m_softeningLength; }
     bool GetUseBarnesHut() const { return m_useBarnesHut; }
     float GetBarnesHutTheta() const { return m_barnesHutTheta; }
+    bool GetUseKDTree() const { return m_useKDTree; }
     bool GetEnableCollisions() const { return m_enableCollisions; }
+    bool GetTreeCollisions() const { return m_treeCollisions; }
+    bool GetUseEventDriven() const { return m_useEventDriven; }
+    bool GetContinuousCollisions() const { return m_continuousCollisions; }
+    bool GetUseNeighborLists() const { return m_useNeighborLists; }
+    float GetNeighborSkin() const { return m_neighborSkin; }
     float GetRestitution() const { return m_restitution; }
+    bool GetRegularizeCloseEncounters() const { return m_regularizeCloseEncounters; }
+    bool GetUseWisdomHolman() const { return m_useWisdomHolman; }
     
     // GPU settings
     void SetGPUAvailable(bool available) { m_gpuAvailable = available; }
@@ -122,6 +138,88 @@ public:
     glm::vec2 GetCameraPosition() const { return m_cameraPosition; }
     float GetCameraZoom() const { return m_cameraZoom; }
     
+    // Rewind buffer state
+    void SetRewindState(int frameCount, int currentFrame, size_t memoryBytes) {
+        m_rewindFrameCount = frameCount;
+        m_rewindFrame = currentFrame;
+        m_rewindMemoryBytes = memoryBytes;
+    }
+    
+    // Shared memory publishing state
+    void SetSharedStateStatus(bool publishing, uint64_t framesPublished) {
+        m_publishSharedState = publishing;
+        m_sharedFramesPublished = framesPublished;
+    }
+    
+    void SetCheckpointStatus(const CheckpointStatus& status, float autoInterval) {
+        m_checkpointStatus = status;
+        m_checkpointInterval = autoInterval;
+    }
+    
+    // In-situ analysis state
+    void SetAnalysisStatus(bool running, uint64_t completed, uint64_t dropped, double lastMs,
+                           std::vector<AnalysisResult> results) {
+        m_analysisEnabled = running;
+        m_analysisCompleted = completed;
+        m_analysisDropped = dropped;
+        m_analysisLastMs = lastMs;
+        m_analysisResults = std::move(results);
+    }
+    
+    // Group finder state
+    void SetGroupFinderStatus(size_t groupCount, int ungroupedCount, double lastMs, std::vector<FoFGroup> largestGroups) {
+        m_groupCount = groupCount;
+        m_ungroupedCount = ungroupedCount;
+        m_groupFinderMs = lastMs;
+        m_largestGroups = std::move(largestGroups);
+    }
+    
+    // Predicted orbit state
+    void SetOrbitPredictionStatus(size_t points, size_t sources, double lastMs) {
+        m_predictionPoints = points;
+        m_predictionSources = sources;
+        m_predictionMs = lastMs;
+    }
+    
+    // Body table rows, sorted in the background
+    void SetBodyTableRows(BodyTableRows rows) {
+        m_bodyTableRows = std::move(rows);
+        m_bodyTableCheckedCount = m_bodyTableRows.total;
+    }
+    
+    // Simulated time per wall-clock second, and fast forward toggled by the keyboard
+    void SetSimulationRate(double simulationRate, double stepsPerSecond) {
+        m_simulationRate = simulationRate;
+        m_stepsPerSecond = stepsPerSecond;
+    }
+    void SetFastForward(bool enabled) { m_fastForward = enabled; }
+    
+    // Energy of the last finished energy job, taken from the bodies at the given step and simulated time
+    void SetEnergyStats(const EnergyStats& stats, uint64_t step, double simulationTime);
+    
+    // Energy history restarts with the simulation
+    void ResetEnergyHistory() {
+        m_energyHistory.Clear();
+        m_hasEnergy = false;
+    }
+    
+    // Progress of the periodic jobs spread over frames
+    void SetJobStatus(std::vector<JobStatus> jobs) { m_jobStatus = std::move(jobs); }
+    
+    // Potential field overlay state
+    void SetFieldOverlayStatus(size_t samples, int refinementLevel, double lastMs) {
+        m_fieldSamples = samples;
+        m_fieldRefinementLevel = refinementLevel;
+        m_fieldMs = lastMs;
+    }
+    
+    // Preset cache state
+    void SetPresetCacheStatus(int hits, double lastLoadMs, uint64_t diskBytes) {
+        m_presetCacheHits = hits;
+        m_presetCacheLoadMs = lastLoadMs;
+        m_presetCacheBytes = diskBytes;
+    }
+    
     // Callbacks for UI events
     std::function<void()> OnPlayPause;
     std::function<void()> OnReset;
@@ -136,9 +234,24 @@ public:
     std::function<void()> OnResetCamera;
     std::function<void()> OnFitAllBodies;
     std::function<void(int, int)> OnSpawnBodies;  // (count, pattern)
+    std::function<void(bool)> OnPresetCacheChanged; // Enable/disable the generated body cache
+    std::function<void()> OnClearPresetCache;
     std::function<void(const glm::vec2&)> OnSetCameraPosition;
     std::function<void(float)> OnSetCameraZoom;
     std::function<void()> OnRunBenchmark;  // Performance benchmarking callback
+    std::function<void(int)> OnRewindToFrame;  // Restore a frame from the rewind buffer
+    std::function<void()> OnCheckpoint;        // Write a checkpoint now
+    std::function<void()> OnRestoreCheckpoint; // Load the newest checkpoint
+    std::function<void(float)> OnCheckpointIntervalChanged; // Auto checkpoint period in seconds, 0 = off
+    std::function<void(bool, int)> OnSharedStateChanged;    // (publish enabled, steps between frames)
+    std::function<void(bool, int)> OnAnalysisChanged;       // (analysis enabled, steps between snapshots)
+    std::function<void(bool, const FoFConfig&, int, bool)> OnGroupFinderChanged; // (enabled, config, steps between passes, color by group)
+    std::function<void(bool, float)> OnOrbitPredictionChanged; // (enabled, simulation time to look ahead)
+    std::function<void(bool, int)> OnFieldOverlayChanged;      // (enabled, contour levels)
+    std::function<void(bool, const BodyTableQuery&)> OnBodyTableChanged; // (window open, query)
+    std::function<void(size_t)> OnSelectBody;                  // Select and center on bodies[index]
+    std::function<void(bool)> OnFastForwardChanged;
+    std::function<void(float)> OnJobBudgetChanged;   // Milliseconds per frame for periodic jobs
     
 private:
     // Window state
@@ -158,6 +271,7 @@ private:
     bool m_showDebugWindow = false;
     bool m_showAboutWindow = false;
     bool m_showBarnesHutWindow = false;
+    bool m_showBodyTableWindow = false;
     
     // Simulation controls
     bool m_orbitMode = false;
@@ -183,6 +297,13 @@ private:
     float m_spawnMass = 1.0f;
     float m_spawnSpeed = 5.0f;
     int m_spawnPattern = 0;  // 0=Random, 1=Circle, 2=Grid, 3=Spiral
+    int m_spawnSeed = 1;
+    
+    // Preset cache
+    bool m_usePresetCache = true;
+    int m_presetCacheHits = 0;
+    double m_presetCacheLoadMs = 0.0;
+    uint64_t m_presetCacheBytes = 0;
     
     // Physics settings
     float m_gravitationalConstant = 10.0f;
@@ -191,22 +312,95 @@ private:
     float m_softeningLength = 1.0f;
     bool m_useBarnesHut = true;
     float m_barnesHutTheta = 0.5f;
+    bool m_useKDTree = false;
     bool m_enableCollisions = true;
+    bool m_treeCollisions = true;
+    bool m_useNeighborLists = true;
+    bool m_continuousCollisions = false;
+    bool m_useEventDriven = false;
+    float m_neighborSkin = 2.0f;
     float m_restitution = 0.8f;
+    bool m_regularizeCloseEncounters = true;
+    bool m_useWisdomHolman = false;
     bool m_useGPU = false;
     bool m_gpuAvailable = false; // Track GPU availability
     
+    // Rewind state
+    int m_rewindFrameCount = 0;
+    int m_rewindFrame = 0;
+    size_t m_rewindMemoryBytes = 0;
+    
+    // Checkpoint state
+    CheckpointStatus m_checkpointStatus;
+    float m_checkpointInterval = 0.0f;
+    
+    // Shared memory publishing
+    bool m_publishSharedState = false;
+    int m_sharedStateInterval = 1;
+    uint64_t m_sharedFramesPublished = 0;
+    
+    // In-situ analysis
+    bool m_analysisEnabled = false;
+    int m_analysisInterval = 100;
+    uint64_t m_analysisCompleted = 0;
+    uint64_t m_analysisDropped = 0;
+    double m_analysisLastMs = 0.0;
+    std::vector<AnalysisResult> m_analysisResults;
+    
+    // Friends-of-friends group finder
+    bool m_groupFinderEnabled = false;
+    FoFConfig m_groupFinderConfig;
+    int m_groupFinderInterval = 10;
+    bool m_colorByGroup = true;
+    size_t m_groupCount = 0;
+    int m_ungroupedCount = 0;
+    double m_groupFinderMs = 0.0;
+    std::vector<FoFGroup> m_largestGroups;
+    
+    // Predicted orbit overlay
+    bool m_predictOrbit = false;
+    float m_predictionHorizon = DEFAULT_PREDICTION_HORIZON;
+    size_t m_predictionPoints = 0;
+    size_t m_predictionSources = 0;
+    double m_predictionMs = 0.0;
+    
+    // Fast forward and throughput
+    bool m_fastForward = false;
+    double m_simulationRate = 0.0;
+    double m_stepsPerSecond = 0.0;
+    
+    // Energy job results and job progress
+    double m_kineticEnergy = 0.0;
+    double m_potentialEnergy = 0.0;
+    double m_totalEnergy = 0.0;
+    uint64_t m_energyStep = 0;
+    bool m_hasEnergy = false;
+    std::vector<JobStatus> m_jobStatus;
+    float m_jobBudgetMs = static_cast<float>(JobScheduler::DEFAULT_SLICE_MS);
+    
+    // Body table
+    bool m_bodyTableActive = false;     // Window state last reported through OnBodyTableChanged
+    BodyTableQuery m_bodyTableQuery;
+    float m_bodyTableMax = 0.0f;        // 0 = no upper bound
+    BodyTableRows m_bodyTableRows;
+    size_t m_bodyTableCheckedCount = 0; // Body count the row indices are known to be in range of
+    
+    // Potential field overlay
+    bool m_showPotentialField = false;
+    int m_fieldContourLevels = DEFAULT_FIELD_CONTOUR_LEVELS;
+    size_t m_fieldSamples = 0;
+    int m_fieldRefinementLevel = 0;
+    double m_fieldMs = 0.0;
+    
     // Rendering settings
     float m_cameraZoom = 0.0f;
     glm::vec2 m_cameraPosition{0.0f};
     
-    // Performance tracking
-    std::vector<float> m_fpsHistory;
-    std::vector<float> m_energyHistory;
-    size_t m_maxHistorySize = 100;
-    
-    // Energy tracking
-    size_t m_energyHistoryIndex = 0;
+    // Performance and energy tracking over the whole session
+    MetricHistory m_fpsHistory;         // By wall-clock time
+    MetricHistory m_energyHistory;      // By simulated time, so fast forward doesn't squeeze it
+    int m_historySpan = 0;              // Index into HISTORY_SPANS
+    std::vector<MetricHistory::Column> m_plotColumns;
     
     // File dialog state
     std::string m_configFilename = "config.json";
@@ -221,6 +415,7 @@ private:
                          const PhysicsEngine& physics,
                          const Renderer& renderer);
     void RenderBodyPanel(const Body* selectedBody);
+    void RenderBodyTablePanel(const std::vector<std::unique_ptr<Body>>& bodies, const Body* selectedBody);
     void RenderDebugPanel();
     void RenderAboutPanel();
     void RenderBarnesHutPanel(const std::vector<std::unique_ptr<Body>>& bodies,
@@ -232,6 +427,8 @@ private:
     void ShowRenderStats(const RenderStats& stats);
     void ShowPerformanceGraph();
     void ShowEnergyGraph();
+    void ShowHistorySpanSelector(const char* id, bool simulatedTime);
+    void PlotHistory(const char* id, const MetricHistory& history, float height, const char* format);
     
     // Preset management
     void ShowPresetButtons();
@@ -271,8 +468,16 @@ private:
     static constexpr float DEFAULT_SOFTENING_LENGTH = 0.1f;
     static constexpr bool DEFAULT_USE_BARNES_HUT = true;
     static constexpr float DEFAULT_BARNES_HUT_THETA = 0.7f;
+    static constexpr bool DEFAULT_USE_KD_TREE = false;
     static constexpr bool DEFAULT_ENABLE_COLLISIONS = true;
+    static constexpr bool DEFAULT_TREE_COLLISIONS = true;
+    static constexpr bool DEFAULT_USE_NEIGHBOR_LISTS = true;
+    static constexpr bool DEFAULT_CONTINUOUS_COLLISIONS = false;
+    static constexpr bool DEFAULT_USE_EVENT_DRIVEN = false;
+    static constexpr float DEFAULT_NEIGHBOR_SKIN = 2.0f;
     static constexpr float DEFAULT_RESTITUTION = 0.8f;
+    static constexpr bool DEFAULT_REGULARIZE_CLOSE_ENCOUNTERS = true;
+    static constexpr bool DEFAULT_USE_WISDOM_HOLMAN = false;
     static constexpr bool DEFAULT_USE_GPU = false;
     
     // Default body creation values
@@ -281,6 +486,15 @@ private:
     static constexpr float DEFAULT_SPAWN_MASS = 1.0f;
     static constexpr float DEFAULT_SPAWN_SPEED = 5.0f;
     static constexpr int DEFAULT_SPAWN_COUNT = 100;
+    static constexpr int DEFAULT_SPAWN_SEED = 1;
+    
+    // Default visualization values
+    static constexpr float DEFAULT_PREDICTION_HORIZON = 20.0f;
+    static constexpr int DEFAULT_FIELD_CONTOUR_LEVELS = 16;
+    
+    // Time spans the history plots can show, in seconds; 0 = whole session
+    static constexpr int HISTORY_SPAN_COUNT = 4;
+    static constexpr double HISTORY_SPANS[HISTORY_SPAN_COUNT] = {60.0, 600.0, 3600.0, 0.0};
 };
 
 } // namespace nbody
@@ -0,0 +1,102 @@
+#include "analysis/AnalysisModule.h"
+#include "analysis/WorkerPool.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+namespace nbody {
+
+AnalysisContext::AnalysisContext(const SimulationSnapshot& snapshot, WorkerPool& pool) : m_snapshot(snapshot) {
+    const size_t count = snapshot.size();
+    if (count == 0) return;
+
+    // Mass-weighted sums, one partial per chunk
+    struct Partial {
+        double mass = 0.0;
+        glm::dvec2 position{0.0};
+        glm::dvec2 velocity{0.0};
+    };
+    std::vector<Partial> partials(static_cast<size_t>(pool.GetThreadCount()) + 1);
+    const size_t chunkSize = (count + static_cast<size_t>(pool.GetThreadCount()) - 1) / static_cast<size_t>(pool.GetThreadCount());
+    pool.ParallelFor(count, [&](size_t begin, size_t end) {
+        Partial& partial = partials[begin / chunkSize];
+        for (size_t i = begin; i < end; ++i) {
+            double mass = snapshot.masses[i];
+            partial.mass += mass;
+            partial.position += mass * glm::dvec2(snapshot.positions[i]);
+            partial.velocity += mass * glm::dvec2(snapshot.velocities[i]);
+        }
+    });
+
+    glm::dvec2 weightedPosition(0.0);
+    glm::dvec2 weightedVelocity(0.0);
+    for (const Partial& partial : partials) {
+        m_totalMass += partial.mass;
+        weightedPosition += partial.position;
+        weightedVelocity += partial.velocity;
+    }
+    if (m_totalMass > 0.0) {
+        m_centerOfMass = weightedPosition / m_totalMass;
+        m_centerOfMassVelocity = weightedVelocity / m_totalMass;
+    }
+
+    // Radii and per-chunk sorted runs
+    m_radii.resize(count);
+    m_radialOrder.resize(count);
+    std::iota(m_radialOrder.begin(), m_radialOrder.end(), 0u);
+    std::vector<size_t> runStarts;
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        runStarts.push_back(begin);
+    }
+    pool.ParallelFor(count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            m_radii[i] = glm::length(GetRelativePosition(i));
+        }
+        std::sort(m_radialOrder.begin() + static_cast<std::ptrdiff_t>(begin),
+                  m_radialOrder.begin() + static_cast<std::ptrdiff_t>(end),
+                  [this](uint32_t a, uint32_t b) { return m_radii[a] < m_radii[b]; });
+    });
+
+    // Merge the sorted runs pairwise
+    runStarts.push_back(count);
+    while (runStarts.size() > 2) {
+        std::vector<size_t> merged;
+        for (size_t r = 0; r + 1 < runStarts.size(); r += 2) {
+            merged.push_back(runStarts[r]);
+            if (r + 2 < runStarts.size()) {
+                std::inplace_merge(m_radialOrder.begin() + static_cast<std::ptrdiff_t>(runStarts[r]),
+                                   m_radialOrder.begin() + static_cast<std::ptrdiff_t>(runStarts[r + 1]),
+                                   m_radialOrder.begin() + static_cast<std::ptrdiff_t>(runStarts[r + 2]),
+                                   [this](uint32_t a, uint32_t b) { return m_radii[a] < m_radii[b]; });
+            }
+        }
+        merged.push_back(count);
+        runStarts = std::move(merged);
+    }
+
+    m_enclosedMass.resize(count);
+    double enclosed = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        enclosed += snapshot.masses[m_radialOrder[i]];
+        m_enclosedMass[i] = enclosed;
+    }
+}
+
+float AnalysisContext::GetMassRadius(double fraction) const {
+    if (m_enclosedMass.empty()) return 0.0f;
+
+    const double target = std::clamp(fraction, 0.0, 1.0) * m_totalMass;
+    auto it = std::lower_bound(m_enclosedMass.begin(), m_enclosedMass.end(), target);
+    size_t index = std::min(static_cast<size_t>(it - m_enclosedMass.begin()), m_enclosedMass.size() - 1);
+    return m_radii[m_radialOrder[index]];
+}
+
+glm::vec2 AnalysisContext::GetRelativePosition(size_t index) const {
+    return glm::vec2(glm::dvec2(m_snapshot.positions[index]) - m_centerOfMass);
+}
+
+glm::vec2 AnalysisContext::GetRelativeVelocity(size_t index) const {
+    return glm::vec2(glm::dvec2(m_snapshot.velocities[index]) - m_centerOfMassVelocity);
+}
+
+} // namespace nbody
@@ -0,0 +1,179 @@
+#include "analysis/AnalysisPipeline.h"
+#include "analysis/StandardAnalyses.h"
+#include "analysis/WorkerPool.h"
+#include "core/Body.h"
+#include <filesystem>
+#include <iostream>
+#include <chrono>
+#include <functional>
+
+namespace nbody {
+
+AnalysisPipeline::AnalysisPipeline(const AnalysisConfig& config) : m_config(config) {
+    m_config.interval = std::max(1, m_config.interval);
+}
+
+AnalysisPipeline::~AnalysisPipeline() {
+    Stop();
+}
+
+void AnalysisPipeline::Register(std::unique_ptr<AnalysisModule> module) {
+    if (m_started) {
+        std::cerr << "Analysis modules must be registered before the pipeline starts" << std::endl;
+        return;
+    }
+    m_modules.push_back(std::move(module));
+}
+
+void AnalysisPipeline::RegisterStandardModules() {
+    Register(std::make_unique<RadialProfileAnalysis>());
+    Register(std::make_unique<LagrangianRadiiAnalysis>());
+    Register(std::make_unique<VelocityDispersionAnalysis>());
+    Register(std::make_unique<AngularMomentumAnalysis>());
+}
+
+void AnalysisPipeline::Start() {
+    if (m_started) return;
+
+    m_pool = std::make_unique<WorkerPool>(m_config.workerCount);
+    m_latest.assign(m_modules.size(), AnalysisResult());
+
+    // Files are opened on the first result that has something to write
+    m_scalarFiles.clear();
+    m_seriesFiles.clear();
+    m_scalarFiles.resize(m_modules.size());
+    m_seriesFiles.resize(m_modules.size());
+    if (!m_config.outputDirectory.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(m_config.outputDirectory, error);
+    }
+
+    m_stopRequested = false;
+    m_started = true;
+    m_coordinator = std::thread(&AnalysisPipeline::CoordinatorLoop, this);
+}
+
+void AnalysisPipeline::Stop() {
+    if (!m_started) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+    }
+    m_condition.notify_all();
+    m_coordinator.join();
+    m_pool.reset();
+    m_scalarFiles.clear();
+    m_seriesFiles.clear();
+    m_started = false;
+}
+
+bool AnalysisPipeline::Submit(const std::vector<std::unique_ptr<Body>>& bodies, uint64_t step, double time,
+                              bool force) {
+    if (!m_started || (!force && step % static_cast<uint64_t>(m_config.interval) != 0)) {
+        return false;
+    }
+
+    // Copy outside the lock, then publish by swapping buffers
+    m_capture.Capture(bodies, step, time);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_hasPending) {
+            m_dropped++;
+        }
+        std::swap(m_capture, m_pending);
+        m_hasPending = true;
+    }
+    m_condition.notify_one();
+    return true;
+}
+
+std::vector<AnalysisResult> AnalysisPipeline::GetLatestResults() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_latest;
+}
+
+void AnalysisPipeline::CoordinatorLoop() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopRequested || m_hasPending; });
+            if (m_stopRequested) return;
+            std::swap(m_pending, m_working);
+            m_hasPending = false;
+        }
+        Process(m_working);
+    }
+}
+
+void AnalysisPipeline::Process(const SimulationSnapshot& snapshot) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Shared reductions once, then every module against them in parallel
+    AnalysisContext context(snapshot, *m_pool);
+
+    std::vector<AnalysisResult> results(m_modules.size());
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < m_modules.size(); ++i) {
+        results[i].module = m_modules[i]->GetName();
+        results[i].step = snapshot.step;
+        results[i].time = snapshot.time;
+        tasks.emplace_back([this, i, &context, &results]() {
+            try {
+                m_modules[i]->Analyze(context, results[i]);
+            } catch (const std::exception& e) {
+                std::cerr << "Analysis module " << m_modules[i]->GetName() << " failed: " << e.what() << std::endl;
+            }
+        });
+    }
+    m_pool->Run(tasks);
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        WriteResult(i, results[i]);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_latest = std::move(results);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    m_lastDurationMs = std::chrono::duration<double, std::milli>(end - start).count();
+    m_completed++;
+}
+
+void AnalysisPipeline::WriteResult(size_t moduleIndex, const AnalysisResult& result) {
+    if (m_config.outputDirectory.empty() || moduleIndex >= m_scalarFiles.size()) return;
+
+    const std::string base = (std::filesystem::path(m_config.outputDirectory) / result.module).string();
+
+    std::ofstream& scalars = m_scalarFiles[moduleIndex];
+    if (!result.scalars.empty() && !scalars.is_open()) {
+        // Header from the first result, modules always report the same scalars
+        scalars.open(base + ".csv", std::ios::trunc);
+        scalars << "step,time";
+        for (const auto& scalar : result.scalars) scalars << "," << scalar.first;
+        scalars << "\n";
+    }
+    if (!result.scalars.empty() && scalars.is_open()) {
+        scalars << result.step << "," << result.time;
+        for (const auto& scalar : result.scalars) scalars << "," << scalar.second;
+        scalars << "\n";
+        scalars.flush();
+    }
+
+    std::ofstream& series = m_seriesFiles[moduleIndex];
+    if (!result.series.empty() && !series.is_open()) {
+        series.open(base + "_series.csv", std::ios::trunc);
+        series << "step,time,series,x,y\n";
+    }
+    if (!result.series.empty() && series.is_open()) {
+        for (const auto& curve : result.series) {
+            for (size_t i = 0; i < curve.x.size() && i < curve.y.size(); ++i) {
+                series << result.step << "," << result.time << "," << curve.name << ","
+                       << curve.x[i] << "," << curve.y[i] << "\n";
+            }
+        }
+        series.flush();
+    }
+}
+
+} // namespace nbody
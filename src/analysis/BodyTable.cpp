@@ -0,0 +1,118 @@
+#include "analysis/BodyTable.h"
+#include "core/Body.h"
+#include <omp.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace nbody {
+
+float BodyTableSorter::GetKey(const Body& body, size_t index, BodyTableKey key) {
+    switch (key) {
+        case BodyTableKey::Mass: return body.GetMass();
+        case BodyTableKey::Speed: return body.GetSpeed();
+        case BodyTableKey::KineticEnergy: return body.GetKineticEnergy();
+        default: return static_cast<float>(index);
+    }
+}
+
+void BodyTableSorter::Request(const std::vector<std::unique_ptr<Body>>& bodies, const BodyTableQuery& query,
+                              uint64_t step) {
+    Job job;
+    job.query = query;
+    job.step = step;
+    job.keys.resize(bodies.size());
+
+    const float filtered = std::numeric_limits<float>::quiet_NaN();
+    const int64_t count = static_cast<int64_t>(bodies.size());
+    #pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < count; ++i) {
+        const Body& body = *bodies[i];
+        if (query.inRegion) {
+            const glm::vec2& position = body.GetPosition();
+            if (position.x < query.regionMin.x || position.y < query.regionMin.y ||
+                position.x > query.regionMax.x || position.y > query.regionMax.y) {
+                job.keys[i] = filtered;
+                continue;
+            }
+        }
+        float key = GetKey(body, static_cast<size_t>(i), query.key);
+        job.keys[i] = (key >= query.minValue && key <= query.maxValue) ? key : filtered;
+    }
+
+    m_worker.Submit(std::move(job));
+}
+
+bool BodyTableSorter::FetchRows(BodyTableRows& rows) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_hasRows) return false;
+    rows = std::move(m_rows);
+    m_hasRows = false;
+    return true;
+}
+
+void BodyTableSorter::Sort(const Job& job, uint64_t generation) {
+    auto start = std::chrono::high_resolution_clock::now();
+    auto aborted = [&]() { return !m_worker.IsCurrent(generation); };
+
+    const std::vector<float>& keys = job.keys;
+    const bool descending = job.query.descending;
+    // Ties go to the lower index, so equal keys keep a stable order between refreshes
+    auto before = [&keys, descending](uint32_t a, uint32_t b) {
+        if (keys[a] != keys[b]) return descending ? keys[a] > keys[b] : keys[a] < keys[b];
+        return a < b;
+    };
+
+    // Gather and partially sort per chunk, keeping each chunk's best `limit`
+    const size_t total = keys.size();
+    const int chunks = total >= PARALLEL_THRESHOLD ? std::max(1, omp_get_max_threads()) : 1;
+    std::vector<std::vector<uint32_t>> winners(chunks);
+    std::vector<size_t> matched(chunks, 0);
+    const size_t limit = job.query.limit;
+
+    #pragma omp parallel for schedule(static, 1) num_threads(chunks)
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        size_t begin = total * chunk / chunks;
+        size_t end = total * (chunk + 1) / chunks;
+        std::vector<uint32_t>& candidates = winners[chunk];
+        candidates.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            if (!std::isnan(keys[i])) candidates.push_back(static_cast<uint32_t>(i));
+        }
+        matched[chunk] = candidates.size();
+        if (candidates.size() > limit) {
+            std::nth_element(candidates.begin(), candidates.begin() + limit, candidates.end(), before);
+            candidates.resize(limit);
+            candidates.shrink_to_fit();
+        }
+    }
+    if (aborted()) return;
+
+    BodyTableRows rows;
+    rows.total = total;
+    rows.step = job.step;
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        rows.matched += matched[chunk];
+        rows.indices.insert(rows.indices.end(), winners[chunk].begin(), winners[chunk].end());
+    }
+    winners.clear();
+
+    if (rows.indices.size() > limit) {
+        std::nth_element(rows.indices.begin(), rows.indices.begin() + limit, rows.indices.end(), before);
+        rows.indices.resize(limit);
+    }
+    if (aborted()) return;
+    std::sort(rows.indices.begin(), rows.indices.end(), before);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    rows.elapsedMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_worker.IsCurrent(generation)) return;
+    m_rows = std::move(rows);
+    m_hasRows = true;
+}
+
+} // namespace nbody
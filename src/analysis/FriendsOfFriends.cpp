@@ -0,0 +1,334 @@
+#include "analysis/FriendsOfFriends.h"
+#include "core/Body.h"
+#include <omp.h>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace nbody {
+
+void FriendsOfFriends::Find(const std::vector<std::unique_ptr<Body>>& bodies, FoFResult& result) {
+    Begin(bodies);
+    while (!Advance(std::chrono::steady_clock::time_point::max())) {
+    }
+    TakeResult(result);
+}
+
+void FriendsOfFriends::Begin(const std::vector<std::unique_ptr<Body>>& bodies) {
+    auto start = std::chrono::steady_clock::now();
+
+    const size_t count = bodies.size();
+    const int n = static_cast<int>(count);
+    m_positions.resize(count);
+    m_velocities.resize(count);
+    m_masses.resize(count);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; ++i) {
+        m_positions[i] = bodies[i]->GetPosition();
+        m_velocities[i] = bodies[i]->GetVelocity();
+        m_masses[i] = bodies[i]->GetMass();
+    }
+    m_linkingLength = std::max(m_config.linkingLength, 0.0f);
+    m_minMembers = std::max(1, m_config.minMembers);
+
+    m_result = FoFResult();
+    m_result.groupIds.assign(count, -1);
+    m_result.ungroupedCount = n;
+    m_accumulators.clear();
+    m_groupOfSlot.clear();
+
+    if (count > 0) {
+        glm::vec2 minimum(m_positions[0]);
+        glm::vec2 maximum(minimum);
+        for (const glm::vec2& position : m_positions) {
+            minimum = glm::min(minimum, position);
+            maximum = glm::max(maximum, position);
+        }
+        // Cells never smaller than the linking length, so friends are at most one cell apart
+        const float extent = std::max(maximum.x - minimum.x, maximum.y - minimum.y);
+        m_origin = minimum;
+        m_cellSize = std::max({m_linkingLength, extent / 65535.0f, std::numeric_limits<float>::min()});
+
+        size_t buckets = 1024;
+        while (buckets < count) buckets *= 2;
+        m_bucketMask = static_cast<uint32_t>(buckets - 1);
+        m_bucketOf.resize(count);
+        m_offsets.assign(buckets + 1, 0);
+        m_fill.resize(buckets);
+        m_sorted.resize(count);
+
+        if (m_parentCapacity < count) {
+            m_parent.reset(new std::atomic<uint32_t>[count]);
+            m_parentCapacity = count;
+        }
+        m_roots.resize(count);
+        m_memberCount.assign(count, 0);
+        m_slotOfRoot.assign(count, -1);
+        NextStage(Stage::Count, count);
+    } else {
+        NextStage(Stage::Done, 0);
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    m_workMs = std::chrono::duration<double, std::milli>(end - start).count();
+    m_result.elapsedMs = m_workMs;
+}
+
+bool FriendsOfFriends::Advance(std::chrono::steady_clock::time_point deadline) {
+    auto start = std::chrono::steady_clock::now();
+    do {
+        AdvanceStage();
+    } while (m_stage != Stage::Done && std::chrono::steady_clock::now() < deadline);
+
+    auto end = std::chrono::steady_clock::now();
+    m_workMs += std::chrono::duration<double, std::milli>(end - start).count();
+    m_result.elapsedMs = m_workMs;
+    return m_stage == Stage::Done;
+}
+
+float FriendsOfFriends::GetProgress() const {
+    if (m_stage == Stage::Done) return 1.0f;
+
+    // Rough relative cost of the stages; linking is most of a pass
+    static constexpr float weights[] = {1.0f, 1.0f, 1.0f, 8.0f, 1.0f, 1.0f, 1.0f};
+    const int current = static_cast<int>(m_stage);
+    float done = 0.0f;
+    float total = 0.0f;
+    for (int stage = 0; stage < static_cast<int>(Stage::Done); ++stage) {
+        total += weights[stage];
+        if (stage < current) {
+            done += weights[stage];
+        } else if (stage == current && m_stageSize > 0) {
+            done += weights[stage] * static_cast<float>(m_cursor) / static_cast<float>(m_stageSize);
+        }
+    }
+    return done / total;
+}
+
+void FriendsOfFriends::TakeResult(FoFResult& result) {
+    result = std::move(m_result);
+    m_result = FoFResult();
+}
+
+void FriendsOfFriends::NextStage(Stage stage, size_t size) {
+    m_stage = stage;
+    m_cursor = 0;
+    m_stageSize = size;
+}
+
+void FriendsOfFriends::AdvanceStage() {
+    const size_t count = m_positions.size();
+    const size_t begin = m_cursor;
+    const size_t end = std::min(m_stageSize, begin + (m_stage == Stage::Link ? m_linkChunkSize : CHUNK_SIZE));
+    m_cursor = end;
+
+    switch (m_stage) {
+        case Stage::Count:
+            for (size_t i = begin; i < end; ++i) {
+                uint32_t bucket = GetBucket(GetCell(m_positions[i]));
+                m_bucketOf[i] = bucket;
+                m_offsets[bucket + 1]++;
+                m_parent[i].store(static_cast<uint32_t>(i), std::memory_order_relaxed);
+            }
+            if (end == m_stageSize) NextStage(Stage::Offsets, m_fill.size());
+            break;
+
+        case Stage::Offsets:
+            for (size_t bucket = begin; bucket < end; ++bucket) {
+                m_offsets[bucket + 1] += m_offsets[bucket];
+                m_fill[bucket] = m_offsets[bucket];
+            }
+            if (end == m_stageSize) NextStage(Stage::Scatter, count);
+            break;
+
+        case Stage::Scatter:
+            for (size_t i = begin; i < end; ++i) {
+                m_sorted[m_fill[m_bucketOf[i]]++] = static_cast<uint32_t>(i);
+            }
+            if (end == m_stageSize) NextStage(Stage::Link, count);
+            break;
+
+        case Stage::Link: {
+            // Bodies in bucket order, so neighbouring queries read the same buckets.
+            // Pairs are seen from both sides; only the lower index links.
+            auto start = std::chrono::steady_clock::now();
+            const float linkingLength2 = m_linkingLength * m_linkingLength;
+            const int64_t first = static_cast<int64_t>(begin);
+            const int64_t last = static_cast<int64_t>(end);
+            #pragma omp parallel for schedule(dynamic, 256)
+            for (int64_t k = first; k < last; ++k) {
+                const uint32_t i = m_sorted[k];
+                const glm::vec2 position = m_positions[i];
+                const glm::ivec2 cell = GetCell(position);
+
+                uint32_t visited[9];
+                int visitedCount = 0;
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        // Cells that share a bucket are scanned once
+                        const uint32_t bucket = GetBucket(cell + glm::ivec2(dx, dy));
+                        if (std::find(visited, visited + visitedCount, bucket) != visited + visitedCount) continue;
+                        visited[visitedCount++] = bucket;
+
+                        for (uint32_t s = m_offsets[bucket]; s < m_offsets[bucket + 1]; ++s) {
+                            const uint32_t j = m_sorted[s];
+                            if (j <= i) continue;
+                            const glm::vec2 offset = m_positions[j] - position;
+                            if (glm::dot(offset, offset) <= linkingLength2) {
+                                Unite(i, j);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Dense clumps cost many times more per body than open space
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (ms < LINK_CHUNK_MS / 2.0 && end - begin == m_linkChunkSize) {
+                m_linkChunkSize = std::min(m_linkChunkSize * 2, CHUNK_SIZE);
+            } else if (ms > LINK_CHUNK_MS * 2.0) {
+                m_linkChunkSize = std::max(m_linkChunkSize / 2, MIN_LINK_CHUNK_SIZE);
+            }
+            if (end == m_stageSize) NextStage(Stage::Roots, count);
+            break;
+        }
+
+        case Stage::Roots: {
+            const int64_t first = static_cast<int64_t>(begin);
+            const int64_t last = static_cast<int64_t>(end);
+            #pragma omp parallel for schedule(static)
+            for (int64_t i = first; i < last; ++i) {
+                m_roots[i] = FindRoot(static_cast<uint32_t>(i));
+            }
+            for (size_t i = begin; i < end; ++i) {
+                m_memberCount[m_roots[i]]++;
+            }
+            if (end == m_stageSize) NextStage(Stage::Accumulate, count);
+            break;
+        }
+
+        case Stage::Accumulate:
+            // A set's root is its smallest index, so slots are made in root order
+            for (size_t i = begin; i < end; ++i) {
+                const uint32_t root = m_roots[i];
+                if (m_memberCount[root] < m_minMembers) continue;
+                int& slot = m_slotOfRoot[root];
+                if (slot < 0) {
+                    slot = static_cast<int>(m_accumulators.size());
+                    m_accumulators.emplace_back();
+                    m_accumulators.back().members = m_memberCount[root];
+                }
+                Accumulator& accumulator = m_accumulators[slot];
+                const double mass = m_masses[i];
+                accumulator.mass += mass;
+                accumulator.position += mass * glm::dvec2(m_positions[i]);
+                accumulator.momentum += mass * glm::dvec2(m_velocities[i]);
+            }
+            if (end == m_stageSize) {
+                SortGroups();
+                NextStage(Stage::Label, count);
+            }
+            break;
+
+        case Stage::Label: {
+            int grouped = 0;
+            for (size_t i = begin; i < end; ++i) {
+                const int slot = m_slotOfRoot[m_roots[i]];
+                m_result.groupIds[i] = slot >= 0 ? m_groupOfSlot[slot] : -1;
+                if (slot >= 0) grouped++;
+            }
+            m_result.ungroupedCount -= grouped;
+            if (end == m_stageSize) NextStage(Stage::Done, 0);
+            break;
+        }
+
+        case Stage::Done:
+            break;
+    }
+}
+
+void FriendsOfFriends::SortGroups() {
+    // Heaviest group first, so IDs (and colors) stay stable while groups evolve
+    std::vector<int> order(m_accumulators.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return m_accumulators[a].mass > m_accumulators[b].mass;
+    });
+
+    m_groupOfSlot.resize(m_accumulators.size());
+    m_result.groups.resize(m_accumulators.size());
+    for (size_t id = 0; id < order.size(); ++id) {
+        const Accumulator& accumulator = m_accumulators[order[id]];
+        FoFGroup& group = m_result.groups[id];
+        group.memberCount = accumulator.members;
+        group.mass = static_cast<float>(accumulator.mass);
+        if (accumulator.mass > 0.0) {
+            group.centerOfMass = glm::vec2(accumulator.position / accumulator.mass);
+            group.velocity = glm::vec2(accumulator.momentum / accumulator.mass);
+        }
+        m_groupOfSlot[order[id]] = static_cast<int>(id);
+    }
+}
+
+glm::ivec2 FriendsOfFriends::GetCell(const glm::vec2& position) const {
+    glm::vec2 cell = (position - m_origin) / m_cellSize;
+    return glm::ivec2(static_cast<int>(std::clamp(cell.x, 0.0f, 65535.0f)),
+                      static_cast<int>(std::clamp(cell.y, 0.0f, 65535.0f)));
+}
+
+uint32_t FriendsOfFriends::GetBucket(glm::ivec2 cell) const {
+    uint32_t hash = (static_cast<uint32_t>(cell.x) * 73856093u) ^ (static_cast<uint32_t>(cell.y) * 19349663u);
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3bu;
+    hash ^= hash >> 16;
+    return hash & m_bucketMask;
+}
+
+uint32_t FriendsOfFriends::FindRoot(uint32_t index) {
+    while (true) {
+        uint32_t parent = m_parent[index].load(std::memory_order_acquire);
+        if (parent == index) return index;
+
+        // Path halving; a lost race only means the path stays a little longer
+        uint32_t grandparent = m_parent[parent].load(std::memory_order_acquire);
+        if (parent != grandparent) {
+            m_parent[index].compare_exchange_weak(parent, grandparent, std::memory_order_acq_rel);
+        }
+        index = grandparent;
+    }
+}
+
+void FriendsOfFriends::Unite(uint32_t a, uint32_t b) {
+    while (true) {
+        a = FindRoot(a);
+        b = FindRoot(b);
+        if (a == b) return;
+
+        // Hang the larger root under the smaller one; parents always have smaller indices, so no cycles
+        if (a < b) std::swap(a, b);
+        uint32_t expected = a;
+        if (m_parent[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) return;
+    }
+}
+
+glm::vec3 FriendsOfFriends::GetGroupColor(int groupId) {
+    if (groupId < 0) return glm::vec3(0.35f);
+
+    // Golden-ratio hue steps keep neighbouring IDs far apart on the color wheel
+    float hue = std::fmod(groupId * 0.618033988749895f, 1.0f) * 6.0f;
+    float x = 1.0f - std::abs(std::fmod(hue, 2.0f) - 1.0f);
+    glm::vec3 color;
+    switch (static_cast<int>(hue)) {
+        case 0: color = glm::vec3(1.0f, x, 0.0f); break;
+        case 1: color = glm::vec3(x, 1.0f, 0.0f); break;
+        case 2: color = glm::vec3(0.0f, 1.0f, x); break;
+        case 3: color = glm::vec3(0.0f, x, 1.0f); break;
+        case 4: color = glm::vec3(x, 0.0f, 1.0f); break;
+        default: color = glm::vec3(1.0f, 0.0f, x); break;
+    }
+    return glm::vec3(0.25f) + 0.75f * color;
+}
+
+} // namespace nbody
@@ -0,0 +1,50 @@
+#include "analysis/PotentialEnergy.h"
+#include "core/Body.h"
+
+namespace nbody {
+
+void PotentialEnergyJob::Begin(const std::vector<std::unique_ptr<Body>>& bodies) {
+    m_positions.resize(bodies.size());
+    m_masses.resize(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        m_positions[i] = bodies[i]->GetPosition();
+        m_masses[i] = bodies[i]->GetMass();
+    }
+    m_running = m_physics.CalculateConservationStats(bodies);
+    m_runningStep = m_physics.GetStepCount();
+    m_runningTime = m_physics.GetSimulationTime();
+    m_nextRow = 0;
+    m_pairsDone = 0.0;
+}
+
+bool PotentialEnergyJob::Advance(std::chrono::steady_clock::time_point deadline) {
+    const size_t count = m_positions.size();
+    do {
+        // Row i has count - 1 - i pairs, so later chunks take more rows
+        size_t lastRow = m_nextRow;
+        double pairs = 0.0;
+        while (lastRow < count && pairs < PAIRS_PER_CHUNK) {
+            pairs += static_cast<double>(count - 1 - lastRow);
+            lastRow++;
+        }
+        m_running.potential += m_physics.CalculatePotentialRows(m_positions, m_masses, m_nextRow, lastRow);
+        m_pairsDone += pairs;
+        m_nextRow = lastRow;
+    } while (m_nextRow < count && std::chrono::steady_clock::now() < deadline);
+
+    if (m_nextRow < count) return false;
+
+    m_running.total = m_running.kinetic + m_running.potential;
+    m_stats = m_running;
+    m_step = m_runningStep;
+    m_time = m_runningTime;
+    return true;
+}
+
+float PotentialEnergyJob::GetProgress() const {
+    const double count = static_cast<double>(m_positions.size());
+    const double totalPairs = count * (count - 1.0) / 2.0;
+    return totalPairs > 0.0 ? static_cast<float>(m_pairsDone / totalPairs) : 1.0f;
+}
+
+} // namespace nbody
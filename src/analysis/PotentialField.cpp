@@ -0,0 +1,334 @@
+#include "analysis/PotentialField.h"
+#include "physics/BarnesHut.h"
+#include "core/Body.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace nbody {
+
+void PotentialFieldSampler::Request(const BarnesHutTree* tree, const std::vector<std::unique_ptr<Body>>& bodies,
+                                    const glm::vec2& minimum, const glm::vec2& maximum, float G,
+                                    float softeningLength) {
+    if (maximum.x <= minimum.x || maximum.y <= minimum.y) return;
+
+    Job job;
+    job.minimum = glm::dvec2(minimum);
+    job.maximum = glm::dvec2(maximum);
+    job.G = G;
+    job.config = m_config;
+    job.config.baseCells = std::clamp(job.config.baseCells, 2, 256);
+    job.config.maxRefinement = std::clamp(job.config.maxRefinement, 0, 6);
+    job.config.contourLevels = std::clamp(job.config.contourLevels, 1, 64);
+
+    // Structure below the finest grid spacing can't show up in the contours
+    const float finestSpacing = (maximum.x - minimum.x) / (job.config.baseCells << job.config.maxRefinement);
+    const float softeningSq = softeningLength * softeningLength;
+    const QuadTreeNode* root = tree ? tree->GetRoot() : nullptr;
+    if (root && root->totalMass > 0.0f) {
+        FlattenTree(root, finestSpacing, softeningSq, job.nodes);
+        job.roots.push_back(0);
+    } else {
+        if (bodies.size() <= MAX_DIRECT_SOURCES) {
+            job.nodes.reserve(bodies.size());
+            for (const auto& body : bodies) {
+                job.nodes.push_back({body->GetPosition(), 0.0f, body->GetMass(), softeningSq, -1});
+            }
+        } else {
+            BinBodies(bodies, softeningSq, job.nodes);
+        }
+        for (size_t i = 0; i < job.nodes.size(); ++i) {
+            job.roots.push_back(static_cast<int>(i));
+        }
+    }
+
+    m_worker.Submit(std::move(job));
+}
+
+bool PotentialFieldSampler::FetchContours(PotentialContours& contours) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_contoursVersion == m_fetchedVersion) return false;
+    contours = m_contours;
+    m_fetchedVersion = m_contoursVersion;
+    return true;
+}
+
+void PotentialFieldSampler::FlattenTree(const QuadTreeNode* root, float minSize, float softeningSq,
+                                        std::vector<Node>& nodes) const {
+    auto convert = [softeningSq](const QuadTreeNode* node) {
+        return Node{node->centerOfMass, node->isLeaf ? 0.0f : node->size, node->totalMass, softeningSq, -1};
+    };
+
+    // Breadth first, so the four children of a node always sit next to each other
+    nodes.clear();
+    nodes.push_back(convert(root));
+    std::vector<std::pair<const QuadTreeNode*, int>> queue{{root, 0}};
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const QuadTreeNode* source = queue[head].first;
+        const int index = queue[head].second;
+
+        if (source->isLeaf || source->size < minSize || nodes.size() + 4 > MAX_NODES) {
+            // Cut off here: smear the aggregate over its extent
+            float halfSize = 0.5f * nodes[index].size;
+            nodes[index].softeningSq += halfSize * halfSize;
+            continue;
+        }
+
+        nodes[index].firstChild = static_cast<int>(nodes.size());
+        for (const auto& child : source->children) {
+            nodes.push_back(child ? convert(child.get()) : Node());
+            if (child && child->totalMass > 0.0f) {
+                queue.emplace_back(child.get(), static_cast<int>(nodes.size()) - 1);
+            }
+        }
+    }
+}
+
+void PotentialFieldSampler::BinBodies(const std::vector<std::unique_ptr<Body>>& bodies, float softeningSq,
+                                      std::vector<Node>& nodes) const {
+    // Uniform grid over the bodies, each occupied cell a smeared point mass
+    glm::vec2 lower(std::numeric_limits<float>::max());
+    glm::vec2 upper(std::numeric_limits<float>::lowest());
+    for (const auto& body : bodies) {
+        lower = glm::min(lower, body->GetPosition());
+        upper = glm::max(upper, body->GetPosition());
+    }
+    const float cellSize = std::max(std::max(upper.x - lower.x, upper.y - lower.y), 1e-6f) / BIN_CELLS;
+
+    std::vector<glm::dvec2> moments(BIN_CELLS * BIN_CELLS, glm::dvec2(0.0));
+    std::vector<double> masses(BIN_CELLS * BIN_CELLS, 0.0);
+    for (const auto& body : bodies) {
+        glm::vec2 offset = (body->GetPosition() - lower) / cellSize;
+        int x = std::min(static_cast<int>(offset.x), BIN_CELLS - 1);
+        int y = std::min(static_cast<int>(offset.y), BIN_CELLS - 1);
+        moments[y * BIN_CELLS + x] += glm::dvec2(body->GetPosition()) * static_cast<double>(body->GetMass());
+        masses[y * BIN_CELLS + x] += body->GetMass();
+    }
+
+    const float halfSize = 0.5f * cellSize;
+    nodes.clear();
+    for (size_t i = 0; i < masses.size(); ++i) {
+        if (masses[i] <= 0.0) continue;
+        nodes.push_back({glm::vec2(moments[i] / masses[i]), cellSize, static_cast<float>(masses[i]),
+                         softeningSq + halfSize * halfSize, -1});
+    }
+}
+
+void PotentialFieldSampler::Run(const Job& job, uint64_t generation) {
+    auto start = std::chrono::high_resolution_clock::now();
+    Sample(job, generation);
+    auto end = std::chrono::high_resolution_clock::now();
+    m_lastDurationMs = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+double PotentialFieldSampler::Evaluate(const Job& job, const glm::dvec2& point, std::vector<int>& stack) const {
+    const double thetaSq = static_cast<double>(job.config.theta) * job.config.theta;
+    double potential = 0.0;
+
+    stack.assign(job.roots.begin(), job.roots.end());
+    while (!stack.empty()) {
+        const Node& node = job.nodes[stack.back()];
+        stack.pop_back();
+        if (node.mass <= 0.0f) continue;
+
+        glm::dvec2 delta = glm::dvec2(node.centerOfMass) - point;
+        double distanceSq = glm::dot(delta, delta);
+        double size = node.size;
+        if (node.firstChild < 0 || size * size < thetaSq * distanceSq) {
+            potential -= job.G * node.mass / std::sqrt(distanceSq + node.softeningSq);
+        } else {
+            for (int child = 0; child < 4; ++child) {
+                stack.push_back(node.firstChild + child);
+            }
+        }
+    }
+    return potential;
+}
+
+void PotentialFieldSampler::Sample(const Job& job, uint64_t generation) {
+    const PotentialFieldConfig& config = job.config;
+    const int levels = config.maxRefinement;
+    const int stride = 1 << levels;
+    const glm::dvec2 extent = job.maximum - job.minimum;
+    const int cellsX = config.baseCells;
+    const int cellsY = std::max(1, static_cast<int>(std::lround(config.baseCells * extent.y / extent.x)));
+    const int width = cellsX * stride + 1;
+    const int height = cellsY * stride + 1;
+    const glm::dvec2 spacing = extent / glm::dvec2(width - 1, height - 1);
+
+    // Values are log(-potential) on the finest grid; only some samples are evaluated
+    std::vector<double> values(static_cast<size_t>(width) * height, 0.0);
+    std::vector<char> known(values.size(), 0);
+    std::vector<int> stack;
+    PotentialContours contours;
+
+    auto aborted = [&]() { return !m_worker.IsCurrent(generation); };
+    auto sampleAt = [&](int x, int y) {
+        size_t index = static_cast<size_t>(y) * width + x;
+        if (!known[index]) {
+            glm::dvec2 point = job.minimum + spacing * glm::dvec2(x, y);
+            values[index] = std::log(std::max(-Evaluate(job, point, stack), 1e-30));
+            known[index] = 1;
+            contours.samples++;
+        }
+        return values[index];
+    };
+
+    // Coarse pass, which also fixes the contour levels for the refinement passes
+    double lowest = 1e300;
+    double highest = -1e300;
+    for (int y = 0; y <= cellsY; ++y) {
+        if (aborted()) return;
+        for (int x = 0; x <= cellsX; ++x) {
+            double value = sampleAt(x * stride, y * stride);
+            lowest = std::min(lowest, value);
+            highest = std::max(highest, value);
+        }
+    }
+    const int contourLevels = config.contourLevels;
+    const double levelSpacing = std::max(highest - lowest, 1e-9) / contourLevels;
+
+    std::vector<Cell> active;
+    std::vector<Cell> finished;
+    for (int y = 0; y < cellsY; ++y) {
+        for (int x = 0; x < cellsX; ++x) {
+            active.push_back({x * stride, y * stride, stride});
+        }
+    }
+
+    auto publishPass = [&](int pass) {
+        // Bilinear fill between samples, coarse cells first so finer ones win on shared edges
+        std::vector<double> filled = values;
+        for (const auto* cells : {&finished, &active}) {
+            for (const Cell& cell : *cells) {
+                double v00 = values[static_cast<size_t>(cell.y) * width + cell.x];
+                double v10 = values[static_cast<size_t>(cell.y) * width + cell.x + cell.size];
+                double v01 = values[static_cast<size_t>(cell.y + cell.size) * width + cell.x];
+                double v11 = values[static_cast<size_t>(cell.y + cell.size) * width + cell.x + cell.size];
+                for (int j = 0; j <= cell.size; ++j) {
+                    double v = static_cast<double>(j) / cell.size;
+                    for (int i = 0; i <= cell.size; ++i) {
+                        size_t index = static_cast<size_t>(cell.y + j) * width + cell.x + i;
+                        if (known[index]) continue;
+                        double u = static_cast<double>(i) / cell.size;
+                        filled[index] = (1.0 - v) * ((1.0 - u) * v00 + u * v10) + v * ((1.0 - u) * v01 + u * v11);
+                    }
+                }
+            }
+        }
+        Contour(filled, width, height, job.minimum, spacing, lowest, levelSpacing, contourLevels, contours);
+        contours.refinementLevel = pass;
+        return Publish(contours, generation);
+    };
+
+    if (!publishPass(0)) return;
+
+    for (int pass = 1; pass <= levels && !active.empty(); ++pass) {
+        std::vector<Cell> next;
+        for (const Cell& cell : active) {
+            if (aborted()) return;
+
+            const int half = cell.size / 2;
+            double corners[4] = {
+                sampleAt(cell.x, cell.y), sampleAt(cell.x + cell.size, cell.y),
+                sampleAt(cell.x, cell.y + cell.size), sampleAt(cell.x + cell.size, cell.y + cell.size)
+            };
+            double center = sampleAt(cell.x + half, cell.y + half);
+            double spread = *std::max_element(corners, corners + 4) - *std::min_element(corners, corners + 4);
+            double curvature = std::abs(center - 0.25 * (corners[0] + corners[1] + corners[2] + corners[3]));
+
+            // Split only where a contour could bend or pass unseen within the cell
+            if (spread > 0.5 * levelSpacing || curvature > 0.25 * levelSpacing) {
+                sampleAt(cell.x + half, cell.y);
+                sampleAt(cell.x, cell.y + half);
+                sampleAt(cell.x + cell.size, cell.y + half);
+                sampleAt(cell.x + half, cell.y + cell.size);
+                next.push_back({cell.x, cell.y, half});
+                next.push_back({cell.x + half, cell.y, half});
+                next.push_back({cell.x, cell.y + half, half});
+                next.push_back({cell.x + half, cell.y + half, half});
+            } else {
+                finished.push_back(cell);
+            }
+        }
+        active.swap(next);
+        if (!publishPass(pass)) return;
+    }
+}
+
+void PotentialFieldSampler::Contour(const std::vector<double>& values, int width, int height,
+                                    const glm::dvec2& minimum, const glm::dvec2& spacing, double lowest,
+                                    double levelSpacing, int levels, PotentialContours& contours) const {
+    // Marching squares, one segment list per level
+    std::vector<std::vector<glm::vec2>> perLevel(levels);
+    auto at = [&](int x, int y) { return values[static_cast<size_t>(y) * width + x]; };
+    auto toWorld = [&](double x, double y) { return glm::vec2(minimum + spacing * glm::dvec2(x, y)); };
+
+    for (int y = 0; y + 1 < height; ++y) {
+        for (int x = 0; x + 1 < width; ++x) {
+            const double a = at(x, y);          // Bottom left
+            const double b = at(x + 1, y);      // Bottom right
+            const double c = at(x + 1, y + 1);  // Top right
+            const double d = at(x, y + 1);      // Top left
+            const double low = std::min(std::min(a, b), std::min(c, d));
+            const double high = std::max(std::max(a, b), std::max(c, d));
+
+            int first = std::max(0, static_cast<int>(std::ceil((low - lowest) / levelSpacing - 0.5)));
+            int last = std::min(levels - 1, static_cast<int>(std::floor((high - lowest) / levelSpacing - 0.5)));
+            for (int level = first; level <= last; ++level) {
+                const double value = lowest + (level + 0.5) * levelSpacing;
+                auto crossing = [value](double from, double to) {
+                    return to != from ? (value - from) / (to - from) : 0.5;
+                };
+                const glm::vec2 edges[4] = {
+                    toWorld(x + crossing(a, b), y),     // Bottom
+                    toWorld(x + 1, y + crossing(b, c)), // Right
+                    toWorld(x + crossing(d, c), y + 1), // Top
+                    toWorld(x, y + crossing(a, d))      // Left
+                };
+                auto& segments = perLevel[level];
+                auto emit = [&](int from, int to) {
+                    segments.push_back(edges[from]);
+                    segments.push_back(edges[to]);
+                };
+
+                int index = (a > value) | ((b > value) << 1) | ((c > value) << 2) | ((d > value) << 3);
+                bool centerAbove = 0.25 * (a + b + c + d) > value;
+                switch (index) {
+                    case 1: case 14: emit(3, 0); break;
+                    case 2: case 13: emit(0, 1); break;
+                    case 3: case 12: emit(3, 1); break;
+                    case 4: case 11: emit(1, 2); break;
+                    case 6: case 9:  emit(0, 2); break;
+                    case 7: case 8:  emit(3, 2); break;
+                    case 5: // a and c above
+                        if (centerAbove) { emit(0, 1); emit(2, 3); } else { emit(3, 0); emit(1, 2); }
+                        break;
+                    case 10: // b and d above
+                        if (centerAbove) { emit(3, 0); emit(1, 2); } else { emit(0, 1); emit(2, 3); }
+                        break;
+                    default: break;
+                }
+            }
+        }
+    }
+
+    contours.segments.clear();
+    contours.levelOffsets.assign(1, 0);
+    for (const auto& segments : perLevel) {
+        contours.segments.insert(contours.segments.end(), segments.begin(), segments.end());
+        contours.levelOffsets.push_back(static_cast<uint32_t>(contours.segments.size()));
+    }
+}
+
+bool PotentialFieldSampler::Publish(PotentialContours& contours, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_worker.IsCurrent(generation)) return false;
+    m_contours = contours;
+    m_contoursVersion++;
+    return true;
+}
+
+} // namespace nbody
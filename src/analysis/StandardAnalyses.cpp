@@ -0,0 +1,151 @@
+#include "analysis/StandardAnalyses.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+
+namespace nbody {
+
+void RadialProfileAnalysis::Analyze(const AnalysisContext& context, AnalysisResult& result) {
+    const auto& order = context.GetRadialOrder();
+    const auto& radii = context.GetRadii();
+    const auto& snapshot = context.GetSnapshot();
+    if (order.empty() || m_binCount <= 0) return;
+
+    // Logarithmic shells from the innermost percent of the mass to the outermost body
+    float innerRadius = std::max(context.GetMassRadius(0.01), 1e-3f);
+    float outerRadius = radii[order.back()];
+    if (outerRadius <= innerRadius) return;
+
+    const float logInner = std::log(innerRadius);
+    const float logStep = (std::log(outerRadius) - logInner) / m_binCount;
+
+    std::vector<double> mass(m_binCount, 0.0);
+    std::vector<double> radialMomentum(m_binCount, 0.0);
+    std::vector<double> tangentialMomentum(m_binCount, 0.0);
+
+    for (uint32_t index : order) {
+        float radius = radii[index];
+        if (radius < innerRadius) continue;
+
+        int bin = std::min(m_binCount - 1, static_cast<int>((std::log(radius) - logInner) / logStep));
+        glm::vec2 position = context.GetRelativePosition(index);
+        glm::vec2 velocity = context.GetRelativeVelocity(index);
+        glm::vec2 radial = position / std::max(radius, 1e-12f);
+        double m = snapshot.masses[index];
+
+        mass[bin] += m;
+        radialMomentum[bin] += m * glm::dot(velocity, radial);
+        tangentialMomentum[bin] += m * (radial.x * velocity.y - radial.y * velocity.x);
+    }
+
+    AnalysisSeries density{"density", {}, {}};
+    AnalysisSeries radialVelocity{"v_radial", {}, {}};
+    AnalysisSeries tangentialVelocity{"v_tangential", {}, {}};
+    for (int bin = 0; bin < m_binCount; ++bin) {
+        float r0 = std::exp(logInner + bin * logStep);
+        float r1 = std::exp(logInner + (bin + 1) * logStep);
+        float center = std::sqrt(r0 * r1);
+        double area = 3.14159265358979 * (static_cast<double>(r1) * r1 - static_cast<double>(r0) * r0);
+
+        density.x.push_back(center);
+        density.y.push_back(static_cast<float>(mass[bin] / area));
+        radialVelocity.x.push_back(center);
+        radialVelocity.y.push_back(mass[bin] > 0.0 ? static_cast<float>(radialMomentum[bin] / mass[bin]) : 0.0f);
+        tangentialVelocity.x.push_back(center);
+        tangentialVelocity.y.push_back(mass[bin] > 0.0 ? static_cast<float>(tangentialMomentum[bin] / mass[bin]) : 0.0f);
+    }
+    result.AddSeries(std::move(density));
+    result.AddSeries(std::move(radialVelocity));
+    result.AddSeries(std::move(tangentialVelocity));
+}
+
+void LagrangianRadiiAnalysis::Analyze(const AnalysisContext& context, AnalysisResult& result) {
+    for (double fraction : m_fractions) {
+        result.AddScalar("r" + std::to_string(static_cast<int>(std::lround(fraction * 100.0))),
+                         context.GetMassRadius(fraction));
+    }
+}
+
+void VelocityDispersionAnalysis::Analyze(const AnalysisContext& context, AnalysisResult& result) {
+    const auto& snapshot = context.GetSnapshot();
+    const auto& radii = context.GetRadii();
+    const size_t count = context.GetBodyCount();
+    const double totalMass = context.GetTotalMass();
+    if (count == 0 || totalMass <= 0.0) return;
+
+    // Two passes: mass-weighted means, then the spread around them
+    double meanRadial = 0.0;
+    double meanTangential = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec2 radial = context.GetRelativePosition(i) / std::max(radii[i], 1e-12f);
+        glm::vec2 velocity = context.GetRelativeVelocity(i);
+        meanRadial += snapshot.masses[i] * glm::dot(velocity, radial);
+        meanTangential += snapshot.masses[i] * (radial.x * velocity.y - radial.y * velocity.x);
+    }
+    meanRadial /= totalMass;
+    meanTangential /= totalMass;
+
+    double radialVariance = 0.0;
+    double tangentialVariance = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec2 radial = context.GetRelativePosition(i) / std::max(radii[i], 1e-12f);
+        glm::vec2 velocity = context.GetRelativeVelocity(i);
+        double vr = glm::dot(velocity, radial) - meanRadial;
+        double vt = (radial.x * velocity.y - radial.y * velocity.x) - meanTangential;
+        radialVariance += snapshot.masses[i] * vr * vr;
+        tangentialVariance += snapshot.masses[i] * vt * vt;
+    }
+    radialVariance /= totalMass;
+    tangentialVariance /= totalMass;
+
+    result.AddScalar("sigma", std::sqrt(radialVariance + tangentialVariance));
+    result.AddScalar("sigma_radial", std::sqrt(radialVariance));
+    result.AddScalar("sigma_tangential", std::sqrt(tangentialVariance));
+    // beta = 1 - sigma_t^2 / sigma_r^2, undefined for purely circular motion
+    const bool hasRadialSpread = radialVariance > 1e-9 * (radialVariance + tangentialVariance);
+    result.AddScalar("anisotropy", hasRadialSpread ? 1.0 - tangentialVariance / radialVariance : 0.0);
+}
+
+void AngularMomentumAnalysis::Analyze(const AnalysisContext& context, AnalysisResult& result) {
+    const auto& snapshot = context.GetSnapshot();
+    const size_t count = context.GetBodyCount();
+    if (count == 0 || m_binCount <= 0) return;
+
+    std::vector<float> specific(count);
+    double total = 0.0;
+    float minimum = 0.0f;
+    float maximum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec2 position = context.GetRelativePosition(i);
+        glm::vec2 velocity = context.GetRelativeVelocity(i);
+        specific[i] = position.x * velocity.y - position.y * velocity.x;
+        total += snapshot.masses[i] * specific[i];
+        minimum = i == 0 ? specific[i] : std::min(minimum, specific[i]);
+        maximum = i == 0 ? specific[i] : std::max(maximum, specific[i]);
+    }
+
+    // Mass against specific angular momentum, and how much mass orbits against the net spin
+    double counterRotating = 0.0;
+    std::vector<double> histogram(m_binCount, 0.0);
+    const float width = (maximum - minimum) / m_binCount;
+    for (size_t i = 0; i < count; ++i) {
+        if (specific[i] * total < 0.0) counterRotating += snapshot.masses[i];
+        int bin = width > 0.0f ? std::min(m_binCount - 1, static_cast<int>((specific[i] - minimum) / width)) : 0;
+        histogram[bin] += snapshot.masses[i];
+    }
+
+    result.AddScalar("L_total", total);
+    result.AddScalar("j_mean", context.GetTotalMass() > 0.0 ? total / context.GetTotalMass() : 0.0);
+    result.AddScalar("counter_rotating_fraction",
+                     context.GetTotalMass() > 0.0 ? counterRotating / context.GetTotalMass() : 0.0);
+
+    AnalysisSeries distribution{"mass_by_j", {}, {}};
+    for (int bin = 0; bin < m_binCount; ++bin) {
+        distribution.x.push_back(minimum + (bin + 0.5f) * width);
+        distribution.y.push_back(static_cast<float>(histogram[bin]));
+    }
+    result.AddSeries(std::move(distribution));
+}
+
+} // namespace nbody
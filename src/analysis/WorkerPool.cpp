@@ -0,0 +1,72 @@
+#include "analysis/WorkerPool.h"
+#include <algorithm>
+
+namespace nbody {
+
+WorkerPool::WorkerPool(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&WorkerPool::WorkerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+    }
+    m_taskAvailable.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::Run(std::vector<std::function<void()>>& tasks) {
+    if (tasks.empty()) return;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (auto& task : tasks) {
+        m_queue.push_back(std::move(task));
+    }
+    m_unfinished += tasks.size();
+    tasks.clear();
+    m_taskAvailable.notify_all();
+    m_tasksDone.wait(lock, [this]() { return m_unfinished == 0; });
+}
+
+void WorkerPool::ParallelFor(size_t count, const std::function<void(size_t, size_t)>& func) {
+    if (count == 0) return;
+
+    const size_t chunks = std::min(count, m_threads.size());
+    const size_t chunkSize = (count + chunks - 1) / chunks;
+    std::vector<std::function<void()>> tasks;
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        size_t end = std::min(count, begin + chunkSize);
+        tasks.emplace_back([&func, begin, end]() { func(begin, end); });
+    }
+    Run(tasks);
+}
+
+void WorkerPool::WorkerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskAvailable.wait(lock, [this]() { return m_stopRequested || !m_queue.empty(); });
+            if (m_stopRequested && m_queue.empty()) return;
+            task = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        task();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_unfinished == 0) {
+            m_tasksDone.notify_all();
+        }
+    }
+}
+
+} // namespace nbody
@@ -0,0 +1,363 @@
+#include "api/nbody_c.h"
+#include "physics/PhysicsEngine.h"
+#include "core/Body.h"
+#include "core/ConfigFile.h"
+#include <vector>
+#include <memory>
+#include <string>
+#include <cmath>
+#include <exception>
+
+/**
+ * @brief Engine handle behind the C API
+ *
+ * Bodies live in the engine's usual vector of Body objects; the flat arrays
+ * are a contiguous mirror rebuilt lazily after the state changes, so a batch
+ * of steps pays for at most one copy however many steps it contains.
+ */
+struct nbody_engine {
+    nbody::PhysicsEngine physics;
+    std::vector<std::unique_ptr<nbody::Body>> bodies;
+
+    std::vector<float> positions;
+    std::vector<float> velocities;
+    std::vector<float> masses;
+    bool mirrorDirty = true;
+
+    mutable std::string lastError;
+};
+
+namespace {
+
+int Fail(const nbody_engine* engine, int code, const char* message) {
+    if (engine) engine->lastError = message;
+    return code;
+}
+
+template <typename Func>
+int Guard(const nbody_engine* engine, Func&& func) {
+    if (!engine) return NBODY_ERROR_INVALID_ARGUMENT;
+    try {
+        engine->lastError.clear();
+        return func();
+    } catch (const std::exception& e) {
+        return Fail(engine, NBODY_ERROR_INTERNAL, e.what());
+    } catch (...) {
+        return Fail(engine, NBODY_ERROR_INTERNAL, "Unknown exception");
+    }
+}
+
+void UpdateMirror(nbody_engine* engine) {
+    if (!engine->mirrorDirty) return;
+
+    const size_t count = engine->bodies.size();
+    engine->positions.resize(count * 2);
+    engine->velocities.resize(count * 2);
+    engine->masses.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const nbody::Body& body = *engine->bodies[i];
+        engine->positions[2 * i] = body.GetPosition().x;
+        engine->positions[2 * i + 1] = body.GetPosition().y;
+        engine->velocities[2 * i] = body.GetVelocity().x;
+        engine->velocities[2 * i + 1] = body.GetVelocity().y;
+        engine->masses[i] = body.GetMass();
+    }
+    engine->mirrorDirty = false;
+}
+
+bool AllFinite(const float* values, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::isfinite(values[i])) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+extern "C" {
+
+int nbody_api_version(void) {
+    return NBODY_API_VERSION;
+}
+
+nbody_engine* nbody_create(void) {
+    try {
+        // No GL context here: Initialize() is not called, so the GPU path stays disabled
+        return new nbody_engine();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void nbody_destroy(nbody_engine* engine) {
+    delete engine;
+}
+
+const char* nbody_last_error(const nbody_engine* engine) {
+    return engine ? engine->lastError.c_str() : "Invalid engine";
+}
+
+void nbody_default_config(nbody_config* config) {
+    if (!config) return;
+
+    const nbody::PhysicsConfig defaults;
+    config->struct_size = sizeof(nbody_config);
+    config->gravitational_constant = defaults.gravitationalConstant;
+    config->time_step = defaults.timeStep;
+    config->time_scale = defaults.timeScale;
+    config->softening_length = defaults.softeningLength;
+    config->damping_factor = defaults.dampingFactor;
+    config->use_barnes_hut = defaults.useBarnesHut ? 1 : 0;
+    config->barnes_hut_theta = defaults.barnesHutTheta;
+    config->enable_collisions = defaults.enableCollisions ? 1 : 0;
+    config->restitution = defaults.restitution;
+    config->adaptive_time_step = defaults.adaptiveTimeStep ? 1 : 0;
+    config->regularize_close_encounters = defaults.regularizeCloseEncounters ? 1 : 0;
+    config->use_wisdom_holman = defaults.useWisdomHolman ? 1 : 0;
+}
+
+int nbody_get_config(const nbody_engine* engine, nbody_config* config) {
+    return Guard(engine, [&]() {
+        if (!config || config->struct_size < sizeof(nbody_config)) {
+            return Fail(engine, NBODY_ERROR_INVALID_ARGUMENT, "config is NULL or struct_size is too small");
+        }
+
+        const nbody::PhysicsConfig& source = engine->physics.GetConfig();
+        config->gravitational_constant = source.gravitationalConstant;
+        config->time_step = source.timeStep;
+        config->time_scale = source.timeScale;
+        config->softening_length = source.softeningLength;
+        config->damping_factor = source.dampingFactor;
+        config->use_barnes_hut = source.useBarnesHut ? 1 : 0;
+        config->barnes_hut_theta = source.barnesHutTheta;
+        config->enable_collisions = source.enableCollisions ? 1 : 0;
+        config->restitution = source.restitution;
+        config->adaptive_time_step = source.adaptiveTimeStep ? 1 : 0;
+        config->regularize_close_encounters = source.regularizeCloseEncounters ? 1 : 0;
+        config->use_wisdom_holman = source.useWisdomHolman ? 1 : 0;
+        return NBODY_OK;
+    });
+}
+
+int nbody_set_config(nbody_engine* engine, const nbody_config* config) {
+    return Guard(engine, [&]() {
+        if (!config || config->struct_size < sizeof(nbody_config)) {
+            return Fail(engine, NBODY_ERROR_INVALID_ARGUMENT, "config is NULL or struct_size is too small");
+        }
+
+        nbody::PhysicsConfig& target = engine->physics.GetMutableConfig();
+        target.gravitationalConstant = config->gravitational_constant;
+        target.timeStep = config->time_step;
+        target.timeScale = config->time_scale;
+        target.softeningLength = config->softening_length;
+        target.dampingFactor = config->damping_factor;
+        target.useBarnesHut = config->use_barnes_hut != 0;
+        target.barnesHutTheta = config->barnes_hut_theta;
+        target.enableCollisions = config->enable_collisions != 0;
+        target.restitution = config->restitution;
+        target.adaptiveTimeStep = config->adaptive_time_step != 0;
+        target.regularizeCloseEncounters = config->regularize_close_encounters != 0;
+        target.useWisdomHolman = config->use_wisdom_holman != 0;
+        target.useGPU = false;
+        return NBODY_OK;
+    });
+}
+
+int nbody_set_option(nbody_engine* engine, const char* key, const char* value) {
+    return Guard(engine, [&]() {
+        if (!key || !value) {
+            return Fail(engine, NBODY_ERROR_INVALID_ARGUMENT, "key and value must not be NULL");
+        }
+
+        nbody::PhysicsConfig config = engine->physics.GetConfig();
+        if (!nbody::ConfigFile::ApplyPhysicsValue(key, value, config)) {
+            return Fail(engine, NBODY_ERROR_UNKNOWN_OPTION, "Unknown option");
+        }
+        config.useGPU = false;
+        engine->physics.SetConfig(config);
+        return NBODY_OK;
+    });
+}
+
+int nbody_set_bodies(nbody_engine* engine, size_t count, const float* positions, const float* velocities,
+                     const float* masses, const float* densities) {
+    return Guard(engine, [&]() {
+        if (count > 0 && (!positions || !velocities || !masses)) {
+            return Fail(engine, NBODY_ERROR_INVALID_ARGUMENT, "positions, velocities and masses are required");
+        }
+        if (!AllFinite(positions, count * 2) || !AllFinite(velocities, count * 2) || !AllFinite(masses, count)) {
+            return Fail(engine, NBODY_ERROR_INVALID_ARGUMENT, "State contains non-finite values");
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (masses[i] <= 0.0f || (densities && !(densities[i] > 0.0f))) {
+                return Fail(engine, NBODY_ERROR_INVALID_ARGUMENT, "Masses and densities must be positive");
+            }
+        }
+
+        engine->bodies.clear();
+        engine->bodies.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto body = std::make_unique<nbody::Body>(
+                glm::vec2(positions[2 * i], positions[2 * i + 1]),
+                glm::vec2(velocities[2 * i], velocities[2 * i + 1]),
+                masses[i]);
+            if (densities) {
+                body->SetDensity(densities[i]);
+            }
+            engine->bodies.push_back(std::move(body));
+        }
+        engine->physics.InvalidateConservation();
+        engine->mirrorDirty = true;
+        return NBODY_OK;
+    });
+}
+
+int nbody_set_velocities(nbody_engine* engine, size_t count, const float* velocities) {
+    return Guard(engine, [&]() {
+        if (count != engine->bodies.size() || (count > 0 && !velocities)) {
+            return Fail(engine, NBODY_ERROR_INVALID_ARGUMENT, "count must match the body count");
+        }
+        if (!AllFinite(velocities, count * 2)) {
+            return Fail(engine, NBODY_ERROR_INVALID_ARGUMENT, "Velocities contain non-finite values");
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            engine->bodies[i]->SetVelocity(glm::vec2(velocities[2 * i], velocities[2 * i + 1]));
+        }
+        engine->physics.InvalidateConservation();
+        engine->mirrorDirty = true;
+        return NBODY_OK;
+    });
+}
+
+size_t nbody_get_body_count(const nbody_engine* engine) {
+    return engine ? engine->bodies.size() : 0;
+}
+
+int nbody_get_positions(const nbody_engine* engine, float* positions, size_t capacity) {
+    return Guard(engine, [&]() {
+        const size_t count = engine->bodies.size();
+        if (count > 0 && !positions) return Fail(engine, NBODY_ERROR_INVALID_ARGUMENT, "positions is NULL");
+        if (capacity < count) return Fail(engine, NBODY_ERROR_BUFFER_TOO_SMALL, "Buffer smaller than the body count");
+
+        for (size_t i = 0; i < count; ++i) {
+            positions[2 * i] = engine->bodies[i]->GetPosition().x;
+            positions[2 * i + 1] = engine->bodies[i]->GetPosition().y;
+        }
+        return NBODY_OK;
+    });
+}
+
+int nbody_get_velocities(const nbody_engine* engine, float* velocities, size_t capacity) {
+    return Guard(engine, [&]() {
+        const size_t count = engine->bodies.size();
+        if (count > 0 && !velocities) return Fail(engine, NBODY_ERROR_INVALID_ARGUMENT, "velocities is NULL");
+        if (capacity < count) return Fail(engine, NBODY_ERROR_BUFFER_TOO_SMALL, "Buffer smaller than the body count");
+
+        for (size_t i = 0; i < count; ++i) {
+            velocities[2 * i] = engine->bodies[i]->GetVelocity().x;
+            velocities[2 * i + 1] = engine->bodies[i]->GetVelocity().y;
+        }
+        return NBODY_OK;
+    });
+}
+
+int nbody_get_masses(const nbody_engine* engine, float* masses, size_t capacity) {
+    return Guard(engine, [&]() {
+        const size_t count = engine->bodies.size();
+        if (count > 0 && !masses) return Fail(engine, NBODY_ERROR_INVALID_ARGUMENT, "masses is NULL");
+        if (capacity < count) return Fail(engine, NBODY_ERROR_BUFFER_TOO_SMALL, "Buffer smaller than the body count");
+
+        for (size_t i = 0; i < count; ++i) {
+            masses[i] = engine->bodies[i]->GetMass();
+        }
+        return NBODY_OK;
+    });
+}
+
+const float* nbody_positions_view(nbody_engine* engine) {
+    if (!engine || engine->bodies.empty()) return nullptr;
+    try {
+        UpdateMirror(engine);
+    } catch (...) {
+        return nullptr;
+    }
+    return engine->positions.data();
+}
+
+const float* nbody_velocities_view(nbody_engine* engine) {
+    if (!engine || engine->bodies.empty()) return nullptr;
+    try {
+        UpdateMirror(engine);
+    } catch (...) {
+        return nullptr;
+    }
+    return engine->velocities.data();
+}
+
+const float* nbody_masses_view(nbody_engine* engine) {
+    if (!engine || engine->bodies.empty()) return nullptr;
+    try {
+        UpdateMirror(engine);
+    } catch (...) {
+        return nullptr;
+    }
+    return engine->masses.data();
+}
+
+int nbody_step(nbody_engine* engine, int steps, float delta_time) {
+    return Guard(engine, [&]() {
+        if (steps < 0 || !(delta_time >= 0.0f)) {
+            return Fail(engine, NBODY_ERROR_INVALID_ARGUMENT, "steps and delta_time must not be negative");
+        }
+
+        for (int i = 0; i < steps; ++i) {
+            engine->physics.Update(engine->bodies, delta_time);
+        }
+        if (steps > 0) engine->mirrorDirty = true;
+        return NBODY_OK;
+    });
+}
+
+int nbody_reset_clock(nbody_engine* engine) {
+    return Guard(engine, [&]() {
+        engine->physics.Reset();
+        return NBODY_OK;
+    });
+}
+
+int nbody_get_stats(const nbody_engine* engine, nbody_stats* stats) {
+    return Guard(engine, [&]() {
+        if (!stats || stats->struct_size < sizeof(nbody_stats)) {
+            return Fail(engine, NBODY_ERROR_INVALID_ARGUMENT, "stats is NULL or struct_size is too small");
+        }
+
+        const nbody::PhysicsStats& source = engine->physics.GetStats();
+        stats->step = engine->physics.GetStepCount();
+        stats->time = engine->physics.GetSimulationTime();
+        stats->total_ms = source.totalTime;
+        stats->force_ms = source.forceCalculationTime;
+        stats->integration_ms = source.integrationTime;
+        stats->collision_ms = source.collisionTime;
+        stats->body_count = static_cast<int32_t>(engine->bodies.size());
+        stats->force_calculations = source.forceCalculations;
+        stats->collisions = source.collisions;
+        stats->kinetic_energy = 0.0;
+        stats->potential_energy = 0.0;
+        return NBODY_OK;
+    });
+}
+
+int nbody_get_stats_with_energy(const nbody_engine* engine, nbody_stats* stats) {
+    int result = nbody_get_stats(engine, stats);
+    if (result != NBODY_OK) return result;
+
+    return Guard(engine, [&]() {
+        nbody::EnergyStats energy = engine->physics.CalculateEnergyStats(engine->bodies);
+        stats->kinetic_energy = energy.kinetic;
+        stats->potential_energy = energy.potential;
+        return NBODY_OK;
+    });
+}
+
+} // extern "C"
@@ -1,6 +1,18 @@
 #include "core/Application.h"
 #include "core/Body.h"
+#include "core/RewindBuffer.h"
+#include "core/CheckpointManager.h"
+#include "core/SharedStatePublisher.h"
+#include "core/PresetCache.h"
+#include "core/IncrementalJob.h"
+#include "analysis/AnalysisPipeline.h"
+#include "analysis/FriendsOfFriends.h"
+#include "analysis/PotentialField.h"
+#include "analysis/BodyTable.h"
+#include "analysis/PotentialEnergy.h"
+#include "core/ConfigFile.h"
 #include "physics/PhysicsEngine.h"
+#include "physics/OrbitPredictor.h"
 #include "rendering/Renderer.h"
 #include "ui/UIManager.h"
 
@@ -69,6 +81,16 @@ bool Application::Initialize() {
     m_physics = std::make_unique<PhysicsEngine>();
     m_renderer = std::make_unique<Renderer>();
     m_ui = std::make_unique<UIManager>();
+    m_rewind = std::make_unique<RewindBuffer>();
+    m_checkpoints = std::make_unique<CheckpointManager>();
+    m_jobs = std::make_unique<JobScheduler>();
+    m_energyJob = std::make_unique<PotentialEnergyJob>(*m_physics);
+    m_jobs->Add(m_energyJob.get(), 1, [this]() {
+        m_ui->SetEnergyStats(m_energyJob->GetStats(), m_energyJob->GetStep(),
+                             m_energyJob->GetSimulationTime());
+    });
+    m_presetCache = std::make_unique<PresetCache>();
+    m_presetCacheBytes = m_presetCache->GetDiskUsage();
 
     if (!m_physics->Initialize()) {
         std::cerr << "Failed to initialize physics engine" << std::endl;
@@ -85,6 +107,8 @@ bool Application::Initialize() {
         return false;
     }
     
+    m_rewind->Start();
+    
     // Reserve memory for bodies to avoid frequent reallocations
     m_bodies.reserve(1000); // Reserve space for up to 1000 bodies initially
     
@@ -115,12 +139,140 @@ bool Application::Initialize() {
         // Reset bodies to initial state if needed
     };
     
-    m_ui->OnClear = [this]() { ClearBodies(); };
+    m_ui->OnClear = [this]() {
+        ClearBodies();
+        ResetHistory();
+    };
     
     m_ui->OnLoadPreset = [this](const std::string& preset) { LoadPreset(preset); };
     
     m_ui->OnDeleteBody = [this](Body* body) { RemoveBody(body); };
     
+    // Checkpoint callbacks
+    m_ui->OnCheckpoint = [this]() {
+        m_checkpoints->Request(m_bodies, m_physics->GetStepCount(), m_physics->GetSimulationTime(), true);
+    };
+    
+    m_ui->OnRestoreCheckpoint = [this]() { RestoreLatestCheckpoint(); };
+    
+    m_ui->OnCheckpointIntervalChanged = [this](float seconds) {
+        m_checkpoints->GetMutableConfig().autoIntervalSeconds = seconds;
+    };
+    
+    m_ui->OnSharedStateChanged = [this](bool enabled, int interval) {
+        if (!enabled) {
+            m_sharedState.reset();
+            return;
+        }
+        if (!m_sharedState) {
+            m_sharedState = std::make_unique<SharedStatePublisher>();
+            if (!m_sharedState->Open()) {
+                m_sharedState.reset();
+                return;
+            }
+            // Readers get the current state right away, even while paused
+            m_sharedState->Publish(m_bodies, m_physics->GetStepCount(), m_physics->GetSimulationTime(), true);
+        }
+        m_sharedState->SetPublishInterval(interval);
+    };
+    
+    m_ui->OnAnalysisChanged = [this](bool enabled, int interval) {
+        if (!enabled) {
+            m_analysis.reset();
+            return;
+        }
+        if (!m_analysis) {
+            AnalysisConfig config;
+            config.interval = interval;
+            m_analysis = std::make_unique<AnalysisPipeline>(config);
+            m_analysis->RegisterStandardModules();
+            m_analysis->Start();
+            m_analysis->Submit(m_bodies, m_physics->GetStepCount(), m_physics->GetSimulationTime(), true);
+        }
+        m_analysis->SetInterval(interval);
+    };
+    
+    m_ui->OnGroupFinderChanged = [this](bool enabled, const FoFConfig& config, int interval, bool colorByGroup) {
+        if (!enabled) {
+            if (m_groupFinder) {
+                m_jobs->Remove(m_groupFinder.get());
+            }
+            m_groupFinder.reset();
+            m_groups.reset();
+            m_renderer->ClearBodyColorOverride();
+            return;
+        }
+        m_groupFinderInterval = std::max(1, interval);
+        if (!m_groupFinder) {
+            m_groupFinder = std::make_unique<FriendsOfFriends>(config);
+            m_groups = std::make_unique<FoFResult>();
+            m_jobs->Add(m_groupFinder.get(), static_cast<uint64_t>(m_groupFinderInterval), [this]() { ApplyGroups(); });
+        }
+        m_groupFinder->SetConfig(config);
+        m_jobs->SetInterval(m_groupFinder.get(), static_cast<uint64_t>(m_groupFinderInterval));
+        m_colorByGroup = colorByGroup;
+        // Regroup right away so changes show even while paused
+        m_jobs->Restart(m_groupFinder.get());
+    };
+    
+    m_ui->OnJobBudgetChanged = [this](float milliseconds) {
+        m_jobs->SetSliceMs(milliseconds);
+    };
+    
+    m_ui->OnOrbitPredictionChanged = [this](bool enabled, float horizon) {
+        m_renderer->ClearPredictedPath();
+        m_predictedBody = nullptr; // Forces a fresh prediction on the next frame
+        if (!enabled) {
+            m_orbitPredictor.reset();
+            return;
+        }
+        if (!m_orbitPredictor) {
+            m_orbitPredictor = std::make_unique<OrbitPredictor>();
+        }
+        m_predictionHorizon = horizon;
+    };
+    
+    m_ui->OnBodyTableChanged = [this](bool open, const BodyTableQuery& query) {
+        if (!open) {
+            m_bodyTable.reset();
+            m_bodyTableQuery.reset();
+            return;
+        }
+        if (!m_bodyTable) {
+            m_bodyTable = std::make_unique<BodyTableSorter>();
+        }
+        m_bodyTableQuery = std::make_unique<BodyTableQuery>(query);
+        m_bodyTableDirty = true;
+    };
+    
+    m_ui->OnSelectBody = [this](size_t index) {
+        if (index >= m_bodies.size()) return;
+        m_selectedBody = m_bodies[index].get();
+        m_renderer->CenterOnBody(m_selectedBody);
+    };
+    
+    m_ui->OnFastForwardChanged = [this](bool enabled) {
+        m_fastForward = enabled;
+        m_nextFastForwardFrame = std::chrono::high_resolution_clock::now();
+    };
+    
+    m_ui->OnFieldOverlayChanged = [this](bool enabled, int contourLevels) {
+        m_renderer->ClearFieldContours();
+        m_fieldRequested = false;
+        m_fieldSamples = 0;
+        if (!enabled) {
+            m_fieldSampler.reset();
+            return;
+        }
+        PotentialFieldConfig config;
+        config.contourLevels = contourLevels;
+        if (!m_fieldSampler) {
+            m_fieldSampler = std::make_unique<PotentialFieldSampler>(config);
+        } else {
+            m_fieldSampler->SetConfig(config);
+        }
+    };
+    
     m_ui->OnPhysicsParameterChanged = [this]() {
         // Update physics parameters from UI
         auto& config = m_physics->GetMutableConfig();
@@ -130,8 +282,16 @@ bool Application::Initialize() {
         config.softeningLength = m_ui->GetSofteningLength();
         config.useBarnesHut = m_ui->GetUseBarnesHut();
         config.barnesHutTheta = m_ui->GetBarnesHutTheta();
+        config.useKDTree = m_ui->GetUseKDTree();
         config.enableCollisions = m_ui->GetEnableCollisions();
+        config.treeCollisions = m_ui->GetTreeCollisions();
+        config.useNeighborLists = m_ui->GetUseNeighborLists();
+        config.continuousCollisions = m_ui->GetContinuousCollisions();
+        config.useEventDriven = m_ui->GetUseEventDriven();
+        config.neighborSkin = m_ui->GetNeighborSkin();
         config.restitution = m_ui->GetRestitution();
+        config.regularizeCloseEncounters = m_ui->GetRegularizeCloseEncounters();
+        config.useWisdomHolman = m_ui->GetUseWisdomHolman();
     };
     
     // Initial sync: First sync UI from engines, then sync engines from UI
@@ -163,7 +323,18 @@ bool Application::Initialize() {
     };
     
     m_ui->OnSpawnBodies = [this](int count, int pattern) {
-        SpawnBodies(count, pattern);
+        SpawnBodies(count, pattern, m_ui->GetSpawnSeed());
+        // Next spawn lands elsewhere; set the seed back to repeat (and reload) a spawn
+        m_ui->SetSpawnSeed(m_ui->GetSpawnSeed() + 1);
+    };
+    
+    m_ui->OnPresetCacheChanged = [this](bool enabled) {
+        m_presetCache->SetEnabled(enabled);
+    };
+    
+    m_ui->OnClearPresetCache = [this]() {
+        m_presetCache->Clear();
+        m_presetCacheBytes = m_presetCache->GetDiskUsage();
     };
     
     m_ui->OnSetCameraPosition = [this](const glm::vec2& position) {
@@ -191,8 +362,11 @@ bool Application::Initialize() {
         for (auto& body : m_bodies) {
             body->SetMaxTrailLength(length);
         }
+        MarkBodiesChanged();
     };
     
+    m_ui->OnRewindToFrame = [this](int frame) { RestoreRewindFrame(frame); };
+    
     // Performance benchmarking
     m_ui->OnRunBenchmark = [this]() {
         if (m_physics) {
@@ -225,7 +399,20 @@ void Application::Run() {
         // Cap delta time to prevent large jumps
         m_deltaTime = std::min(m_deltaTime, 0.033f); // Max 30 FPS
 
-        glfwPollEvents();
+        // Paused with nothing in flight: sleep until input arrives
+        if (IsIdle()) {
+            glfwWaitEventsTimeout(IDLE_FRAME_SECONDS);
+        } else {
+            glfwPollEvents();
+        }
+        
+        // Fast forward steps the physics until the next frame is due and skips
+        // drawing entirely while the window is minimized
+        bool fastForward = m_fastForward && m_running && !m_paused;
+        if (fastForward && !AdvanceFastForward(window)) {
+            UpdateSimulationRate();
+            continue;
+        }
         
         Update(m_deltaTime);
         Render();
@@ -233,10 +420,83 @@ void Application::Run() {
         glfwSwapBuffers(window);
         
         UpdatePerformanceMetrics();
+        UpdateSimulationRate();
+    }
+}
+
+bool Application::IsIdle() const {
+    // Background workers publish whenever they finish; a frame every
+    // IDLE_FRAME_SECONDS is soon enough to pick that up
+    const Camera& camera = m_renderer->GetCamera();
+    return (!m_running || m_paused) && !m_draggedBody && !m_jobs->IsBusy() && camera.zoom == camera.targetZoom;
+}
+
+bool Application::AdvanceFastForward(GLFWwindow* window) {
+    auto now = std::chrono::high_resolution_clock::now();
+    bool minimized = glfwGetWindowAttrib(window, GLFW_ICONIFIED) != 0;
+    
+    auto batchEnd = minimized ? now + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+                                          std::chrono::duration<double>(MINIMIZED_BATCH_SECONDS))
+                              : m_nextFastForwardFrame;
+    do {
+        UpdatePhysics(FAST_FORWARD_STEP);
+    } while (std::chrono::high_resolution_clock::now() < batchEnd);
+    
+    if (minimized) return false;
+    
+    // Frames are paced from the last one drawn, so a slow step never queues a burst of them
+    now = std::chrono::high_resolution_clock::now();
+    m_nextFastForwardFrame = now + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+                                       std::chrono::duration<double>(1.0 / FAST_FORWARD_FPS));
+    return true;
+}
+
+void Application::UpdateSimulationRate() {
+    auto now = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double>(now - m_rateWindowStart).count();
+    if (elapsed < RATE_WINDOW_SECONDS) return;
+    
+    // The clock runs backwards after a reset or rewind; skip that window
+    double simulated = m_physics->GetSimulationTime() - m_rateWindowSimulationTime;
+    uint64_t steps = m_physics->GetStepCount() - m_rateWindowSteps;
+    if (simulated >= 0.0 && m_physics->GetStepCount() >= m_rateWindowSteps) {
+        m_simulationRate = simulated / elapsed;
+        m_stepsPerSecond = steps / elapsed;
+    }
+    m_rateWindowStart = now;
+    m_rateWindowSimulationTime = m_physics->GetSimulationTime();
+    m_rateWindowSteps = m_physics->GetStepCount();
+}
+
+void Application::SampleTrails() {
+    double now = m_physics->GetSimulationTime();
+    double interval = TRAIL_SAMPLE_INTERVAL * m_physics->GetConfig().timeScale;
+    // A clock that went backwards (reset, rewind) samples at once
+    bool clockReset = now < m_lastTrailSample;
+    if (!clockReset && (now == m_lastTrailSample || now - m_lastTrailSample < interval)) return;
+    m_lastTrailSample = now;
+    
+    const int count = static_cast<int>(m_bodies.size());
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; ++i) {
+        m_bodies[i]->AddTrailPoint();
     }
 }
 
 void Application::Shutdown() {
+    if (m_rewind) {
+        m_rewind->Stop();
+    }
+    m_rewind.reset();
+    m_checkpoints.reset(); // Waits for an in-flight checkpoint
+    m_sharedState.reset();
+    m_analysis.reset();
+    m_jobs.reset();
+    m_energyJob.reset();
+    m_groupFinder.reset();
+    m_orbitPredictor.reset();
+    m_fieldSampler.reset();
+    m_bodyTable.reset();
     m_bodies.clear();
     m_ui.reset();
     m_renderer.reset();
@@ -248,14 +508,34 @@ void Application::Shutdown() {
 void Application::Update(float deltaTime) {
     HandleInput();
     
-    if (m_running && !m_paused) {
+    if (m_running && !m_paused && !m_fastForward) {
         UpdatePhysics(deltaTime);
     }
     
     // Update camera
     m_renderer->GetCamera().Update(deltaTime);
     
+    // Bodies loaded in bulk (presets, configuration files) bypass AddBody
+    if (m_bodies.size() != m_trackedBodyCount) {
+        m_trackedBodyCount = m_bodies.size();
+        MarkBodiesChanged();
+    }
+    
+    m_jobs->Update(m_bodies, m_physics->GetStepCount(), m_bodiesGeneration);
+    
     UpdateUI();
+    
+    if (m_orbitPredictor) {
+        UpdateOrbitPrediction();
+    }
+    
+    if (m_fieldSampler) {
+        UpdateFieldOverlay();
+    }
+    
+    if (m_bodyTable) {
+        UpdateBodyTable();
+    }
 }
 
 void Application::Render() {
@@ -263,6 +543,7 @@ void Application::Render() {
     glClear(GL_COLOR_BUFFER_BIT);
     
     // Render simulation
+    m_renderer->SetStateGeneration(m_bodiesGeneration);
     auto stats = m_renderer->Render(m_bodies, *m_physics, m_selectedBody);
     
     // Render UI
@@ -314,11 +595,219 @@ void Application::HandleInput() {
     deleteKeyPressed = deleteKeyDown;
 }
 
+void Application::MarkBodiesChanged() {
+    ++m_bodiesGeneration;
+    // Edits between steps leave the engine's sums from the last step behind
+    m_physics->InvalidateConservation();
+}
+
 void Application::UpdatePhysics(float deltaTime) {
+    // Resuming from a restored frame starts a new branch of the history
+    if (m_rewindBranchPending) {
+        m_rewind->TruncateAfter(static_cast<uint64_t>(m_rewindFrame));
+        m_rewindBranchPending = false;
+    }
+    m_rewindFrame = -1;
+    
     m_physics->Update(m_bodies, deltaTime);
+    // Not MarkBodiesChanged(): the step has just refreshed the conservation sums
+    ++m_bodiesGeneration;
+    m_forceTreeGeneration = m_bodiesGeneration;
+    
+    if (m_renderer->GetShowTrails()) {
+        SampleTrails();
+    }
+    
+    int captureInterval = m_rewind->GetConfig().captureInterval;
+    if (m_physics->GetStepCount() % static_cast<uint64_t>(captureInterval) == 0) {
+        m_rewind->Capture(m_bodies, m_physics->GetStepCount(), m_physics->GetSimulationTime());
+    }
+    
+    if (m_sharedState) {
+        m_sharedState->Publish(m_bodies, m_physics->GetStepCount(), m_physics->GetSimulationTime());
+    }
+    if (m_analysis) {
+        m_analysis->Submit(m_bodies, m_physics->GetStepCount(), m_physics->GetSimulationTime());
+    }
+    // Forks at the step boundary; the simulation continues while the child writes
+    m_checkpoints->Update(m_bodies, m_physics->GetStepCount(), m_physics->GetSimulationTime());
+}
+
+void Application::ApplyGroups() {
+    m_groupFinder->TakeResult(*m_groups);
+    
+    // Bodies added or removed since the snapshot; a fresh pass is already due
+    if (!m_colorByGroup || m_groups->groupIds.size() != m_bodies.size()) {
+        m_renderer->ClearBodyColorOverride();
+        return;
+    }
+    std::vector<glm::vec3> colors(m_bodies.size());
+    for (size_t i = 0; i < colors.size(); ++i) {
+        colors[i] = FriendsOfFriends::GetGroupColor(m_groups->groupIds[i]);
+    }
+    m_renderer->SetBodyColorOverride(std::move(colors));
+}
+
+const BarnesHutTree* Application::CurrentForceTree() const {
+    // The quadtree of the last step's force pass describes the bodies only until
+    // they are edited (e.g. dragged while paused)
+    if (m_forceTreeGeneration != m_bodiesGeneration) {
+        return nullptr;
+    }
+    return m_physics->GetBarnesHutTree();
+}
+
+void Application::UpdateOrbitPrediction() {
+    if (!m_selectedBody) {
+        if (m_predictedBody) {
+            m_orbitPredictor->Cancel();
+            m_renderer->ClearPredictedPath();
+            m_predictedBody = nullptr;
+        }
+        return;
+    }
+    
+    // Dragging re-integrates through the frozen field; a new field is only taken
+    // for a new selection or once the simulation has moved on for a while
+    auto now = std::chrono::steady_clock::now();
+    bool selectionChanged = m_selectedBody != m_predictedBody;
+    bool dragged = m_draggedBody == m_selectedBody && m_selectedBody->GetPosition() != m_predictedFrom;
+    bool refreshDue = m_bodiesGeneration != m_predictedGeneration &&
+                      std::chrono::duration<double>(now - m_lastPrediction).count() >= PREDICTION_REFRESH_SECONDS;
+    
+    if (selectionChanged || dragged || refreshDue) {
+        if (m_predictedIndex >= m_bodies.size() || m_bodies[m_predictedIndex].get() != m_selectedBody) {
+            auto found = std::find_if(m_bodies.begin(), m_bodies.end(),
+                                      [this](const std::unique_ptr<Body>& body) { return body.get() == m_selectedBody; });
+            m_predictedIndex = static_cast<size_t>(found - m_bodies.begin());
+        }
+        if (m_predictedIndex < m_bodies.size()) {
+            const auto& config = m_physics->GetConfig();
+            OrbitPredictor::Settings settings;
+            settings.G = config.gravitationalConstant;
+            settings.softeningLength = config.softeningLength;
+            settings.horizon = m_predictionHorizon;
+            
+            m_orbitPredictor->Request(m_bodies, m_predictedIndex, CurrentForceTree(), settings,
+                                      selectionChanged || refreshDue);
+            
+            m_predictedBody = m_selectedBody;
+            m_predictedFrom = m_selectedBody->GetPosition();
+            m_predictedGeneration = m_bodiesGeneration;
+            m_lastPrediction = now;
+        }
+    }
+    
+    std::vector<glm::vec2> path;
+    if (m_orbitPredictor->FetchPath(path)) {
+        m_predictedPoints = path.size();
+        m_renderer->SetPredictedPath(std::move(path), m_selectedBody->GetColor());
+    }
+}
+
+void Application::UpdateFieldOverlay() {
+    glm::vec2 minimum, maximum;
+    m_renderer->GetVisibleWorldBounds(minimum, maximum);
+    
+    // Re-sample at once when the view moved noticeably, otherwise only now and
+    // then while the simulation runs, so the worker can finish its refinement
+    auto now = std::chrono::steady_clock::now();
+    float tolerance = FIELD_VIEW_TOLERANCE * (maximum.x - minimum.x);
+    glm::vec2 drift = glm::max(glm::abs(minimum - m_fieldMin), glm::abs(maximum - m_fieldMax));
+    bool viewChanged = std::max(drift.x, drift.y) > tolerance;
+    bool refreshDue = m_bodiesGeneration != m_fieldGeneration &&
+                      std::chrono::duration<double>(now - m_lastFieldRequest).count() >= FIELD_REFRESH_SECONDS;
+    
+    if (!m_fieldRequested || viewChanged || refreshDue) {
+        const auto& config = m_physics->GetConfig();
+        m_fieldSampler->Request(CurrentForceTree(), m_bodies, minimum, maximum, config.gravitationalConstant,
+                                config.softeningLength);
+        
+        m_fieldMin = minimum;
+        m_fieldMax = maximum;
+        m_fieldGeneration = m_bodiesGeneration;
+        m_fieldRequested = true;
+        m_lastFieldRequest = now;
+    }
+    
+    PotentialContours contours;
+    if (m_fieldSampler->FetchContours(contours)) {
+        m_fieldRefinement = contours.refinementLevel;
+        m_fieldSamples = contours.samples;
+        m_renderer->SetFieldContours(std::move(contours.segments), std::move(contours.levelOffsets));
+    }
+}
+
+void Application::UpdateBodyTable() {
+    // A region filter follows the view
+    if (m_bodyTableQuery->inRegion) {
+        glm::vec2 minimum, maximum;
+        m_renderer->GetVisibleWorldBounds(minimum, maximum);
+        if (minimum != m_bodyTableQuery->regionMin || maximum != m_bodyTableQuery->regionMax) {
+            m_bodyTableQuery->regionMin = minimum;
+            m_bodyTableQuery->regionMax = maximum;
+            m_bodyTableDirty = true;
+        }
+    }
+    
+    // Taking the keys is the one part done on this thread, so with millions of
+    // bodies refresh less often rather than let it eat into the frame rate
+    auto now = std::chrono::steady_clock::now();
+    double interval = std::max(BODY_TABLE_REFRESH_SECONDS, BODY_TABLE_COST_RATIO * m_bodyTableRequestSeconds);
+    bool refreshDue = m_bodiesGeneration != m_bodyTableGeneration &&
+                      std::chrono::duration<double>(now - m_lastBodyTableRequest).count() >= interval;
+    
+    if (m_bodyTableDirty || refreshDue) {
+        m_bodyTable->Request(m_bodies, *m_bodyTableQuery, m_physics->GetStepCount());
+        m_bodyTableRequestSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - now).count();
+        m_bodyTableDirty = false;
+        m_bodyTableGeneration = m_bodiesGeneration;
+        m_lastBodyTableRequest = now;
+    }
+    
+    BodyTableRows rows;
+    if (m_bodyTable->FetchRows(rows)) {
+        m_ui->SetBodyTableRows(std::move(rows));
+    }
 }
 
 void Application::UpdateUI() {
+    // Follow the newest frame unless a restored frame is being inspected
+    int rewindFrames = static_cast<int>(m_rewind->GetFrameCount());
+    int rewindFrame = rewindFrames - 1;
+    if (m_rewindFrame >= 0) {
+        // The restored frame's position shifts as older segments are evicted; 0 once it is gone
+        size_t index = 0;
+        rewindFrame = m_rewind->GetFrameIndex(static_cast<uint64_t>(m_rewindFrame), index) ? static_cast<int>(index) : 0;
+    }
+    m_ui->SetRewindState(rewindFrames, std::max(0, rewindFrame), m_rewind->GetMemoryUsage());
+    
+    // Pick up finished checkpoint writers even while paused
+    m_checkpoints->Poll();
+    m_ui->SetSharedStateStatus(m_sharedState != nullptr, m_sharedState ? m_sharedState->GetFramesPublished() : 0);
+    m_ui->SetCheckpointStatus(m_checkpoints->GetStatus(),
+                              static_cast<float>(m_checkpoints->GetConfig().autoIntervalSeconds));
+    if (m_analysis) {
+        m_ui->SetAnalysisStatus(true, m_analysis->GetCompletedCount(), m_analysis->GetDroppedCount(),
+                                m_analysis->GetLastDurationMs(), m_analysis->GetLatestResults());
+    }
+    if (m_groupFinder) {
+        std::vector<FoFGroup> largest(m_groups->groups.begin(),
+                                      m_groups->groups.begin() + std::min<size_t>(m_groups->groups.size(), 10));
+        m_ui->SetGroupFinderStatus(m_groups->groups.size(), m_groups->ungroupedCount, m_groups->elapsedMs,
+                                   std::move(largest));
+    }
+    if (m_orbitPredictor) {
+        m_ui->SetOrbitPredictionStatus(m_predictedPoints, m_orbitPredictor->GetSourceCount(),
+                                       m_orbitPredictor->GetLastDurationMs());
+    }
+    m_ui->SetSimulationRate(m_simulationRate, m_stepsPerSecond);
+    m_ui->SetJobStatus(m_jobs->GetStatus());
+    if (m_fieldSampler) {
+        m_ui->SetFieldOverlayStatus(m_fieldSamples, m_fieldRefinement, m_fieldSampler->GetLastDurationMs());
+    }
+    m_ui->SetPresetCacheStatus(m_presetCache->GetHits(), m_presetCache->GetLastLoadMs(), m_presetCacheBytes);
+    
     // Update world mouse position
     m_worldMousePosition = m_renderer->ScreenToWorld(m_mousePosition);
     
@@ -332,6 +821,7 @@ void Application::UpdateUI() {
         m_draggedBody->SetPosition(m_worldMousePosition);
         m_draggedBody->SetVelocity(glm::vec2(0.0f)); // Stop the body when dragging
         m_draggedBody->SetBeingDragged(true);
+        MarkBodiesChanged();
     }
     
     // Apply UI settings to renderer (only when needed)
@@ -453,6 +943,15 @@ void Application::OnKeyboard(int key, int /*scancode*/, int action, int /*mods*/
                 break;
             case GLFW_KEY_C:
                 ClearBodies();
+                ResetHistory();
+                break;
+            case GLFW_KEY_F:
+                m_fastForward = !m_fastForward;
+                m_nextFastForwardFrame = std::chrono::high_resolution_clock::now();
+                m_ui->SetFastForward(m_fastForward);
+                break;
+            case GLFW_KEY_F5:
+                m_checkpoints->Request(m_bodies, m_physics->GetStepCount(), m_physics->GetSimulationTime(), true);
                 break;
             case GLFW_KEY_DELETE:
                 if (m_selectedBody != nullptr) {
@@ -474,6 +973,7 @@ void Application::OnWindowResize(int width, int height) {
 void Application::AddBody(const glm::vec2& position, const glm::vec2& velocity, float mass) {
     auto body = std::make_unique<Body>(position, velocity, mass, m_ui->GetNewBodyColor());
     m_bodies.push_back(std::move(body));
+    MarkBodiesChanged();
 }
 
 void Application::AddBody(const glm::vec2& position, const glm::vec2& velocity, float mass, 
@@ -481,6 +981,7 @@ void Application::AddBody(const glm::vec2& position, const glm::vec2& velocity,
     auto body = std::make_unique<Body>(position, velocity, mass, color);
     body->SetDensity(density);
     m_bodies.push_back(std::move(body));
+    MarkBodiesChanged();
 }
 
 void Application::RemoveBody(Body* body) {
@@ -495,15 +996,62 @@ void Application::RemoveBody(Body* body) {
             m_draggedBody = nullptr;
         }
         m_bodies.erase(it);
+        MarkBodiesChanged();
     }
 }
 
 void Application::ClearBodies() {
     m_bodies.clear();
+    MarkBodiesChanged();
     m_selectedBody = nullptr;
     m_draggedBody = nullptr;
 }
 
+void Application::RestoreRewindFrame(int frameIndex) {
+    SimulationSnapshot snapshot;
+    uint64_t frameId = 0;
+    if (frameIndex < 0 || !m_rewind->GetFrameId(static_cast<size_t>(frameIndex), frameId) ||
+        !m_rewind->Restore(frameId, snapshot)) {
+        return;
+    }
+    
+    ClearBodies();
+    snapshot.Restore(m_bodies);
+    m_physics->SetSimulationClock(snapshot.step, snapshot.time);
+    
+    // Stay on the restored frame until the user resumes
+    if (m_running) {
+        m_paused = true;
+    }
+    m_rewindFrame = static_cast<int64_t>(frameId);
+    m_rewindBranchPending = true;
+}
+
+void Application::ResetHistory() {
+    m_rewind->Clear();
+    m_physics->SetSimulationClock(0, 0.0);
+    m_rewindFrame = -1;
+    m_rewindBranchPending = false;
+    m_ui->ResetEnergyHistory();
+    m_jobs->RestartAll();
+}
+
+void Application::RestoreLatestCheckpoint() {
+    std::string filename = m_checkpoints->GetLatestFile();
+    SimulationSnapshot snapshot;
+    if (filename.empty() || !CheckpointManager::Load(filename, snapshot)) {
+        std::cerr << "Failed to load checkpoint: " << filename << std::endl;
+        return;
+    }
+    
+    ClearBodies();
+    ResetHistory();
+    snapshot.Restore(m_bodies);
+    m_physics->SetSimulationClock(snapshot.step, snapshot.time);
+    
+    std::cout << "Restored checkpoint " << filename << " (" << m_bodies.size() << " bodies)" << std::endl;
+}
+
 Body* Application::FindBodyAtPosition(const glm::vec2& position) {
     for (auto& body : m_bodies) {
         float distance = glm::length(body->GetPosition() - position);
@@ -523,6 +1071,7 @@ glm::vec2 Application::WorldToScreen(const glm::vec2& worldPos) const {
 
 void Application::LoadPreset(const std::string& name) {
     ClearBodies();
+    ResetHistory();
     
     if (name == "Solar System") {
         CreateSolarSystem();
@@ -683,17 +1232,21 @@ void Application::CreateBinarySystem() {
 }
 
 void Application::CreateGalaxySpiral() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    float G = m_physics->GetConfig().gravitationalConstant;
+    PresetKey key{"Galaxy", {G}, 0, PRESET_SEED};
+    if (LoadCachedBodies(key)) return;
+    const size_t firstBody = m_bodies.size();
+    
+    std::mt19937 gen(key.seed);
     std::uniform_real_distribution<float> angleDist(0.0f, 2.0f * 3.14159f);
     std::uniform_real_distribution<float> radiusDist(20.0f, 150.0f);  // Much larger range
     std::uniform_real_distribution<float> massDist(0.5f, 2.0f);       // Smaller masses
     std::uniform_real_distribution<float> armNoise(-0.3f, 0.3f);      // Angular noise
+    std::uniform_real_distribution<float> unitDist(0.0f, 1.0f);
     
     // Central supermassive object
     AddBody(glm::vec2(0.0f, 0.0f), glm::vec2(0.0f, 0.0f), 50.0f);  // Smaller central mass
     
-    float G = m_physics->GetConfig().gravitationalConstant;
     float centralMass = 50.0f;
     
     // Create spiral arms
@@ -713,7 +1266,7 @@ void Application::CreateGalaxySpiral() {
             
             // Calculate stable orbital velocity with some randomness
             float baseSpeed = std::sqrt(G * centralMass / radius);
-            float speedVariation = 0.8f + 0.4f * static_cast<float>(rand()) / RAND_MAX;
+            float speedVariation = 0.8f + 0.4f * unitDist(gen);
             float speed = baseSpeed * speedVariation;
             
             glm::vec2 velocity(-speed * std::sin(angle), speed * std::cos(angle));
@@ -738,11 +1291,16 @@ void Application::CreateGalaxySpiral() {
         
         AddBody(position, velocity, massDist(gen) * 0.5f);
     }
+    
+    StoreCachedBodies(key, firstBody);
 }
 
 void Application::CreateRandomCluster(int count) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    PresetKey key{"Random Cluster", {}, count, PRESET_SEED};
+    if (LoadCachedBodies(key)) return;
+    const size_t firstBody = m_bodies.size();
+    
+    std::mt19937 gen(key.seed);
     std::uniform_real_distribution<float> angleDist(0.0f, 2.0f * 3.14159f);
     std::uniform_real_distribution<float> radiusDist(10.0f, 100.0f);  // Much larger area
     std::uniform_real_distribution<float> velDist(-1.0f, 1.0f);
@@ -786,6 +1344,8 @@ void Application::CreateRandomCluster(int count) {
             AddBody(position, velocity, mass);
         }
     }
+    
+    StoreCachedBodies(key, firstBody);
 }
 
 void Application::CreateTripleStarSystem() {
@@ -878,14 +1438,17 @@ void Application::CreateCollisionCourse() {
     AddBody(glm::vec2(0.0f, -120.0f), glm::vec2(0.0f, 0.0f), 1.0f);
 }
 
-void Application::SpawnBodies(int count, int pattern) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    
+void Application::SpawnBodies(int count, int pattern, uint32_t seed) {
     float baseRadius = m_ui->GetSpawnRadius();
     float mass = m_ui->GetSpawnMass();
     float speed = m_ui->GetSpawnSpeed();
     
+    PresetKey key{"Spawn", {static_cast<float>(pattern), baseRadius, mass, speed}, count, seed};
+    if (LoadCachedBodies(key)) return;
+    const size_t firstBody = m_bodies.size();
+    
+    std::mt19937 gen(seed);
+    
     // Use advanced spatial distribution algorithms
     auto positions = GenerateSpatialDistribution(count, pattern, baseRadius, gen);
     
@@ -894,6 +1457,23 @@ void Application::SpawnBodies(int count, int pattern) {
         glm::vec2 velocity = CalculateVelocityForPattern(position, pattern, speed, i, count, gen);
         AddBody(position, velocity, mass);
     }
+    
+    StoreCachedBodies(key, firstBody);
+}
+
+bool Application::LoadCachedBodies(const PresetKey& key) {
+    return m_presetCache && m_presetCache->Load(key, m_bodies, m_ui->GetNewBodyColor());
+}
+
+void Application::StoreCachedBodies(const PresetKey& key, size_t firstBody) {
+    // Presets that are quick to generate are not worth a file
+    static constexpr size_t MIN_CACHED_BODIES = 64;
+    if (!m_presetCache || !m_presetCache->IsEnabled() || m_bodies.size() - firstBody < MIN_CACHED_BODIES) {
+        return;
+    }
+    if (m_presetCache->Store(key, m_bodies, firstBody)) {
+        m_presetCacheBytes = m_presetCache->GetDiskUsage();
+    }
 }
 
 void Application::UpdatePerformanceMetrics() {
@@ -1365,8 +1945,16 @@ void Application::SaveConfiguration(const std::string& filename) {
         file << "physics.softeningLength=" << config.softeningLength << "\n";
         file << "physics.useBarnesHut=" << (config.useBarnesHut ? "true" : "false") << "\n";
         file << "physics.barnesHutTheta=" << config.barnesHutTheta << "\n";
+        file << "physics.useKDTree=" << (config.useKDTree ? "true" : "false") << "\n";
         file << "physics.enableCollisions=" << (config.enableCollisions ? "true" : "false") << "\n";
+        file << "physics.treeCollisions=" << (config.treeCollisions ? "true" : "false") << "\n";
+        file << "physics.useEventDriven=" << (config.useEventDriven ? "true" : "false") << "\n";
+        file << "physics.continuousCollisions=" << (config.continuousCollisions ? "true" : "false") << "\n";
+        file << "physics.useNeighborLists=" << (config.useNeighborLists ? "true" : "false") << "\n";
+        file << "physics.neighborSkin=" << config.neighborSkin << "\n";
         file << "physics.restitution=" << config.restitution << "\n";
+        file << "physics.regularizeCloseEncounters=" << (config.regularizeCloseEncounters ? "true" : "false") << "\n";
+        file << "physics.useWisdomHolman=" << (config.useWisdomHolman ? "true" : "false") << "\n";
         
         // Save camera configuration
         file << "camera.position.x=" << m_renderer->GetCamera().position.x << "\n";
@@ -1388,6 +1976,10 @@ void Application::SaveConfiguration(const std::string& filename) {
             file << "body." << i << ".velocity.y=" << body->GetVelocity().y << "\n";
             file << "body." << i << ".mass=" << body->GetMass() << "\n";
             file << "body." << i << ".radius=" << body->GetRadius() << "\n";
+            file << "body." << i << ".density=" << body->GetDensity() << "\n";
+            if (body->IsFixed()) {
+                file << "body." << i << ".fixed=true\n";
+            }
             file << "body." << i << ".color.r=" << body->GetColor().r << "\n";
             file << "body." << i << ".color.g=" << body->GetColor().g << "\n";
             file << "body." << i << ".color.b=" << body->GetColor().b << "\n";
@@ -1409,106 +2001,45 @@ void Application::LoadConfiguration(const std::string& filename) {
         
         // Clear existing bodies
         ClearBodies();
+        ResetHistory();
         
         // Parse configuration
+        ConfigFile config;
         std::string line;
-        std::map<std::string, std::string> config;
-        
         while (std::getline(file, line)) {
-            // Skip comments and empty lines
-            if (line.empty() || line[0] == '#') continue;
-            
-            // Parse key=value pairs
-            size_t pos = line.find('=');
-            if (pos != std::string::npos) {
-                std::string key = line.substr(0, pos);
-                std::string value = line.substr(pos + 1);
-                config[key] = value;
-            }
+            config.ParseLine(line);
         }
         
         // Apply physics configuration
-        auto& physicsConfig = m_physics->GetMutableConfig();
-        if (config.count("physics.gravitationalConstant")) {
-            physicsConfig.gravitationalConstant = std::stof(config["physics.gravitationalConstant"]);
-        }
-        if (config.count("physics.timeStep")) {
-            physicsConfig.timeStep = std::stof(config["physics.timeStep"]);
-        }
-        if (config.count("physics.timeScale")) {
-            physicsConfig.timeScale = std::stof(config["physics.timeScale"]);
-        }
-        if (config.count("physics.softeningLength")) {
-            physicsConfig.softeningLength = std::stof(config["physics.softeningLength"]);
-        }
-        if (config.count("physics.useBarnesHut")) {
-            physicsConfig.useBarnesHut = (config["physics.useBarnesHut"] == "true");
-        }
-        if (config.count("physics.barnesHutTheta")) {
-            physicsConfig.barnesHutTheta = std::stof(config["physics.barnesHutTheta"]);
-        }
-        if (config.count("physics.enableCollisions")) {
-            physicsConfig.enableCollisions = (config["physics.enableCollisions"] == "true");
-        }
-        if (config.count("physics.restitution")) {
-            physicsConfig.restitution = std::stof(config["physics.restitution"]);
-        }
+        config.ApplyPhysicsConfig(m_physics->GetMutableConfig());
         
         // Apply camera configuration
-        if (config.count("camera.position.x") && config.count("camera.position.y")) {
-            glm::vec2 pos(std::stof(config["camera.position.x"]), std::stof(config["camera.position.y"]));
+        if (config.Has("camera.position.x") && config.Has("camera.position.y")) {
+            glm::vec2 pos(config.GetFloat("camera.position.x", 0.0f), config.GetFloat("camera.position.y", 0.0f));
             m_renderer->SetCameraPosition(pos);
         }
-        if (config.count("camera.zoom")) {
-            m_renderer->SetCameraZoom(std::stof(config["camera.zoom"]));
+        if (config.Has("camera.zoom")) {
+            m_renderer->SetCameraZoom(config.GetFloat("camera.zoom", 1.0f));
         }
         
         // Apply render settings
-        if (config.count("render.showTrails")) {
-            m_renderer->SetShowTrails(config["render.showTrails"] == "true");
+        if (config.Has("render.showTrails")) {
+            m_renderer->SetShowTrails(config.GetBool("render.showTrails", true));
         }
-        if (config.count("render.showGrid")) {
-            m_renderer->SetShowGrid(config["render.showGrid"] == "true");
+        if (config.Has("render.showGrid")) {
+            m_renderer->SetShowGrid(config.GetBool("render.showGrid", false));
         }
-        if (config.count("render.showForces")) {
-            m_renderer->SetShowForces(config["render.showForces"] == "true");
+        if (config.Has("render.showForces")) {
+            m_renderer->SetShowForces(config.GetBool("render.showForces", false));
         }
         
         // Load bodies
-        if (config.count("bodies.count")) {
-            int bodyCount = std::stoi(config["bodies.count"]);
-            for (int i = 0; i < bodyCount; ++i) {
-                std::string prefix = "body." + std::to_string(i) + ".";
-                
-                if (config.count(prefix + "position.x") && config.count(prefix + "position.y") &&
-                    config.count(prefix + "velocity.x") && config.count(prefix + "velocity.y") &&
-                    config.count(prefix + "mass")) {
-                    
-                    glm::vec2 position(std::stof(config[prefix + "position.x"]), 
-                                     std::stof(config[prefix + "position.y"]));
-                    glm::vec2 velocity(std::stof(config[prefix + "velocity.x"]), 
-                                     std::stof(config[prefix + "velocity.y"]));
-                    float mass = std::stof(config[prefix + "mass"]);
-                    
-                    // Optional properties with defaults
-                    float radius = config.count(prefix + "radius") ? std::stof(config[prefix + "radius"]) : 
-                                 std::sqrt(mass / (3.14159f * 1000.0f));
-                    
-                    glm::vec3 color(1.0f, 1.0f, 1.0f);
-                    if (config.count(prefix + "color.r") && config.count(prefix + "color.g") && config.count(prefix + "color.b")) {
-                        color = glm::vec3(std::stof(config[prefix + "color.r"]),
-                                        std::stof(config[prefix + "color.g"]),
-                                        std::stof(config[prefix + "color.b"]));
-                    }
-                    
-                    AddBody(position, velocity, mass, radius, color);
-                }
-            }
-        }
+        config.CreateBodies(m_bodies);
         
         file.close();
         
         // Update UI to reflect loaded parameters
+        m_ui->SyncFromEngines(*m_physics, *m_renderer);
         if (m_ui->OnPhysicsParameterChanged) {
             m_ui->OnPhysicsParameterChanged();
         }
@@ -1516,9 +2047,8 @@ void Application::LoadConfiguration(const std::string& filename) {
             m_ui->OnRenderParameterChanged();
         }
         
-    } catch (const std::exception&) {
-        // Could add error logging here
-        // For now, just clear bodies if loading failed
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load configuration " << filename << ": " << e.what() << std::endl;
         ClearBodies();
     }
 }
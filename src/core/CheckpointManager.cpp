@@ -0,0 +1,329 @@
+#include "core/CheckpointManager.h"
+#include "core/Body.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#endif
+
+namespace nbody {
+
+namespace {
+
+constexpr char CHECKPOINT_MAGIC[4] = {'N', 'B', 'C', 'P'};
+constexpr uint32_t CHECKPOINT_VERSION = 1;
+
+struct CheckpointHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t step;
+    double time;
+    uint64_t count;
+};
+
+struct CheckpointRecord {
+    float position[2];
+    float velocity[2];
+    float mass;
+    float density;
+    float color[3];
+    uint32_t fixed;
+};
+
+/**
+ * @brief Serialize the bodies through any sink with bool Write(const void*, size_t)
+ *
+ * Uses only stack storage so it is safe to run in a forked child.
+ */
+template <typename Sink>
+bool SerializeBodies(Sink& sink, const std::vector<std::unique_ptr<Body>>& bodies, uint64_t step, double time) {
+    CheckpointHeader header;
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.step = step;
+    header.time = time;
+    header.count = bodies.size();
+    if (!sink.Write(&header, sizeof(header))) return false;
+
+    constexpr size_t BATCH = 1024;
+    CheckpointRecord records[BATCH];
+    size_t pending = 0;
+    for (const auto& body : bodies) {
+        CheckpointRecord& record = records[pending++];
+        record.position[0] = body->GetPosition().x;
+        record.position[1] = body->GetPosition().y;
+        record.velocity[0] = body->GetVelocity().x;
+        record.velocity[1] = body->GetVelocity().y;
+        record.mass = body->GetMass();
+        record.density = body->GetDensity();
+        record.color[0] = body->GetColor().r;
+        record.color[1] = body->GetColor().g;
+        record.color[2] = body->GetColor().b;
+        record.fixed = body->IsFixed() ? 1u : 0u;
+
+        if (pending == BATCH) {
+            if (!sink.Write(records, sizeof(records))) return false;
+            pending = 0;
+        }
+    }
+    return pending == 0 || sink.Write(records, pending * sizeof(CheckpointRecord));
+}
+
+struct StreamSink {
+    std::ofstream& stream;
+    bool Write(const void* data, size_t size) {
+        stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        return static_cast<bool>(stream);
+    }
+};
+
+#ifndef _WIN32
+struct DescriptorSink {
+    int fd;
+    bool Write(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t written = ::write(fd, bytes, size);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Body of the forked writer; only async-signal-safe calls past this point
+ */
+[[noreturn]] void RunCheckpointChild(const char* tempPath, const char* finalPath,
+                                     const std::vector<std::unique_ptr<Body>>& bodies,
+                                     uint64_t step, double time) {
+#ifdef __linux__
+    // The simulation may have pinned its threads; let the writer run on any core
+    cpu_set_t allCpus;
+    CPU_ZERO(&allCpus);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) CPU_SET(cpu, &allCpus);
+    sched_setaffinity(0, sizeof(allCpus), &allCpus);
+#endif
+    // Stay out of the way of the simulation
+    if (nice(10) == -1) {}
+
+    int fd = ::open(tempPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) _exit(1);
+
+    DescriptorSink sink{fd};
+    bool ok = SerializeBodies(sink, bodies, step, time);
+    ok = (::fsync(fd) == 0) && ok;
+    ok = (::close(fd) == 0) && ok;
+    ok = ok && (::rename(tempPath, finalPath) == 0);
+    _exit(ok ? 0 : 1);
+}
+#endif
+
+} // namespace
+
+CheckpointManager::CheckpointManager(const CheckpointConfig& config) : m_config(config) {
+}
+
+CheckpointManager::~CheckpointManager() {
+    Wait();
+}
+
+bool CheckpointManager::Request(const std::vector<std::unique_ptr<Body>>& bodies, uint64_t step, double time,
+                                bool force) {
+    Poll();
+    if (IsWriting()) return false;
+
+    auto now = Clock::now();
+    if (!force && m_hasStarted &&
+        std::chrono::duration<double>(now - m_lastStart).count() < m_config.minIntervalSeconds) {
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(m_config.directory, error);
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "checkpoint_%010llu.nbck", static_cast<unsigned long long>(step));
+    std::string filename = (std::filesystem::path(m_config.directory) / name).string();
+    m_tempFilename = filename + ".tmp";
+
+    m_lastStart = now;
+    m_writeStart = now;
+    m_hasStarted = true;
+    m_status.state = CheckpointStatus::Writing;
+    m_status.step = step;
+    m_status.filename = filename;
+
+#ifndef _WIN32
+    if (m_config.useFork) {
+        // Everything the child needs is prepared above; it must not allocate
+        const char* tempPath = m_tempFilename.c_str();
+        const char* finalPath = m_status.filename.c_str();
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            RunCheckpointChild(tempPath, finalPath, bodies, step, time);
+        }
+
+        m_status.pauseMs = std::chrono::duration<double, std::milli>(Clock::now() - now).count();
+        if (pid > 0) {
+            m_childPid = pid;
+            return true;
+        }
+        std::cerr << "Checkpoint fork failed, writing synchronously" << std::endl;
+    }
+#endif
+
+    // Synchronous fallback: the simulation waits for the whole write
+    bool ok = Write(m_tempFilename, bodies, step, time);
+    if (ok) {
+        std::filesystem::rename(m_tempFilename, filename, error);
+        ok = !error;
+    }
+    m_status.pauseMs = std::chrono::duration<double, std::milli>(Clock::now() - now).count();
+    Finish(ok);
+    return true;
+}
+
+void CheckpointManager::Update(const std::vector<std::unique_ptr<Body>>& bodies, uint64_t step, double time) {
+    Poll();
+    if (m_config.autoIntervalSeconds <= 0.0 || IsWriting()) return;
+
+    double interval = std::max(m_config.autoIntervalSeconds, m_config.minIntervalSeconds);
+    if (!m_hasStarted || std::chrono::duration<double>(Clock::now() - m_lastStart).count() >= interval) {
+        Request(bodies, step, time);
+    }
+}
+
+void CheckpointManager::Poll() {
+#ifndef _WIN32
+    if (m_childPid <= 0) return;
+
+    int status = 0;
+    pid_t result = waitpid(static_cast<pid_t>(m_childPid), &status, WNOHANG);
+    if (result == 0) return;
+
+    m_childPid = -1;
+    Finish(result > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+#endif
+}
+
+void CheckpointManager::Wait() {
+#ifndef _WIN32
+    if (m_childPid <= 0) return;
+
+    int status = 0;
+    pid_t result;
+    do {
+        result = waitpid(static_cast<pid_t>(m_childPid), &status, 0);
+    } while (result < 0 && errno == EINTR);
+
+    m_childPid = -1;
+    Finish(result > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+#endif
+}
+
+void CheckpointManager::Finish(bool success) {
+    m_status.durationMs = std::chrono::duration<double, std::milli>(Clock::now() - m_writeStart).count();
+
+    std::error_code error;
+    if (success) {
+        m_status.state = CheckpointStatus::Succeeded;
+        m_status.completed++;
+
+        // Keep only the newest files
+        m_files.push_back(m_status.filename);
+        while (m_config.keepCount > 0 && static_cast<int>(m_files.size()) > m_config.keepCount) {
+            std::filesystem::remove(m_files.front(), error);
+            m_files.pop_front();
+        }
+    } else {
+        m_status.state = CheckpointStatus::Failed;
+        m_status.failed++;
+        std::filesystem::remove(m_tempFilename, error);
+        std::cerr << "Checkpoint failed: " << m_status.filename << std::endl;
+    }
+}
+
+bool CheckpointManager::Write(const std::string& filename, const std::vector<std::unique_ptr<Body>>& bodies,
+                              uint64_t step, double time) {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    StreamSink sink{file};
+    if (!SerializeBodies(sink, bodies, step, time)) {
+        return false;
+    }
+    file.close();
+    return static_cast<bool>(file);
+}
+
+bool CheckpointManager::Load(const std::string& filename, SimulationSnapshot& snapshot) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    CheckpointHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CHECKPOINT_VERSION) {
+        return false;
+    }
+
+    // The count comes from the file; a truncated or corrupt one must not size the allocation
+    const std::streamoff headerEnd = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff fileEnd = file.tellg();
+    file.seekg(headerEnd);
+    if (headerEnd < 0 || fileEnd < headerEnd ||
+        header.count > static_cast<uint64_t>(fileEnd - headerEnd) / sizeof(CheckpointRecord)) {
+        return false;
+    }
+
+    std::vector<CheckpointRecord> records(static_cast<size_t>(header.count));
+    if (!records.empty() &&
+        !file.read(reinterpret_cast<char*>(records.data()),
+                   static_cast<std::streamsize>(records.size() * sizeof(CheckpointRecord)))) {
+        return false;
+    }
+
+    snapshot.step = header.step;
+    snapshot.time = header.time;
+    snapshot.positions.resize(records.size());
+    snapshot.velocities.resize(records.size());
+    snapshot.masses.resize(records.size());
+    snapshot.densities.resize(records.size());
+    snapshot.colors.resize(records.size());
+    snapshot.fixed.resize(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        const CheckpointRecord& record = records[i];
+        snapshot.positions[i] = glm::vec2(record.position[0], record.position[1]);
+        snapshot.velocities[i] = glm::vec2(record.velocity[0], record.velocity[1]);
+        snapshot.masses[i] = record.mass;
+        snapshot.densities[i] = record.density;
+        snapshot.colors[i] = glm::vec3(record.color[0], record.color[1], record.color[2]);
+        snapshot.fixed[i] = record.fixed != 0 ? 1 : 0;
+    }
+    return true;
+}
+
+} // namespace nbody
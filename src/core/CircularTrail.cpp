@@ -4,17 +4,21 @@
 
 namespace nbody {
 
+// The buffer is allocated by the first AddPoint, so creating many bodies
+// (presets, cache loads) does not pay for trails that may never be drawn
 CircularTrail::CircularTrail() 
     : m_head(0), m_size(0), m_capacity(DEFAULT_CAPACITY) {
-    m_points.resize(m_capacity);
 }
 
 CircularTrail::CircularTrail(int capacity) 
     : m_head(0), m_size(0), m_capacity(std::max(1, capacity)) {
-    m_points.resize(m_capacity);
 }
 
 void CircularTrail::AddPoint(const glm::vec2& point) {
+    if (m_points.empty()) {
+        m_points.resize(m_capacity);
+    }
+    
     // Store the point at the current head position
     m_points[m_head] = point;
     
@@ -34,6 +38,11 @@ void CircularTrail::SetCapacity(int capacity) {
         return; // No change needed
     }
     
+    if (m_points.empty()) {
+        m_capacity = newCapacity; // Not allocated yet
+        return;
+    }
+    
     if (newCapacity > m_capacity) {
         // Expanding: create new buffer and copy existing data
         std::vector<glm::vec2> newPoints(newCapacity);
@@ -0,0 +1,220 @@
+#include "core/ConfigFile.h"
+#include "core/Body.h"
+#include "physics/PhysicsEngine.h"
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+#include <stdexcept>
+
+namespace nbody {
+
+namespace {
+
+std::string Trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) return "";
+    size_t last = text.find_last_not_of(" \t\r\n");
+    return text.substr(first, last - first + 1);
+}
+
+bool ParseBool(const std::string& value) {
+    return value == "true" || value == "1" || value == "yes" || value == "on";
+}
+
+} // namespace
+
+namespace {
+
+std::invalid_argument InvalidValue(const std::string& key, const std::string& value) {
+    return std::invalid_argument("Invalid value for " + key + ": \"" + value + "\"");
+}
+
+} // namespace
+
+float ConfigFile::ParseFloat(const std::string& key, const std::string& value) {
+    const char* begin = value.c_str();
+    char* end = nullptr;
+    errno = 0;
+    float result = std::strtof(begin, &end);
+    if (end == begin || *end != '\0' || errno == ERANGE) {
+        throw InvalidValue(key, value);
+    }
+    return result;
+}
+
+int ConfigFile::ParseInt(const std::string& key, const std::string& value) {
+    const char* begin = value.c_str();
+    char* end = nullptr;
+    errno = 0;
+    long result = std::strtol(begin, &end, 10);
+    if (end == begin || *end != '\0' || errno == ERANGE || result < INT_MIN || result > INT_MAX) {
+        throw InvalidValue(key, value);
+    }
+    return static_cast<int>(result);
+}
+
+uint32_t ConfigFile::ParseUnsigned(const std::string& key, const std::string& value) {
+    const char* begin = value.c_str();
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long result = std::strtoull(begin, &end, 10);
+    if (end == begin || *end != '\0' || errno == ERANGE || value[0] == '-' || result > UINT32_MAX) {
+        throw InvalidValue(key, value);
+    }
+    return static_cast<uint32_t>(result);
+}
+
+bool ConfigFile::Load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        ParseLine(line);
+    }
+    return true;
+}
+
+void ConfigFile::ParseLine(const std::string& line) {
+    std::string trimmed = Trim(line);
+
+    // Skip comments and empty lines
+    if (trimmed.empty() || trimmed[0] == '#') return;
+
+    // Parse key=value pairs
+    size_t pos = trimmed.find('=');
+    if (pos != std::string::npos) {
+        m_values[Trim(trimmed.substr(0, pos))] = Trim(trimmed.substr(pos + 1));
+    }
+}
+
+std::string ConfigFile::GetString(const std::string& key, const std::string& defaultValue) const {
+    auto it = m_values.find(key);
+    return it != m_values.end() ? it->second : defaultValue;
+}
+
+float ConfigFile::GetFloat(const std::string& key, float defaultValue) const {
+    auto it = m_values.find(key);
+    return it != m_values.end() ? ParseFloat(key, it->second) : defaultValue;
+}
+
+int ConfigFile::GetInt(const std::string& key, int defaultValue) const {
+    auto it = m_values.find(key);
+    return it != m_values.end() ? ParseInt(key, it->second) : defaultValue;
+}
+
+bool ConfigFile::GetBool(const std::string& key, bool defaultValue) const {
+    auto it = m_values.find(key);
+    return it != m_values.end() ? ParseBool(it->second) : defaultValue;
+}
+
+void ConfigFile::ApplyPhysicsConfig(PhysicsConfig& config) const {
+    for (const auto& entry : m_values) {
+        if (entry.first.compare(0, 8, "physics.") == 0) {
+            ApplyPhysicsValue(entry.first, entry.second, config);
+        }
+    }
+}
+
+bool ConfigFile::ApplyPhysicsValue(const std::string& key, const std::string& value, PhysicsConfig& config) {
+    if (key == "physics.gravitationalConstant") {
+        config.gravitationalConstant = ParseFloat(key, value);
+    } else if (key == "physics.timeStep") {
+        config.timeStep = ParseFloat(key, value);
+    } else if (key == "physics.timeScale") {
+        config.timeScale = ParseFloat(key, value);
+    } else if (key == "physics.softeningLength") {
+        config.softeningLength = ParseFloat(key, value);
+    } else if (key == "physics.dampingFactor") {
+        config.dampingFactor = ParseFloat(key, value);
+    } else if (key == "physics.useBarnesHut") {
+        config.useBarnesHut = ParseBool(value);
+    } else if (key == "physics.barnesHutTheta") {
+        config.barnesHutTheta = ParseFloat(key, value);
+    } else if (key == "physics.useKDTree") {
+        config.useKDTree = ParseBool(value);
+    } else if (key == "physics.enableCollisions") {
+        config.enableCollisions = ParseBool(value);
+    } else if (key == "physics.treeCollisions") {
+        config.treeCollisions = ParseBool(value);
+    } else if (key == "physics.useNeighborLists") {
+        config.useNeighborLists = ParseBool(value);
+    } else if (key == "physics.neighborSkin") {
+        config.neighborSkin = ParseFloat(key, value);
+    } else if (key == "physics.continuousCollisions") {
+        config.continuousCollisions = ParseBool(value);
+    } else if (key == "physics.useEventDriven") {
+        config.useEventDriven = ParseBool(value);
+    } else if (key == "physics.restitution") {
+        config.restitution = ParseFloat(key, value);
+    } else if (key == "physics.adaptiveTimeStep") {
+        config.adaptiveTimeStep = ParseBool(value);
+    } else if (key == "physics.maxTimeStep") {
+        config.maxTimeStep = ParseFloat(key, value);
+    } else if (key == "physics.minTimeStep") {
+        config.minTimeStep = ParseFloat(key, value);
+    } else if (key == "physics.maxBodiesForDirect") {
+        config.maxBodiesForDirect = ParseInt(key, value);
+    } else if (key == "physics.regularizeCloseEncounters") {
+        config.regularizeCloseEncounters = ParseBool(value);
+    } else if (key == "physics.regularizationSteps") {
+        config.regularizationSteps = ParseFloat(key, value);
+    } else if (key == "physics.regularizationSubsteps") {
+        config.regularizationSubsteps = ParseInt(key, value);
+    } else if (key == "physics.useWisdomHolman") {
+        config.useWisdomHolman = ParseBool(value);
+    } else if (key == "physics.wisdomHolmanOrbitFraction") {
+        config.wisdomHolmanOrbitFraction = ParseFloat(key, value);
+    } else if (key == "physics.wisdomHolmanMassRatio") {
+        config.wisdomHolmanMassRatio = ParseFloat(key, value);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void ConfigFile::CreateBodies(std::vector<std::unique_ptr<Body>>& bodies) const {
+    int bodyCount = GetInt("bodies.count", 0);
+    bodies.reserve(bodies.size() + std::max(0, bodyCount));
+
+    for (int i = 0; i < bodyCount; ++i) {
+        std::string prefix = "body." + std::to_string(i) + ".";
+
+        if (!Has(prefix + "position.x") || !Has(prefix + "position.y") ||
+            !Has(prefix + "velocity.x") || !Has(prefix + "velocity.y") ||
+            !Has(prefix + "mass")) {
+            continue;
+        }
+
+        glm::vec2 position(GetFloat(prefix + "position.x", 0.0f), GetFloat(prefix + "position.y", 0.0f));
+        glm::vec2 velocity(GetFloat(prefix + "velocity.x", 0.0f), GetFloat(prefix + "velocity.y", 0.0f));
+        float mass = GetFloat(prefix + "mass", 1.0f);
+
+        glm::vec3 color(1.0f, 1.0f, 1.0f);
+        if (Has(prefix + "color.r") && Has(prefix + "color.g") && Has(prefix + "color.b")) {
+            color = glm::vec3(GetFloat(prefix + "color.r", 1.0f),
+                              GetFloat(prefix + "color.g", 1.0f),
+                              GetFloat(prefix + "color.b", 1.0f));
+        }
+
+        auto body = std::make_unique<Body>(position, velocity, mass, color);
+
+        // Older files only store the radius; recover the density from r = sqrt(m / (pi * density))
+        if (Has(prefix + "density")) {
+            body->SetDensity(GetFloat(prefix + "density", 1.0f));
+        } else if (Has(prefix + "radius")) {
+            float radius = std::max(GetFloat(prefix + "radius", 1.0f), 1e-3f);
+            body->SetDensity(mass / (3.14159f * radius * radius));
+        }
+
+        body->SetFixed(GetBool(prefix + "fixed", false));
+        bodies.push_back(std::move(body));
+    }
+}
+
+} // namespace nbody
@@ -0,0 +1,296 @@
+#include "core/EnsembleRunner.h"
+#include "core/Body.h"
+#include <omp.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <cstdlib>
+
+namespace nbody {
+
+namespace {
+
+std::vector<std::string> SplitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+} // namespace
+
+bool EnsembleRunner::LoadSpec(const std::string& filename) {
+    try {
+        return ParseSpec(filename);
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid ensemble spec " << filename << ": " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool EnsembleRunner::ParseSpec(const std::string& filename) {
+    ConfigFile spec;
+    if (!spec.Load(filename)) {
+        std::cerr << "Failed to open ensemble spec: " << filename << std::endl;
+        return false;
+    }
+
+    std::string baseFile = spec.GetString("base");
+    if (baseFile.empty() || !m_base.Load(baseFile)) {
+        std::cerr << "Failed to open ensemble base configuration: " << baseFile << std::endl;
+        return false;
+    }
+
+    m_steps = std::max(1, spec.GetInt("steps", m_steps));
+    m_threads = spec.GetInt("threads", 0);
+    m_velocityJitter = spec.GetFloat("velocityJitter", 0.0f);
+    m_outputFile = spec.GetString("output", m_outputFile);
+
+    m_baseConfig = PhysicsConfig();
+    m_base.ApplyPhysicsConfig(m_baseConfig);
+
+    BuildMembers(spec);
+    return !m_members.empty();
+}
+
+void EnsembleRunner::BuildMembers(const ConfigFile& spec) {
+    m_members.clear();
+
+    // Collect sweep axes
+    std::vector<std::pair<std::string, std::vector<std::string>>> axes;
+    for (const auto& entry : spec.GetValues()) {
+        if (entry.first.compare(0, 6, "sweep.") == 0) {
+            auto values = SplitList(entry.second);
+            if (!values.empty()) {
+                axes.emplace_back(entry.first.substr(6), values);
+            }
+        }
+    }
+
+    size_t combinations = 1;
+    for (const auto& axis : axes) {
+        combinations *= axis.second.size();
+    }
+
+    int replicas = std::max(1, spec.GetInt("replicas", 1));
+    uint32_t baseSeed = static_cast<uint32_t>(spec.GetInt("seed", 1));
+
+    // Cartesian product of the sweep axes, each repeated for every replica seed
+    for (size_t combination = 0; combination < combinations; ++combination) {
+        std::vector<std::pair<std::string, std::string>> overrides;
+        size_t remainder = combination;
+        for (const auto& axis : axes) {
+            overrides.emplace_back(axis.first, axis.second[remainder % axis.second.size()]);
+            remainder /= axis.second.size();
+        }
+
+        for (int replica = 0; replica < replicas; ++replica) {
+            EnsembleMember member;
+            member.index = static_cast<int>(m_members.size());
+            member.seed = baseSeed + static_cast<uint32_t>(replica);
+            member.overrides = overrides;
+            m_members.push_back(std::move(member));
+        }
+    }
+
+    // Per-member overrides: member.<i>.physics.<key>=<value>
+    for (const auto& entry : spec.GetValues()) {
+        if (entry.first.compare(0, 7, "member.") != 0) continue;
+
+        size_t dot = entry.first.find('.', 7);
+        if (dot == std::string::npos) continue;
+
+        int index = ConfigFile::ParseInt(entry.first, entry.first.substr(7, dot - 7));
+        if (index >= 0 && index < static_cast<int>(m_members.size())) {
+            std::string key = entry.first.substr(dot + 1);
+            if (key == "seed") {
+                m_members[index].seed = ConfigFile::ParseUnsigned(entry.first, entry.second);
+            } else {
+                m_members[index].overrides.emplace_back(key, entry.second);
+            }
+        }
+    }
+}
+
+EnsembleSummary EnsembleRunner::Run() {
+    m_results.assign(m_members.size(), EnsembleResult());
+
+    // One member per core; the engines' own parallel loops become serial
+    int previousLevels = omp_get_max_active_levels();
+    omp_set_max_active_levels(1);
+
+    int threads = m_threads > 0 ? m_threads : omp_get_max_threads();
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(threads)
+    for (int i = 0; i < static_cast<int>(m_members.size()); ++i) {
+        m_results[i] = RunMember(m_members[i]);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    omp_set_max_active_levels(previousLevels);
+
+    EnsembleSummary summary = Summarize(std::chrono::duration<double, std::milli>(end - start).count());
+    WriteResults(m_outputFile);
+    return summary;
+}
+
+EnsembleResult EnsembleRunner::RunMember(const EnsembleMember& member) const {
+    EnsembleResult result;
+    result.index = member.index;
+    result.seed = member.seed;
+    result.steps = m_steps;
+
+    try {
+        PhysicsConfig config = m_baseConfig;
+        config.useGPU = false;
+        for (const auto& entry : member.overrides) {
+            if (!ConfigFile::ApplyPhysicsValue(entry.first, entry.second, config)) {
+                result.error = "unknown override " + entry.first;
+                return result;
+            }
+        }
+
+        std::vector<std::unique_ptr<Body>> bodies;
+        m_base.CreateBodies(bodies);
+        result.bodyCount = static_cast<int>(bodies.size());
+
+        // Seeded velocity perturbation so replicas explore nearby initial conditions
+        if (m_velocityJitter > 0.0f) {
+            std::mt19937 gen(member.seed);
+            std::normal_distribution<float> noise(0.0f, m_velocityJitter);
+            for (auto& body : bodies) {
+                glm::vec2 velocity = body->GetVelocity();
+                body->SetVelocity(velocity + glm::vec2(noise(gen), noise(gen)) * glm::length(velocity));
+            }
+        }
+
+        PhysicsEngine engine;
+        engine.SetConfig(config);
+
+        result.initialEnergy = engine.CalculateEnergyStats(bodies).total;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int step = 0; step < m_steps; ++step) {
+            engine.Update(bodies, config.timeStep);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        result.wallTime = std::chrono::duration<double, std::milli>(end - start).count();
+        result.simulationTime = engine.GetSimulationTime();
+        result.finalEnergy = engine.CalculateEnergyStats(bodies).total;
+        result.energyError = std::abs(result.initialEnergy) > 0.0
+            ? std::abs(result.finalEnergy - result.initialEnergy) / std::abs(result.initialEnergy)
+            : 0.0;
+        result.method = engine.GetStats().method;
+
+        double totalMass = 0.0;
+        glm::dvec2 weighted(0.0);
+        for (const auto& body : bodies) {
+            totalMass += body->GetMass();
+            weighted += glm::dvec2(body->GetPosition()) * static_cast<double>(body->GetMass());
+        }
+        if (totalMass > 0.0) {
+            result.centerOfMass = glm::vec2(weighted / totalMass);
+        }
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+
+    return result;
+}
+
+EnsembleSummary EnsembleRunner::Summarize(double wallTime) const {
+    EnsembleSummary summary;
+    summary.members = static_cast<int>(m_results.size());
+    summary.wallTime = wallTime;
+
+    double sum = 0.0;
+    double sumSq = 0.0;
+    double bodySteps = 0.0;
+    int succeeded = 0;
+    summary.minEnergyError = std::numeric_limits<double>::max();
+
+    for (const auto& result : m_results) {
+        if (!result.error.empty()) {
+            summary.failed++;
+            continue;
+        }
+        succeeded++;
+        sum += result.energyError;
+        sumSq += result.energyError * result.energyError;
+        summary.minEnergyError = std::min(summary.minEnergyError, result.energyError);
+        summary.maxEnergyError = std::max(summary.maxEnergyError, result.energyError);
+        bodySteps += static_cast<double>(result.bodyCount) * result.steps;
+    }
+
+    if (succeeded > 0) {
+        summary.meanEnergyError = sum / succeeded;
+        summary.stdEnergyError = std::sqrt(std::max(0.0, sumSq / succeeded - summary.meanEnergyError * summary.meanEnergyError));
+    } else {
+        summary.minEnergyError = 0.0;
+    }
+    if (wallTime > 0.0) {
+        summary.bodyStepsPerSecond = bodySteps / (wallTime / 1000.0);
+    }
+
+    return summary;
+}
+
+bool EnsembleRunner::WriteResults(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write ensemble results: " << filename << std::endl;
+        return false;
+    }
+
+    file << "index,seed,overrides,bodies,steps,simTime,wallTimeMs,initialEnergy,finalEnergy,energyError,comX,comY,method,error\n";
+    for (size_t i = 0; i < m_results.size(); ++i) {
+        const auto& result = m_results[i];
+
+        std::string overrides;
+        for (const auto& entry : m_members[i].overrides) {
+            if (!overrides.empty()) overrides += ";";
+            overrides += entry.first + "=" + entry.second;
+        }
+
+        file << result.index << "," << result.seed << ",\"" << overrides << "\","
+             << result.bodyCount << "," << result.steps << "," << result.simulationTime << ","
+             << result.wallTime << "," << result.initialEnergy << "," << result.finalEnergy << ","
+             << result.energyError << "," << result.centerOfMass.x << "," << result.centerOfMass.y << ","
+             << result.method << ",\"" << result.error << "\"\n";
+    }
+    return true;
+}
+
+int EnsembleRunner::RunFromCommandLine(const std::string& specFile) {
+    EnsembleRunner runner;
+    if (!runner.LoadSpec(specFile)) {
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Running ensemble of " << runner.GetMembers().size() << " members" << std::endl;
+    EnsembleSummary summary = runner.Run();
+
+    std::cout << "Ensemble finished in " << summary.wallTime << " ms"
+              << " (" << summary.failed << " failed)" << std::endl;
+    std::cout << "Energy error: mean=" << summary.meanEnergyError
+              << " std=" << summary.stdEnergyError
+              << " min=" << summary.minEnergyError
+              << " max=" << summary.maxEnergyError << std::endl;
+    std::cout << "Throughput: " << summary.bodyStepsPerSecond << " body-steps/s" << std::endl;
+    std::cout << "Results written to " << runner.m_outputFile << std::endl;
+
+    return summary.failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace nbody
@@ -0,0 +1,123 @@
+#include "core/IncrementalJob.h"
+#include <algorithm>
+
+namespace nbody {
+
+void JobScheduler::Add(IncrementalJob* job, uint64_t intervalSteps, std::function<void()> onFinished) {
+    Entry entry;
+    entry.job = job;
+    entry.interval = intervalSteps;
+    entry.onFinished = std::move(onFinished);
+    entry.status.name = job->GetName();
+    m_entries.push_back(std::move(entry));
+}
+
+void JobScheduler::Remove(IncrementalJob* job) {
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                   [job](const Entry& entry) { return entry.job == job; }),
+                    m_entries.end());
+    m_firstEntry = 0;
+}
+
+void JobScheduler::SetInterval(IncrementalJob* job, uint64_t intervalSteps) {
+    if (Entry* entry = Find(job)) {
+        entry->interval = intervalSteps;
+    }
+}
+
+void JobScheduler::Restart(IncrementalJob* job) {
+    if (Entry* entry = Find(job)) {
+        entry->restartRequested = true;
+    }
+}
+
+void JobScheduler::RestartAll() {
+    for (Entry& entry : m_entries) {
+        entry.restartRequested = true;
+    }
+}
+
+JobScheduler::Entry* JobScheduler::Find(IncrementalJob* job) {
+    for (Entry& entry : m_entries) {
+        if (entry.job == job) return &entry;
+    }
+    return nullptr;
+}
+
+bool JobScheduler::IsBusy() const {
+    return std::any_of(m_entries.begin(), m_entries.end(),
+                       [](const Entry& entry) { return entry.running || entry.restartRequested; });
+}
+
+bool JobScheduler::IsDue(const Entry& entry, uint64_t step, uint64_t generation) const {
+    if (entry.restartRequested) return true;
+    if (entry.running || entry.interval == 0) return false;
+    if (!entry.started) return true;
+    if (generation == entry.startGeneration) return false;
+    // Rewinds, resets and edits make the last result meaningless
+    if (step <= entry.startStep) return true;
+    return step - entry.startStep >= entry.interval;
+}
+
+void JobScheduler::Update(const std::vector<std::unique_ptr<Body>>& bodies, uint64_t step, uint64_t generation) {
+    using Clock = std::chrono::steady_clock;
+    const auto frameStart = Clock::now();
+    const auto deadline = frameStart + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(m_sliceMs));
+
+    // Snapshots are taken even if they use up the slice, so no job is starved
+    for (Entry& entry : m_entries) {
+        if (!IsDue(entry, step, generation)) continue;
+        auto start = Clock::now();
+        entry.job->Begin(bodies);
+        entry.running = true;
+        entry.started = true;
+        entry.restartRequested = false;
+        entry.startStep = step;
+        entry.startGeneration = generation;
+        entry.frames = 0;
+        entry.workMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Running jobs split what is left of the slice; each gets at least one unit of work
+    const size_t entryCount = m_entries.size();
+    size_t remaining = std::count_if(m_entries.begin(), m_entries.end(),
+                                     [](const Entry& entry) { return entry.running; });
+    for (size_t k = 0; k < entryCount && remaining > 0; ++k) {
+        Entry& entry = m_entries[(m_firstEntry + k) % entryCount];
+        if (!entry.running) continue;
+
+        auto start = Clock::now();
+        auto share = start < deadline ? start + (deadline - start) / static_cast<Clock::rep>(remaining) : start;
+        bool finished = entry.job->Advance(share);
+        entry.workMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        entry.frames++;
+        remaining--;
+
+        if (finished) {
+            entry.running = false;
+            entry.status.completed++;
+            entry.status.lastFrames = entry.frames;
+            entry.status.lastWorkMs = entry.workMs;
+            if (entry.onFinished) entry.onFinished();
+        }
+    }
+    if (entryCount > 0) {
+        m_firstEntry = (m_firstEntry + 1) % entryCount;
+    }
+}
+
+std::vector<JobStatus> JobScheduler::GetStatus() const {
+    std::vector<JobStatus> status;
+    status.reserve(m_entries.size());
+    for (const Entry& entry : m_entries) {
+        JobStatus job = entry.status;
+        job.running = entry.running;
+        job.progress = entry.running ? entry.job->GetProgress() : 1.0f;
+        job.step = entry.startStep;
+        status.push_back(std::move(job));
+    }
+    return status;
+}
+
+} // namespace nbody
@@ -0,0 +1,252 @@
+#include "core/PresetCache.h"
+#include "core/Body.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <cctype>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace nbody {
+
+namespace {
+
+constexpr char CACHE_MAGIC[4] = {'N', 'B', 'P', 'C'};
+constexpr uint32_t CACHE_VERSION = 1;
+
+struct PresetCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t keyHash;
+    uint64_t count;
+    uint32_t seed;
+    uint32_t recordSize;
+};
+
+struct PresetCacheRecord {
+    float position[2];
+    float velocity[2];
+    float mass;
+};
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename) {
+#ifdef _WIN32
+        m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) return;
+        m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping) return;
+        m_data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (m_data) m_size = static_cast<size_t>(size.QuadPart);
+#else
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                m_data = data;
+                m_size = static_cast<size_t>(info.st_size);
+                madvise(data, m_size, MADV_SEQUENTIAL);
+            }
+        }
+        close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+#else
+        if (m_data) munmap(m_data, m_size);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* Data() const { return static_cast<const char*>(m_data); }
+    size_t Size() const { return m_size; }
+
+private:
+    void* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#endif
+};
+
+void HashBytes(uint64_t& hash, const void* data, size_t size) {
+    // FNV-1a
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+} // namespace
+
+uint64_t PresetKey::Hash() const {
+    uint64_t hash = 14695981039346656037ull;
+    HashBytes(hash, &CACHE_VERSION, sizeof(CACHE_VERSION));
+    HashBytes(hash, name.data(), name.size());
+    HashBytes(hash, "\0", 1);
+    HashBytes(hash, parameters.data(), parameters.size() * sizeof(float));
+    HashBytes(hash, &count, sizeof(count));
+    HashBytes(hash, &seed, sizeof(seed));
+    return hash;
+}
+
+PresetCache::PresetCache(const std::string& directory) : m_directory(directory) {
+}
+
+std::string PresetCache::GetFilename(const PresetKey& key) const {
+    std::string stem;
+    for (char c : key.name) {
+        stem += std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::tolower(static_cast<unsigned char>(c))) : '_';
+    }
+
+    char hash[17];
+    snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(key.Hash()));
+    return (std::filesystem::path(m_directory) / (stem + "_" + hash + ".bin")).string();
+}
+
+bool PresetCache::Load(const PresetKey& key, std::vector<std::unique_ptr<Body>>& bodies, const glm::vec3& color) {
+    if (!m_enabled) return false;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    MappedFile file(GetFilename(key));
+    if (!file.Data() || file.Size() < sizeof(PresetCacheHeader)) {
+        m_misses++;
+        return false;
+    }
+
+    PresetCacheHeader header;
+    std::memcpy(&header, file.Data(), sizeof(header));
+    const size_t available = (file.Size() - sizeof(header)) / sizeof(PresetCacheRecord);
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CACHE_VERSION ||
+        header.keyHash != key.Hash() ||
+        header.seed != key.seed ||
+        header.recordSize != sizeof(PresetCacheRecord) ||
+        header.count > available) {
+        m_misses++;
+        return false;
+    }
+
+    const auto* records = reinterpret_cast<const PresetCacheRecord*>(file.Data() + sizeof(header));
+    const size_t first = bodies.size();
+    const auto count = static_cast<long long>(header.count);
+    bodies.resize(first + static_cast<size_t>(count));
+
+    // Body construction (radius, trail buffer) dominates, so spread it over the cores
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < count; ++i) {
+        const PresetCacheRecord& record = records[i];
+        bodies[first + static_cast<size_t>(i)] = std::make_unique<Body>(
+            glm::vec2(record.position[0], record.position[1]),
+            glm::vec2(record.velocity[0], record.velocity[1]),
+            record.mass, color);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    m_lastLoadMs = std::chrono::duration<double, std::milli>(end - start).count();
+    m_hits++;
+    return true;
+}
+
+bool PresetCache::Store(const PresetKey& key, const std::vector<std::unique_ptr<Body>>& bodies, size_t firstBody) {
+    if (!m_enabled || firstBody > bodies.size()) return false;
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+
+    const std::string filename = GetFilename(key);
+    const std::string tempFilename = filename + ".tmp";
+    std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write preset cache " << tempFilename << std::endl;
+        return false;
+    }
+
+    PresetCacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.keyHash = key.Hash();
+    header.count = bodies.size() - firstBody;
+    header.seed = key.seed;
+    header.recordSize = sizeof(PresetCacheRecord);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<PresetCacheRecord> records(bodies.size() - firstBody);
+    for (size_t i = firstBody; i < bodies.size(); ++i) {
+        const Body& body = *bodies[i];
+        PresetCacheRecord& record = records[i - firstBody];
+        record.position[0] = body.GetPosition().x;
+        record.position[1] = body.GetPosition().y;
+        record.velocity[0] = body.GetVelocity().x;
+        record.velocity[1] = body.GetVelocity().y;
+        record.mass = body.GetMass();
+    }
+    file.write(reinterpret_cast<const char*>(records.data()),
+               static_cast<std::streamsize>(records.size() * sizeof(PresetCacheRecord)));
+    file.close();
+
+    if (!file) {
+        std::filesystem::remove(tempFilename, error);
+        return false;
+    }
+    std::filesystem::rename(tempFilename, filename, error);
+    if (error) {
+        std::filesystem::remove(tempFilename, error);
+        return false;
+    }
+    return true;
+}
+
+void PresetCache::Clear() {
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(m_directory, error)) {
+        if (entry.path().extension() == ".bin") {
+            std::filesystem::remove(entry.path(), error);
+        }
+    }
+}
+
+uint64_t PresetCache::GetDiskUsage() const {
+    uint64_t total = 0;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(m_directory, error)) {
+        if (entry.path().extension() == ".bin") {
+            total += entry.file_size(error);
+        }
+    }
+    return total;
+}
+
+} // namespace nbody
@@ -0,0 +1,311 @@
+#include "core/RewindBuffer.h"
+#include "core/Body.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace nbody {
+
+namespace {
+constexpr float QUANTISATION_RANGE = 32767.0f;
+}
+
+RewindBuffer::RewindBuffer() = default;
+
+RewindBuffer::~RewindBuffer() {
+    Stop();
+}
+
+void RewindBuffer::Start() {
+    if (m_worker.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = false;
+    }
+    m_worker = std::thread(&RewindBuffer::WorkerLoop, this);
+}
+
+void RewindBuffer::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+        m_pending.clear();
+    }
+    m_condition.notify_all();
+
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+bool RewindBuffer::Capture(const std::vector<std::unique_ptr<Body>>& bodies, uint64_t step, double time) {
+    PendingFrame frame;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_worker.joinable() || m_pending.size() >= m_config.maxPendingCaptures) {
+            ++m_droppedCaptures;
+            return false;
+        }
+        frame.epoch = m_epoch;
+    }
+
+    // Copy outside the lock so the encoder is never blocked by the physics thread
+    frame.state.Capture(bodies, step, time);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (frame.epoch != m_epoch) {
+            return false; // History was truncated while copying
+        }
+        m_pending.push_back(std::move(frame));
+    }
+    m_condition.notify_one();
+    return true;
+}
+
+bool RewindBuffer::Restore(uint64_t frameId, SimulationSnapshot& snapshot) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (const auto& segment : m_segments) {
+        if (frameId >= segment.firstId && frameId - segment.firstId < segment.GetFrameCount()) {
+            snapshot = segment.keyframe;
+            for (uint64_t i = 0; i < frameId - segment.firstId; ++i) {
+                ApplyDelta(segment.deltas[i], snapshot);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void RewindBuffer::TruncateAfter(uint64_t frameId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Segments are in id order; drop whole segments from the back, then the tail of the last one kept
+    while (!m_segments.empty() && m_segments.back().firstId > frameId) {
+        m_segments.pop_back();
+    }
+    if (!m_segments.empty()) {
+        Segment& segment = m_segments.back();
+        size_t keepDeltas = static_cast<size_t>(std::min<uint64_t>(frameId - segment.firstId, segment.deltas.size()));
+        for (size_t i = keepDeltas; i < segment.deltas.size(); ++i) {
+            segment.bytes -= GetDeltaMemoryUsage(segment.deltas[i]);
+        }
+        segment.deltas.resize(keepDeltas);
+    }
+
+    m_frameCount = 0;
+    m_memoryUsage = 0;
+    for (const auto& segment : m_segments) {
+        m_frameCount += segment.GetFrameCount();
+        m_memoryUsage += segment.bytes;
+    }
+
+    // Anything queued or being encoded belongs to the discarded branch
+    m_pending.clear();
+    ++m_epoch;
+}
+
+void RewindBuffer::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_segments.clear();
+    m_pending.clear();
+    m_frameCount = 0;
+    m_memoryUsage = 0;
+    ++m_epoch;
+}
+
+void RewindBuffer::SetConfig(const RewindConfig& config) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+    m_config.captureInterval = std::max(1, m_config.captureInterval);
+    m_config.keyframeInterval = std::max(1, m_config.keyframeInterval);
+    EvictOldSegments();
+}
+
+RewindConfig RewindBuffer::GetConfig() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_config;
+}
+
+bool RewindBuffer::GetFrameId(size_t frameIndex, uint64_t& frameId) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (const auto& segment : m_segments) {
+        if (frameIndex < segment.GetFrameCount()) {
+            frameId = segment.firstId + frameIndex;
+            return true;
+        }
+        frameIndex -= segment.GetFrameCount();
+    }
+    return false;
+}
+
+bool RewindBuffer::GetFrameIndex(uint64_t frameId, size_t& frameIndex) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t index = 0;
+    for (const auto& segment : m_segments) {
+        if (frameId >= segment.firstId && frameId - segment.firstId < segment.GetFrameCount()) {
+            frameIndex = index + static_cast<size_t>(frameId - segment.firstId);
+            return true;
+        }
+        index += segment.GetFrameCount();
+    }
+    return false;
+}
+
+size_t RewindBuffer::GetFrameCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_frameCount;
+}
+
+size_t RewindBuffer::GetMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_memoryUsage;
+}
+
+size_t RewindBuffer::GetSegmentCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_segments.size();
+}
+
+void RewindBuffer::WorkerLoop() {
+    while (true) {
+        PendingFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopRequested || !m_pending.empty(); });
+            if (m_stopRequested) break;
+
+            frame = std::move(m_pending.front());
+            m_pending.pop_front();
+        }
+
+        Encode(frame);
+    }
+}
+
+void RewindBuffer::Encode(PendingFrame& frame) {
+    size_t deltasInSegment = 0;
+    int keyframeInterval = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (frame.epoch != m_epoch) return;
+        if (!m_segments.empty()) deltasInSegment = m_segments.back().deltas.size();
+        keyframeInterval = m_config.keyframeInterval;
+    }
+
+    bool needKeyframe = !m_hasReference ||
+                        m_referenceEpoch != frame.epoch ||
+                        deltasInSegment >= static_cast<size_t>(keyframeInterval) ||
+                        !m_reference.HasSameBodies(frame.state);
+
+    DeltaFrame delta;
+    if (!needKeyframe && !EncodeDelta(frame.state, delta)) {
+        needKeyframe = true; // Motion too large for the quantisation tolerance
+    }
+
+    // Update the reference with exactly what a later Restore() will reconstruct
+    if (needKeyframe) {
+        m_reference = frame.state;
+    } else {
+        ApplyDelta(delta, m_reference);
+    }
+    m_referenceEpoch = frame.epoch;
+    m_hasReference = true;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (frame.epoch != m_epoch) {
+        m_hasReference = false; // Truncated while encoding
+        return;
+    }
+
+    if (needKeyframe) {
+        // A truncation always starts a new segment, so ids stay consecutive within one
+        Segment segment;
+        segment.keyframe = std::move(frame.state);
+        segment.firstId = m_nextFrameId;
+        segment.bytes = segment.keyframe.GetMemoryUsage();
+        m_memoryUsage += segment.bytes;
+        m_segments.push_back(std::move(segment));
+    } else {
+        size_t bytes = GetDeltaMemoryUsage(delta);
+        m_segments.back().deltas.push_back(std::move(delta));
+        m_segments.back().bytes += bytes;
+        m_memoryUsage += bytes;
+    }
+    ++m_frameCount;
+    ++m_nextFrameId;
+
+    EvictOldSegments();
+}
+
+bool RewindBuffer::EncodeDelta(const SimulationSnapshot& state, DeltaFrame& delta) const {
+    const size_t count = state.size();
+
+    glm::vec2 maxPosition(0.0f);
+    glm::vec2 maxVelocity(0.0f);
+    for (size_t i = 0; i < count; ++i) {
+        maxPosition = glm::max(maxPosition, glm::abs(state.positions[i] - m_reference.positions[i]));
+        maxVelocity = glm::max(maxVelocity, glm::abs(state.velocities[i] - m_reference.velocities[i]));
+    }
+
+    delta.positionScale = maxPosition / QUANTISATION_RANGE;
+    delta.velocityScale = maxVelocity / QUANTISATION_RANGE;
+
+    // Rounding error is at most half a quantisation step
+    if (std::max(delta.positionScale.x, delta.positionScale.y) * 0.5f > m_config.positionTolerance ||
+        std::max(delta.velocityScale.x, delta.velocityScale.y) * 0.5f > m_config.velocityTolerance) {
+        return false;
+    }
+
+    auto quantise = [](float value, float scale) -> int16_t {
+        if (scale <= 0.0f) return 0;
+        float q = std::round(value / scale);
+        return static_cast<int16_t>(std::clamp(q, -QUANTISATION_RANGE, QUANTISATION_RANGE));
+    };
+
+    delta.step = state.step;
+    delta.time = state.time;
+    delta.data.resize(count * 4);
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec2 dp = state.positions[i] - m_reference.positions[i];
+        glm::vec2 dv = state.velocities[i] - m_reference.velocities[i];
+        delta.data[i * 4 + 0] = quantise(dp.x, delta.positionScale.x);
+        delta.data[i * 4 + 1] = quantise(dp.y, delta.positionScale.y);
+        delta.data[i * 4 + 2] = quantise(dv.x, delta.velocityScale.x);
+        delta.data[i * 4 + 3] = quantise(dv.y, delta.velocityScale.y);
+    }
+    return true;
+}
+
+void RewindBuffer::ApplyDelta(const DeltaFrame& delta, SimulationSnapshot& state) {
+    state.step = delta.step;
+    state.time = delta.time;
+
+    const size_t count = state.size();
+    for (size_t i = 0; i < count; ++i) {
+        state.positions[i].x += delta.data[i * 4 + 0] * delta.positionScale.x;
+        state.positions[i].y += delta.data[i * 4 + 1] * delta.positionScale.y;
+        state.velocities[i].x += delta.data[i * 4 + 2] * delta.velocityScale.x;
+        state.velocities[i].y += delta.data[i * 4 + 3] * delta.velocityScale.y;
+    }
+}
+
+void RewindBuffer::EvictOldSegments() {
+    // Never evict the newest segment, the encoder is still appending to it
+    while (m_memoryUsage > m_config.memoryBudgetBytes && m_segments.size() > 1) {
+        const Segment& oldest = m_segments.front();
+        m_memoryUsage -= oldest.bytes;
+        m_frameCount -= oldest.GetFrameCount();
+        m_segments.pop_front();
+    }
+}
+
+size_t RewindBuffer::GetDeltaMemoryUsage(const DeltaFrame& delta) {
+    return sizeof(DeltaFrame) + delta.data.capacity() * sizeof(int16_t);
+}
+
+} // namespace nbody
@@ -0,0 +1,162 @@
+#include "core/SharedStatePublisher.h"
+#include "core/Body.h"
+#include <iostream>
+#include <algorithm>
+#include <new>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace nbody {
+
+using namespace shared_state;
+
+SharedStatePublisher::SharedStatePublisher(const SharedStateConfig& config) : m_config(config) {
+    m_config.publishInterval = std::max(1, m_config.publishInterval);
+    m_config.frameSlots = std::max(2u, m_config.frameSlots);
+}
+
+SharedStatePublisher::~SharedStatePublisher() {
+    Close();
+}
+
+bool SharedStatePublisher::Open() {
+    if (IsOpen()) return true;
+    return Map(std::max(1u, m_config.initialCapacity));
+}
+
+void SharedStatePublisher::Close() {
+    if (!IsOpen()) return;
+    Unmap();
+#ifndef _WIN32
+    shm_unlink(m_config.name.c_str());
+#endif
+}
+
+bool SharedStatePublisher::Map(uint32_t capacity) {
+#ifdef _WIN32
+    (void)capacity;
+    std::cerr << "Shared state publishing requires POSIX shared memory" << std::endl;
+    return false;
+#else
+    const size_t size = SegmentSize(capacity, m_config.frameSlots);
+
+    // Start from a fresh object so readers of an old run see it as stale
+    shm_unlink(m_config.name.c_str());
+    int fd = shm_open(m_config.name.c_str(), O_CREAT | O_RDWR | O_EXCL, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to create shared memory " << m_config.name << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        std::cerr << "Failed to size shared memory " << m_config.name << std::endl;
+        close(fd);
+        shm_unlink(m_config.name.c_str());
+        return false;
+    }
+
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        std::cerr << "Failed to map shared memory " << m_config.name << std::endl;
+        shm_unlink(m_config.name.c_str());
+        return false;
+    }
+
+    // Fresh pages are zeroed; construct the atomics in place before publishing the magic
+    auto* header = new (memory) SharedStateHeader();
+    header->version = VERSION;
+    header->frameSlots = m_config.frameSlots;
+    header->maxBodies = capacity;
+    header->frameStride = FrameStride(capacity);
+    header->framesOffset = sizeof(SharedStateHeader);
+    header->segmentSize = size;
+    header->latestFrame.store(0, std::memory_order_relaxed);
+    header->closed.store(0, std::memory_order_relaxed);
+    header->writerPid = static_cast<uint32_t>(getpid());
+
+    char* frames = static_cast<char*>(memory) + header->framesOffset;
+    for (uint32_t slot = 0; slot < m_config.frameSlots; ++slot) {
+        auto* frame = new (frames + slot * header->frameStride) SharedFrameHeader();
+        frame->sequence.store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = MAGIC;
+
+    m_header = header;
+    m_mappedSize = size;
+    m_framesPublished = 0;
+    return true;
+#endif
+}
+
+void SharedStatePublisher::Unmap() {
+#ifndef _WIN32
+    if (!m_header) return;
+    m_header->closed.store(1, std::memory_order_release);
+    munmap(m_header, m_mappedSize);
+#endif
+    m_header = nullptr;
+    m_mappedSize = 0;
+}
+
+bool SharedStatePublisher::Publish(const std::vector<std::unique_ptr<Body>>& bodies, uint64_t step, double time,
+                                   bool force) {
+    if (!m_header || (!force && step % static_cast<uint64_t>(m_config.publishInterval) != 0)) {
+        return false;
+    }
+
+    // Outgrown: move to a larger segment, readers notice the closed flag and reopen
+    if (bodies.size() > m_header->maxBodies) {
+        uint32_t capacity = static_cast<uint32_t>(std::max(bodies.size(), static_cast<size_t>(m_header->maxBodies) * 2));
+        Unmap();
+        if (!Map(capacity)) return false;
+    }
+
+    const uint64_t frameNumber = m_framesPublished;
+    char* frameBase = reinterpret_cast<char*>(m_header) + m_header->framesOffset +
+                      (frameNumber % m_header->frameSlots) * m_header->frameStride;
+    auto* frame = reinterpret_cast<SharedFrameHeader*>(frameBase);
+
+    // Seqlock: odd while writing
+    const uint64_t sequence = frame->sequence.load(std::memory_order_relaxed);
+    frame->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const uint32_t count = static_cast<uint32_t>(bodies.size());
+    frame->frameNumber = frameNumber;
+    frame->step = step;
+    frame->time = time;
+    frame->bodyCount = count;
+
+    const size_t arrayBytes = ArrayBytes(m_header->maxBodies);
+    char* arrays = frameBase + sizeof(SharedFrameHeader);
+    float* positionX = reinterpret_cast<float*>(arrays + POSITION_X * arrayBytes);
+    float* positionY = reinterpret_cast<float*>(arrays + POSITION_Y * arrayBytes);
+    float* velocityX = reinterpret_cast<float*>(arrays + VELOCITY_X * arrayBytes);
+    float* velocityY = reinterpret_cast<float*>(arrays + VELOCITY_Y * arrayBytes);
+    float* mass = reinterpret_cast<float*>(arrays + MASS * arrayBytes);
+    float* radius = reinterpret_cast<float*>(arrays + RADIUS * arrayBytes);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const Body& body = *bodies[i];
+        positionX[i] = body.GetPosition().x;
+        positionY[i] = body.GetPosition().y;
+        velocityX[i] = body.GetVelocity().x;
+        velocityY[i] = body.GetVelocity().y;
+        mass[i] = body.GetMass();
+        radius[i] = body.GetRadius();
+    }
+
+    frame->sequence.store(sequence + 2, std::memory_order_release);
+    m_header->latestFrame.store(frameNumber + 1, std::memory_order_release);
+    m_framesPublished++;
+    return true;
+}
+
+} // namespace nbody
@@ -0,0 +1,123 @@
+#include "core/SharedStateReader.h"
+#include <algorithm>
+#include <cstdint>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace nbody {
+
+using namespace shared_state;
+
+bool SharedFrameView::IsValid() const {
+    if (!header) return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return header->sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+SharedStateReader::~SharedStateReader() {
+    Close();
+}
+
+bool SharedStateReader::Open(const std::string& name) {
+    Close();
+#ifdef _WIN32
+    (void)name;
+    return false;
+#else
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SharedStateHeader)) {
+        close(fd);
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) return false;
+
+    const auto* header = static_cast<const SharedStateHeader*>(memory);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->magic != MAGIC || header->version != VERSION || header->segmentSize > size) {
+        munmap(memory, size);
+        return false;
+    }
+
+    m_header = header;
+    m_mappedSize = size;
+    return true;
+#endif
+}
+
+void SharedStateReader::Close() {
+#ifndef _WIN32
+    if (m_header) {
+        munmap(const_cast<SharedStateHeader*>(m_header), m_mappedSize);
+    }
+#endif
+    m_header = nullptr;
+    m_mappedSize = 0;
+}
+
+bool SharedStateReader::IsStale() const {
+    return !m_header || m_header->closed.load(std::memory_order_acquire) != 0;
+}
+
+uint64_t SharedStateReader::GetLatestFrameNumber() const {
+    if (!m_header) return UINT64_MAX;
+    uint64_t latest = m_header->latestFrame.load(std::memory_order_acquire);
+    return latest > 0 ? latest - 1 : UINT64_MAX;
+}
+
+bool SharedStateReader::Acquire(uint64_t frameNumber, SharedFrameView& view) const {
+    if (!m_header) return false;
+
+    // Only frames still in the ring can be read
+    uint64_t latest = m_header->latestFrame.load(std::memory_order_acquire);
+    if (frameNumber >= latest || latest - frameNumber > m_header->frameSlots) return false;
+
+    const char* frameBase = reinterpret_cast<const char*>(m_header) + m_header->framesOffset +
+                            (frameNumber % m_header->frameSlots) * m_header->frameStride;
+    const auto* frame = reinterpret_cast<const SharedFrameHeader*>(frameBase);
+
+    uint64_t sequence = frame->sequence.load(std::memory_order_acquire);
+    if (sequence & 1u) return false;
+
+    view.header = frame;
+    view.sequence = sequence;
+    view.frameNumber = frame->frameNumber;
+    view.step = frame->step;
+    view.time = frame->time;
+    view.bodyCount = std::min(frame->bodyCount, m_header->maxBodies);
+
+    const size_t arrayBytes = ArrayBytes(m_header->maxBodies);
+    const char* arrays = frameBase + sizeof(SharedFrameHeader);
+    view.positionX = reinterpret_cast<const float*>(arrays + POSITION_X * arrayBytes);
+    view.positionY = reinterpret_cast<const float*>(arrays + POSITION_Y * arrayBytes);
+    view.velocityX = reinterpret_cast<const float*>(arrays + VELOCITY_X * arrayBytes);
+    view.velocityY = reinterpret_cast<const float*>(arrays + VELOCITY_Y * arrayBytes);
+    view.mass = reinterpret_cast<const float*>(arrays + MASS * arrayBytes);
+    view.radius = reinterpret_cast<const float*>(arrays + RADIUS * arrayBytes);
+
+    // The slot may already hold a newer frame
+    return view.frameNumber == frameNumber && view.IsValid();
+}
+
+bool SharedStateReader::AcquireLatest(SharedFrameView& view) const {
+    // The newest frame is only rewritten a full ring later, so a few retries suffice
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        uint64_t latest = GetLatestFrameNumber();
+        if (latest == UINT64_MAX) return false;
+        if (Acquire(latest, view)) return true;
+    }
+    return false;
+}
+
+} // namespace nbody
@@ -0,0 +1,58 @@
+#include "core/SimulationSnapshot.h"
+#include "core/Body.h"
+
+namespace nbody {
+
+void SimulationSnapshot::Capture(const std::vector<std::unique_ptr<Body>>& bodies, uint64_t stepIndex, double simulationTime) {
+    step = stepIndex;
+    time = simulationTime;
+
+    const size_t count = bodies.size();
+    positions.resize(count);
+    velocities.resize(count);
+    masses.resize(count);
+    densities.resize(count);
+    colors.resize(count);
+    fixed.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const Body& body = *bodies[i];
+        positions[i] = body.GetPosition();
+        velocities[i] = body.GetVelocity();
+        masses[i] = body.GetMass();
+        densities[i] = body.GetDensity();
+        colors[i] = body.GetColor();
+        fixed[i] = body.IsFixed() ? 1 : 0;
+    }
+}
+
+void SimulationSnapshot::Restore(std::vector<std::unique_ptr<Body>>& bodies) const {
+    bodies.clear();
+    bodies.reserve(size());
+
+    for (size_t i = 0; i < size(); ++i) {
+        auto body = std::make_unique<Body>(positions[i], velocities[i], masses[i], colors[i]);
+        body->SetDensity(densities[i]);
+        body->SetFixed(fixed[i] != 0);
+        bodies.push_back(std::move(body));
+    }
+}
+
+size_t SimulationSnapshot::GetMemoryUsage() const {
+    return positions.capacity() * sizeof(glm::vec2) +
+           velocities.capacity() * sizeof(glm::vec2) +
+           masses.capacity() * sizeof(float) +
+           densities.capacity() * sizeof(float) +
+           colors.capacity() * sizeof(glm::vec3) +
+           fixed.capacity() * sizeof(uint8_t);
+}
+
+bool SimulationSnapshot::HasSameBodies(const SimulationSnapshot& other) const {
+    return size() == other.size() &&
+           masses == other.masses &&
+           densities == other.densities &&
+           fixed == other.fixed &&
+           colors == other.colors;
+}
+
+} // namespace nbody
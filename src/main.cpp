@@ -1,9 +1,31 @@
 #include "core/Application.h"
+#include "core/EnsembleRunner.h"
+#include "physics/StabilityScan.h"
+#include "physics/Parareal.h"
 #include <iostream>
 #include <cstdlib>
+#include <string>
 
-int main() {
+int main(int argc, char** argv) {
     try {
+        // Headless modes
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--ensemble") {
+                if (i + 1 >= argc) {
+                    std::cerr << "Usage: " << argv[0] << " --ensemble <spec file>" << std::endl;
+                    return EXIT_FAILURE;
+                }
+                return nbody::EnsembleRunner::RunFromCommandLine(argv[i + 1]);
+            }
+            if (arg == "--stability-scan") {
+                return nbody::StabilityScan::RunFromCommandLine(argc, argv, i + 1);
+            }
+            if (arg == "--parareal") {
+                return nbody::Parareal::RunFromCommandLine(argc, argv, i + 1);
+            }
+        }
+        
         nbody::Application app;
         
         if (!app.Initialize()) {
@@ -17,6 +17,7 @@ void BarnesHutTree::ReserveNodes(size_t expectedNodes) {
 }
 
 void BarnesHutTree::BuildTree(const std::vector<std::unique_ptr<Body>>& bodies) {
+    m_droppedIndices.clear();
     if (bodies.empty()) {
         m_root.reset();
         return;
@@ -48,6 +49,7 @@ void BarnesHutTree::BuildTree(const std::vector<std::unique_ptr<Body>>& bodies)
     m_root->totalMass = 0.0f;
     m_root->centerOfMass = glm::vec2(0.0f);
     m_root->body = nullptr;
+    m_root->bodyIndex = -1;
     m_root->isLeaf = true;
     // Clear children
     for (auto& child : m_root->children) {
@@ -58,13 +60,18 @@ void BarnesHutTree::BuildTree(const std::vector<std::unique_ptr<Body>>& bodies)
     int bodiesOutsideBounds = 0;
     
     // Insert bodies into the tree
-    for (const auto& body : bodies) {
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        const auto& body = bodies[i];
         // Ensure body is within the root bounds before inserting
         if (m_root->Contains(body->GetPosition())) {
-            InsertBody(m_root.get(), body.get());
-            bodiesInserted++;
+            if (InsertBody(m_root.get(), body.get(), static_cast<int>(i))) {
+                bodiesInserted++;
+            } else {
+                m_droppedIndices.push_back(static_cast<int>(i));
+            }
         } else {
             bodiesOutsideBounds++;
+            m_droppedIndices.push_back(static_cast<int>(i));
         }
     }
     
@@ -75,6 +82,9 @@ void BarnesHutTree::BuildTree(const std::vector<std::unique_ptr<Body>>& bodies)
     }
     #endif
     
+    // Bodies displaced from a split leaf are dropped out of order
+    std::sort(m_droppedIndices.begin(), m_droppedIndices.end());
+    
     // Calculate center of mass for each node
     UpdateMassAndCenter(m_root.get());
     
@@ -111,21 +121,22 @@ glm::vec2 BarnesHutTree::CalculateForce(const Body& body, float theta, float G,
     return force;
 }
 
-void BarnesHutTree::InsertBody(QuadTreeNode* node, Body* body) {
+bool BarnesHutTree::InsertBody(QuadTreeNode* node, Body* body, int bodyIndex) {
     // Iterative implementation to avoid recursion overhead
     QuadTreeNode* current = node;
     
     while (true) {
         // Safety check: ensure body is within node bounds
         if (!current->Contains(body->GetPosition())) {
-            return;
+            return false;
         }
         
         if (current->isLeaf) {
             if (current->body == nullptr) {
                 // Empty leaf, place the body here.
                 current->body = body;
-                return;
+                current->bodyIndex = bodyIndex;
+                return true;
             }
             
             // Leaf is occupied, so we must subdivide.
@@ -133,18 +144,21 @@ void BarnesHutTree::InsertBody(QuadTreeNode* node, Body* body) {
             // handle gracefully by placing in same node (bodies very close together)
             glm::vec2 delta = current->body->GetPosition() - body->GetPosition();
             if (glm::dot(delta, delta) < 1e-12f) {
-                return; // Bodies are essentially at same position
+                return false; // Bodies are essentially at same position
             }
 
             Body* existingBody = current->body;
+            int existingIndex = current->bodyIndex;
             current->body = nullptr;
+            current->bodyIndex = -1;
             current->isLeaf = false; // Mark as internal node
             Subdivide(current);
             
             // Insert existing body into correct child quadrant
             int existingQuadrant = current->GetQuadrant(existingBody->GetPosition());
-            if (current->children[existingQuadrant]) {
-                InsertBody(current->children[existingQuadrant].get(), existingBody);
+            if (!current->children[existingQuadrant] ||
+                !InsertBody(current->children[existingQuadrant].get(), existingBody, existingIndex)) {
+                m_droppedIndices.push_back(existingIndex);
             }
             
             // Continue loop to insert new body
@@ -153,7 +167,7 @@ void BarnesHutTree::InsertBody(QuadTreeNode* node, Body* body) {
                 current = current->children[newQuadrant].get();
                 continue;
             } else {
-                return;
+                return false;
             }
 
         } else { // Node is internal
@@ -163,7 +177,7 @@ void BarnesHutTree::InsertBody(QuadTreeNode* node, Body* body) {
                 current = current->children[quadrant].get();
                 continue;
             } else {
-                return;
+                return false;
             }
         }
     }
@@ -185,20 +199,24 @@ void BarnesHutTree::UpdateMassAndCenter(QuadTreeNode* node) {
         if (node->body) {
             node->totalMass = node->body->GetMass();
             node->centerOfMass = node->body->GetPosition();
+            node->maxRadius = node->body->GetRadius();
         } else {
             node->totalMass = 0.0f;
             node->centerOfMass = glm::vec2(0.0f);
+            node->maxRadius = 0.0f;
         }
     } else {
         // CORRECTED: Calculate center of mass for an internal node.
         // Sum weighted positions and total mass, then perform a single division.
         node->totalMass = 0.0f;
+        node->maxRadius = 0.0f;
         glm::vec2 weightedPositionSum(0.0f);
 
         for (int i = 0; i < 4; ++i) {
             if (node->children[i]) {
                 UpdateMassAndCenter(node->children[i].get());
                 
+                node->maxRadius = std::max(node->maxRadius, node->children[i]->maxRadius);
                 float childMass = node->children[i]->totalMass;
                 if (childMass > 0.0f) {
                     node->totalMass += childMass;
@@ -311,6 +329,82 @@ glm::vec2 BarnesHutTree::CalculateForceIterative(const Body& body, float theta,
     return totalForce;
 }
 
+glm::vec2 BarnesHutTree::CalculateForceAndContacts(const Body& body, int bodyIndex, float theta, float G,
+                                                   float softeningLength, std::vector<ContactPair>& contacts) const {
+    glm::vec2 totalForce(0.0f);
+    if (!m_root || m_root->totalMass <= 0.0f) {
+        return totalForce;
+    }
+    
+    const glm::vec2 position = body.GetPosition();
+    const float radius = body.GetRadius();
+    const float softeningSq = softeningLength * softeningLength;
+    
+    // Second member: the node's force is already accounted for, only look for contacts
+    thread_local std::vector<std::pair<const QuadTreeNode*, bool>> stack;
+    stack.clear();
+    stack.emplace_back(m_root.get(), false);
+    
+    while (!stack.empty()) {
+        const QuadTreeNode* node = stack.back().first;
+        bool contactsOnly = stack.back().second;
+        stack.pop_back();
+        
+        if (node->totalMass <= 0.0f) continue;
+        
+        // Could any body in this node overlap ours?
+        float halfSize = node->size * 0.5f;
+        float dx = std::max(std::abs(position.x - node->center.x) - halfSize, 0.0f);
+        float dy = std::max(std::abs(position.y - node->center.y) - halfSize, 0.0f);
+        float reach = radius + node->maxRadius;
+        bool mayTouch = dx * dx + dy * dy <= reach * reach;
+        
+        if (node->isLeaf) {
+            if (!node->body || node->body == &body) continue;
+            
+            glm::vec2 bodyToNode = node->centerOfMass - position;
+            float distanceSq = glm::dot(bodyToNode, bodyToNode);
+            if (mayTouch && node->bodyIndex > bodyIndex) {
+                float contactDistance = radius + node->body->GetRadius();
+                if (distanceSq <= contactDistance * contactDistance) {
+                    contacts.push_back({bodyIndex, node->bodyIndex});
+                }
+            }
+            if (contactsOnly || distanceSq <= 0.0f) continue;
+            
+            float distance = std::sqrt(distanceSq);
+            totalForce += (G * node->totalMass / (distanceSq + softeningSq)) * bodyToNode / distance;
+            m_stats.forceCalculations++;
+            continue;
+        }
+        
+        if (contactsOnly) {
+            if (!mayTouch) continue;
+        } else {
+            glm::vec2 bodyToNode = node->centerOfMass - position;
+            float distanceSq = glm::dot(bodyToNode, bodyToNode);
+            float distance = std::sqrt(distanceSq);
+            
+            // Same opening criterion as CalculateForceIterative
+            if (node->size / (distance + 1e-10f) < theta) {
+                if (distanceSq > 0.0f) {
+                    totalForce += (G * node->totalMass / (distanceSq + softeningSq)) * bodyToNode / distance;
+                    m_stats.forceCalculations++;
+                }
+                if (!mayTouch) continue;
+                contactsOnly = true;
+            }
+        }
+        
+        for (int i = 3; i >= 0; --i) {
+            if (node->children[i]) {
+                stack.emplace_back(node->children[i].get(), contactsOnly);
+            }
+        }
+    }
+    
+    return totalForce;
+}
 
 void BarnesHutTree::CalculateBounds(const std::vector<std::unique_ptr<Body>>& bodies, glm::vec2& center, float& size) const {
     if (bodies.empty()) {
@@ -0,0 +1,263 @@
+#include "physics/CloseEncounterSolver.h"
+#include "core/Body.h"
+#include <complex>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace nbody {
+
+namespace {
+
+using Complex = std::complex<double>;
+
+constexpr double PI = 3.14159265358979323846;
+constexpr int MAX_SUBSTEPS = 100000;
+
+/**
+ * @brief Levi-Civita state: z = u^2, fictitious time derivative '
+ */
+struct LCState {
+    Complex u;      // Regularized coordinate
+    Complex up;     // du/ds
+    double h;       // Kepler energy per reduced mass
+    double t;       // Physical time
+};
+
+LCState Derivative(const LCState& s, const Complex& perturbation) {
+    const double r = std::norm(s.u); // |u|^2 = |z|
+    LCState d;
+    d.u = s.up;
+    // u'' = (h/2) u + (r/2) conj(u) P
+    d.up = 0.5 * s.h * s.u + 0.5 * r * std::conj(s.u) * perturbation;
+    // h' = r (v . P) with v = 2 u' / conj(u)
+    d.h = 2.0 * std::real(std::conj(s.u) * std::conj(s.up) * perturbation);
+    d.t = r;
+    return d;
+}
+
+LCState StepRK4(const LCState& s, const Complex& perturbation, double ds) {
+    auto add = [](const LCState& a, const LCState& b, double f) {
+        return LCState{a.u + f * b.u, a.up + f * b.up, a.h + f * b.h, a.t + f * b.t};
+    };
+
+    LCState k1 = Derivative(s, perturbation);
+    LCState k2 = Derivative(add(s, k1, 0.5 * ds), perturbation);
+    LCState k3 = Derivative(add(s, k2, 0.5 * ds), perturbation);
+    LCState k4 = Derivative(add(s, k3, ds), perturbation);
+
+    LCState result;
+    result.u = s.u + ds / 6.0 * (k1.u + 2.0 * k2.u + 2.0 * k3.u + k4.u);
+    result.up = s.up + ds / 6.0 * (k1.up + 2.0 * k2.up + 2.0 * k3.up + k4.up);
+    result.h = s.h + ds / 6.0 * (k1.h + 2.0 * k2.h + 2.0 * k3.h + k4.h);
+    result.t = s.t + ds / 6.0 * (k1.t + 2.0 * k2.t + 2.0 * k3.t + k4.t);
+    return result;
+}
+
+} // namespace
+
+void CloseEncounterSolver::Clear() {
+    m_pairs.clear();
+    m_regularized.clear();
+    m_substeps = 0;
+}
+
+void CloseEncounterSolver::FindPairs(const std::vector<std::unique_ptr<Body>>& bodies, const Settings& settings,
+                                     const PairAccelerationFunc& pairAcceleration) {
+    m_pairs.clear();
+    m_regularized.assign(bodies.size(), 0);
+    if (bodies.size() < 2) return;
+
+    // A pair is "close" when its free-fall time sqrt(r^3 / G M) spans fewer than
+    // dynamicalSteps global steps, i.e. r < (K dt)^(2/3) (G M)^(1/3)
+    float maxMass = 0.0f;
+    for (const auto& body : bodies) {
+        maxMass = std::max(maxMass, body->GetMass());
+    }
+    const double window = static_cast<double>(settings.dynamicalSteps) * settings.timeStep;
+    const double cellSize = std::cbrt(window * window * settings.G * 2.0 * maxMass);
+    if (!(cellSize > 0.0)) return;
+
+    // Uniform grid hash so detection stays O(N)
+    auto cellKey = [cellSize](const glm::vec2& p) -> int64_t {
+        int64_t cx = static_cast<int64_t>(std::floor(p.x / cellSize));
+        int64_t cy = static_cast<int64_t>(std::floor(p.y / cellSize));
+        return (cx << 32) ^ (cy & 0xffffffffll);
+    };
+    std::unordered_map<int64_t, std::vector<int>> grid;
+    grid.reserve(bodies.size());
+    for (int i = 0; i < static_cast<int>(bodies.size()); ++i) {
+        grid[cellKey(bodies[i]->GetPosition())].push_back(i);
+    }
+
+    std::vector<RegularizedPair> candidates;
+    for (int i = 0; i < static_cast<int>(bodies.size()); ++i) {
+        const Body& a = *bodies[i];
+        if (a.IsFixed() || a.IsBeingDragged()) continue;
+
+        glm::vec2 p = a.GetPosition();
+        int64_t cx = static_cast<int64_t>(std::floor(p.x / cellSize));
+        int64_t cy = static_cast<int64_t>(std::floor(p.y / cellSize));
+
+        for (int64_t dx = -1; dx <= 1; ++dx) {
+            for (int64_t dy = -1; dy <= 1; ++dy) {
+                auto it = grid.find(((cx + dx) << 32) ^ ((cy + dy) & 0xffffffffll));
+                if (it == grid.end()) continue;
+
+                for (int j : it->second) {
+                    if (j <= i) continue;
+                    const Body& b = *bodies[j];
+                    if (b.IsFixed() || b.IsBeingDragged()) continue;
+
+                    glm::dvec2 r = glm::dvec2(b.GetPosition()) - glm::dvec2(a.GetPosition());
+                    glm::dvec2 v = glm::dvec2(b.GetVelocity()) - glm::dvec2(a.GetVelocity());
+                    double distance = glm::length(r);
+                    double mu = static_cast<double>(settings.G) * (a.GetMass() + b.GetMass());
+                    if (distance <= 0.0 || mu <= 0.0) continue;
+
+                    // Close: short free-fall time. Bound: negative relative energy.
+                    double freeFall = std::sqrt(distance * distance * distance / mu);
+                    double energy = 0.5 * glm::dot(v, v) - mu / distance;
+                    if (freeFall < window && energy < 0.0) {
+                        RegularizedPair pair;
+                        pair.first = i;
+                        pair.second = j;
+                        pair.separation = distance;
+                        candidates.push_back(pair);
+                    }
+                }
+            }
+        }
+    }
+
+    // Closest pairs first; each body joins at most one pair
+    std::sort(candidates.begin(), candidates.end(),
+              [](const RegularizedPair& x, const RegularizedPair& y) { return x.separation < y.separation; });
+
+    for (auto& pair : candidates) {
+        if (m_regularized[pair.first] || m_regularized[pair.second]) continue;
+
+        const Body& a = *bodies[pair.first];
+        const Body& b = *bodies[pair.second];
+
+        // Split off the mutual term the force pass added (including any softening/clamping)
+        pair.externalFirst = glm::dvec2(a.GetForce()) - glm::dvec2(pairAcceleration(a, b));
+        pair.externalSecond = glm::dvec2(b.GetForce()) - glm::dvec2(pairAcceleration(b, a));
+
+        // Reject strongly perturbed pairs, they are better served by the global integrator
+        double mu = static_cast<double>(settings.G) * (a.GetMass() + b.GetMass());
+        double mutual = mu / (pair.separation * pair.separation);
+        double tidal = glm::length(pair.externalSecond - pair.externalFirst);
+        if (tidal > settings.maxPerturbation * mutual) continue;
+
+        m_regularized[pair.first] = 1;
+        m_regularized[pair.second] = 1;
+        m_pairs.push_back(pair);
+    }
+}
+
+void CloseEncounterSolver::Integrate(std::vector<std::unique_ptr<Body>>& bodies, const Settings& settings,
+                                     float deltaTime) {
+    m_substeps = 0;
+
+    for (const auto& pair : m_pairs) {
+        Body& a = *bodies[pair.first];
+        Body& b = *bodies[pair.second];
+
+        const double ma = a.GetMass();
+        const double mb = b.GetMass();
+        const double total = ma + mb;
+        const double dt = deltaTime;
+
+        // Centre of mass moves under the mass-weighted external acceleration
+        glm::dvec2 com = (glm::dvec2(a.GetPosition()) * ma + glm::dvec2(b.GetPosition()) * mb) / total;
+        glm::dvec2 comVelocity = (glm::dvec2(a.GetVelocity()) * ma + glm::dvec2(b.GetVelocity()) * mb) / total;
+        glm::dvec2 comAcceleration = (pair.externalFirst * ma + pair.externalSecond * mb) / total;
+
+        com += comVelocity * dt + comAcceleration * (0.5 * dt * dt);
+        comVelocity += comAcceleration * dt;
+
+        // Relative motion: exact Kepler singularity, tidal term as perturbation
+        glm::dvec2 relative = glm::dvec2(b.GetPosition()) - glm::dvec2(a.GetPosition());
+        glm::dvec2 relativeVelocity = glm::dvec2(b.GetVelocity()) - glm::dvec2(a.GetVelocity());
+        m_substeps += AdvanceRelativeOrbit(relative, relativeVelocity, settings.G * total,
+                                           pair.externalSecond - pair.externalFirst, dt,
+                                           settings.substepsPerOrbit);
+
+        a.SetPosition(glm::vec2(com - relative * (mb / total)));
+        b.SetPosition(glm::vec2(com + relative * (ma / total)));
+        a.SetVelocity(glm::vec2(comVelocity - relativeVelocity * (mb / total)));
+        b.SetVelocity(glm::vec2(comVelocity + relativeVelocity * (ma / total)));
+
+        // Leave only the external part so adaptive stepping ignores the pair's own orbit
+        a.SetForce(glm::vec2(pair.externalFirst));
+        b.SetForce(glm::vec2(pair.externalSecond));
+    }
+}
+
+int CloseEncounterSolver::AdvanceRelativeOrbit(glm::dvec2& position, glm::dvec2& velocity, double mu,
+                                               const glm::dvec2& perturbation, double deltaTime,
+                                               int substepsPerOrbit) {
+    const Complex z(position.x, position.y);
+    const Complex v(velocity.x, velocity.y);
+    const Complex P(perturbation.x, perturbation.y);
+    const double r0 = std::abs(z);
+    if (r0 <= 0.0 || mu <= 0.0 || deltaTime <= 0.0) return 0;
+
+    LCState state;
+    state.u = std::sqrt(z);
+    state.up = 0.5 * v * std::conj(state.u);
+    state.h = 0.5 * std::norm(v) - mu / r0;
+    state.t = 0.0;
+
+    // Fictitious-time step: a fixed fraction of the orbit, 2*pi*sqrt(a/mu) per period in s
+    const double scale = state.h < 0.0 ? mu / (-2.0 * state.h) : r0;
+    const double ds = 2.0 * PI * std::sqrt(scale / mu) / std::max(8, substepsPerOrbit);
+
+    int steps = 0;
+    while (steps < MAX_SUBSTEPS) {
+        double r = std::norm(state.u);
+        double remaining = deltaTime - state.t;
+        if (remaining <= 0.0) break;
+
+        if (r * ds < remaining) {
+            state = StepRK4(state, P, ds);
+            ++steps;
+            continue;
+        }
+
+        // Final partial step: solve t(s) = deltaTime with a few secant iterations
+        double s0 = 0.0, t0 = state.t;
+        double s1 = remaining / std::max(r, 1e-300);
+        LCState trial = StepRK4(state, P, s1);
+        for (int iteration = 0; iteration < 4; ++iteration) {
+            double error = trial.t - deltaTime;
+            if (std::abs(error) <= 1e-14 * deltaTime) break;
+            double slope = (trial.t - t0) / (s1 - s0);
+            if (!(std::abs(slope) > 0.0)) break;
+            s0 = s1;
+            t0 = trial.t;
+            s1 -= error / slope;
+            trial = StepRK4(state, P, s1);
+        }
+        state = trial;
+        ++steps;
+        break;
+    }
+
+    const Complex zNew = state.u * state.u;
+    const Complex vNew = 2.0 * state.up / std::conj(state.u);
+    position = glm::dvec2(zNew.real(), zNew.imag());
+    velocity = glm::dvec2(vNew.real(), vNew.imag());
+
+    // Absorb any residual time mismatch with a short drift
+    double residual = deltaTime - state.t;
+    if (residual != 0.0 && std::abs(residual) < 1e-3 * deltaTime) {
+        position += velocity * residual;
+    }
+
+    return steps;
+}
+
+} // namespace nbody
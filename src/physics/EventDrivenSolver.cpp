@@ -0,0 +1,254 @@
+#include "physics/EventDrivenSolver.h"
+#include "core/Body.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace nbody {
+
+void EventDrivenSolver::Advance(std::vector<std::unique_ptr<Body>>& bodies, const Settings& settings,
+                                double deltaTime) {
+    m_collisions = 0;
+    m_cellCrossings = 0;
+    m_staleEvents = 0;
+    m_cappedBodies = 0;
+    m_hitEventLimit = false;
+
+    const int count = static_cast<int>(bodies.size());
+    if (count == 0 || deltaTime <= 0.0) return;
+
+    m_positions.resize(count);
+    m_velocities.resize(count);
+    m_times.assign(count, 0.0);
+    m_radii.resize(count);
+    m_inverseMasses.resize(count);
+    m_counts.assign(count, 0);
+    m_maxCollisions = static_cast<uint32_t>(std::max(1, settings.maxCollisionsPerBody));
+    for (int i = 0; i < count; ++i) {
+        const Body& body = *bodies[i];
+        bool immovable = body.IsFixed() || body.IsBeingDragged() || body.GetMass() <= 0.0f;
+        m_positions[i] = glm::dvec2(body.GetPosition());
+        m_velocities[i] = immovable ? glm::dvec2(0.0) : glm::dvec2(body.GetVelocity());
+        m_radii[i] = body.GetRadius();
+        m_inverseMasses[i] = immovable ? 0.0 : 1.0 / body.GetMass();
+    }
+
+    BuildGrid(bodies, deltaTime);
+
+    m_events = decltype(m_events)();
+    for (int i = 0; i < count; ++i) {
+        PredictCollisions(i, 0.0, deltaTime, true);
+        PredictCellCrossing(i, 0.0, deltaTime);
+    }
+
+    const double restitution = settings.restitution;
+    const uint64_t eventLimit = static_cast<uint64_t>(std::max(1, settings.maxEventsPerBody)) * count + 1024;
+    uint64_t processed = 0;
+
+    while (!m_events.empty()) {
+        Event event = m_events.top();
+        m_events.pop();
+
+        // Lazy invalidation: a participant collided after this was predicted
+        if (m_counts[event.first] != event.firstCount ||
+            (event.second >= 0 && m_counts[event.second] != event.secondCount)) {
+            m_staleEvents++;
+            continue;
+        }
+        if (++processed > eventLimit) {
+            m_hitEventLimit = true;
+            break;
+        }
+
+        if (event.second < 0) {
+            // Cell crossing: the trajectory is unchanged, so existing predictions stay valid
+            AdvanceBody(event.first, event.time);
+            RemoveFromCell(event.first);
+            InsertIntoCell(event.first, event.newCell);
+            m_cellCrossings++;
+            PredictCollisions(event.first, event.time, deltaTime, false);
+            PredictCellCrossing(event.first, event.time, deltaTime);
+            continue;
+        }
+
+        AdvanceBody(event.first, event.time);
+        AdvanceBody(event.second, event.time);
+        Collide(event.first, event.second, restitution);
+        m_collisions++;
+        for (int body : {event.first, event.second}) {
+            if (++m_counts[body] == m_maxCollisions) m_cappedBodies++;
+        }
+
+        for (int body : {event.first, event.second}) {
+            PredictCollisions(body, event.time, deltaTime, false);
+            PredictCellCrossing(body, event.time, deltaTime);
+        }
+    }
+
+    // Bring every clock to the end of the step
+    for (int i = 0; i < count; ++i) {
+        AdvanceBody(i, deltaTime);
+        Body& body = *bodies[i];
+        if (m_inverseMasses[i] <= 0.0) continue;
+        body.SetPosition(glm::vec2(m_positions[i]));
+        body.SetVelocity(glm::vec2(m_velocities[i]));
+    }
+}
+
+void EventDrivenSolver::BuildGrid(const std::vector<std::unique_ptr<Body>>& bodies, double deltaTime) {
+    const int count = static_cast<int>(bodies.size());
+
+    glm::dvec2 minimum = m_positions[0];
+    glm::dvec2 maximum = m_positions[0];
+    double maxRadius = 0.0;
+    double maxSpeed = 0.0;
+    for (int i = 0; i < count; ++i) {
+        minimum = glm::min(minimum, m_positions[i]);
+        maximum = glm::max(maximum, m_positions[i]);
+        maxRadius = std::max(maxRadius, m_radii[i]);
+        maxSpeed = std::max(maxSpeed, glm::length(m_velocities[i]));
+    }
+
+    // Cover where bodies can get to this step. Collisions can still throw a body
+    // further; the edge cells extend to infinity, so it just stays in one of them.
+    double margin = maxSpeed * deltaTime + 2.0 * maxRadius;
+    minimum -= glm::dvec2(margin);
+    maximum += glm::dvec2(margin);
+    double extent = std::max(maximum.x - minimum.x, maximum.y - minimum.y);
+
+    // Cells at least one diameter wide so touching bodies are always in neighboring cells
+    int cellsPerAxis = std::clamp(static_cast<int>(2.0 * std::sqrt(static_cast<double>(count))), 1, MAX_CELLS_PER_AXIS);
+    m_cellSize = std::max(2.0 * maxRadius, extent / cellsPerAxis);
+    if (m_cellSize <= 0.0) m_cellSize = 1.0;
+    m_gridOrigin = minimum;
+    m_cellsX = std::clamp(static_cast<int>(std::ceil((maximum.x - minimum.x) / m_cellSize)), 1, MAX_CELLS_PER_AXIS);
+    m_cellsY = std::clamp(static_cast<int>(std::ceil((maximum.y - minimum.y) / m_cellSize)), 1, MAX_CELLS_PER_AXIS);
+
+    m_cellHeads.assign(static_cast<size_t>(m_cellsX) * m_cellsY, -1);
+    m_next.assign(count, -1);
+    m_previous.assign(count, -1);
+    m_cellOfBody.assign(count, -1);
+    for (int i = 0; i < count; ++i) {
+        InsertIntoCell(i, CellOf(m_positions[i]));
+    }
+}
+
+int EventDrivenSolver::CellOf(const glm::dvec2& position) const {
+    int x = std::clamp(static_cast<int>(std::floor((position.x - m_gridOrigin.x) / m_cellSize)), 0, m_cellsX - 1);
+    int y = std::clamp(static_cast<int>(std::floor((position.y - m_gridOrigin.y) / m_cellSize)), 0, m_cellsY - 1);
+    return y * m_cellsX + x;
+}
+
+void EventDrivenSolver::InsertIntoCell(int body, int cell) {
+    m_cellOfBody[body] = cell;
+    m_previous[body] = -1;
+    m_next[body] = m_cellHeads[cell];
+    if (m_cellHeads[cell] >= 0) m_previous[m_cellHeads[cell]] = body;
+    m_cellHeads[cell] = body;
+}
+
+void EventDrivenSolver::RemoveFromCell(int body) {
+    int cell = m_cellOfBody[body];
+    if (m_previous[body] >= 0) {
+        m_next[m_previous[body]] = m_next[body];
+    } else {
+        m_cellHeads[cell] = m_next[body];
+    }
+    if (m_next[body] >= 0) m_previous[m_next[body]] = m_previous[body];
+    m_next[body] = m_previous[body] = -1;
+    m_cellOfBody[body] = -1;
+}
+
+void EventDrivenSolver::AdvanceBody(int body, double time) {
+    m_positions[body] += m_velocities[body] * (time - m_times[body]);
+    m_times[body] = time;
+}
+
+void EventDrivenSolver::PredictCollisions(int body, double now, double endTime, bool onlyHigher) {
+    if (m_counts[body] >= m_maxCollisions) return;
+
+    const int cell = m_cellOfBody[body];
+    const int cellX = cell % m_cellsX;
+    const int cellY = cell / m_cellsX;
+
+    for (int y = std::max(0, cellY - 1); y <= std::min(m_cellsY - 1, cellY + 1); ++y) {
+        for (int x = std::max(0, cellX - 1); x <= std::min(m_cellsX - 1, cellX + 1); ++x) {
+            for (int other = m_cellHeads[y * m_cellsX + x]; other >= 0; other = m_next[other]) {
+                if (other == body || (onlyHigher && other < body) || m_counts[other] >= m_maxCollisions) continue;
+                if (m_inverseMasses[body] + m_inverseMasses[other] <= 0.0) continue;
+
+                // Relative motion from now, with the other body brought to the same clock
+                glm::dvec2 p = m_positions[other] + m_velocities[other] * (now - m_times[other]) - m_positions[body];
+                glm::dvec2 w = m_velocities[other] - m_velocities[body];
+                double b = glm::dot(p, w);
+                if (b >= 0.0) continue; // Not approaching
+
+                double contact = m_radii[body] + m_radii[other];
+                double c = glm::dot(p, p) - contact * contact;
+                double delay = 0.0;
+                if (c > 0.0) {
+                    double a = glm::dot(w, w);
+                    double discriminant = b * b - a * c;
+                    if (discriminant < 0.0) continue;
+                    delay = c / (-b + std::sqrt(discriminant)); // Smaller root, stable form
+                }
+                if (now + delay <= endTime) {
+                    m_events.push({now + delay, body, other, m_counts[body], m_counts[other], -1});
+                }
+            }
+        }
+    }
+}
+
+void EventDrivenSolver::PredictCellCrossing(int body, double now, double endTime) {
+    const glm::dvec2& velocity = m_velocities[body];
+    if (velocity.x == 0.0 && velocity.y == 0.0) return;
+
+    const int cell = m_cellOfBody[body];
+    const int cellX = cell % m_cellsX;
+    const int cellY = cell / m_cellsX;
+    const glm::dvec2& position = m_positions[body];
+
+    double bestDelay = std::numeric_limits<double>::infinity();
+    int bestCell = -1;
+
+    // Edge cells are open to the outside, so there is nothing to cross past them
+    if (velocity.x > 0.0 && cellX < m_cellsX - 1) {
+        double delay = (m_gridOrigin.x + (cellX + 1) * m_cellSize - position.x) / velocity.x;
+        if (delay < bestDelay) { bestDelay = delay; bestCell = cell + 1; }
+    } else if (velocity.x < 0.0 && cellX > 0) {
+        double delay = (m_gridOrigin.x + cellX * m_cellSize - position.x) / velocity.x;
+        if (delay < bestDelay) { bestDelay = delay; bestCell = cell - 1; }
+    }
+    if (velocity.y > 0.0 && cellY < m_cellsY - 1) {
+        double delay = (m_gridOrigin.y + (cellY + 1) * m_cellSize - position.y) / velocity.y;
+        if (delay < bestDelay) { bestDelay = delay; bestCell = cell + m_cellsX; }
+    } else if (velocity.y < 0.0 && cellY > 0) {
+        double delay = (m_gridOrigin.y + cellY * m_cellSize - position.y) / velocity.y;
+        if (delay < bestDelay) { bestDelay = delay; bestCell = cell - m_cellsX; }
+    }
+
+    if (bestCell >= 0) {
+        double time = now + std::max(0.0, bestDelay);
+        if (time <= endTime) {
+            m_events.push({time, body, -1, m_counts[body], 0, bestCell});
+        }
+    }
+}
+
+void EventDrivenSolver::Collide(int first, int second, double restitution) {
+    glm::dvec2 delta = m_positions[second] - m_positions[first];
+    double distance = glm::length(delta);
+    if (distance <= 0.0) return;
+
+    glm::dvec2 normal = delta / distance;
+    double velocityAlongNormal = glm::dot(m_velocities[second] - m_velocities[first], normal);
+    if (velocityAlongNormal >= 0.0) return;
+
+    double impulse = -(1.0 + restitution) * velocityAlongNormal /
+                     (m_inverseMasses[first] + m_inverseMasses[second]);
+    m_velocities[first] -= impulse * m_inverseMasses[first] * normal;
+    m_velocities[second] += impulse * m_inverseMasses[second] * normal;
+}
+
+} // namespace nbody
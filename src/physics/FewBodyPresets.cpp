@@ -0,0 +1,34 @@
+#include "physics/FewBodyPresets.h"
+#include <cmath>
+
+namespace nbody {
+
+bool GetFewBodyPreset(const std::string& name, std::vector<FewBodyInitial>& bodies) {
+    if (name == "figure8") {
+        // Chenciner-Montgomery figure-eight, G = m = 1
+        bodies = {
+            {-0.97000436, 0.24308753, 0.466203685, 0.43236573, 1.0},
+            {0.97000436, -0.24308753, 0.466203685, 0.43236573, 1.0},
+            {0.0, 0.0, -0.93240737, -0.86473146, 1.0}
+        };
+        return true;
+    }
+    if (name == "triple") {
+        // Hierarchical triple matching the "Triple Star" preset with G = 1
+        const double m1 = 8.0, m2 = 6.0, m3 = 10.0;
+        const double separation = 40.0;
+        const double inner = m1 + m2;
+        const double vInner = std::sqrt(inner / separation);
+        const double outer = 120.0;
+        const double vOuter = std::sqrt((inner + m3) / outer) * 0.8;
+        bodies = {
+            {-separation * m2 / inner, 0.0, 0.0, vInner * m2 / inner, m1},
+            {separation * m1 / inner, 0.0, 0.0, -vInner * m1 / inner, m2},
+            {outer, 0.0, 0.0, -vOuter, m3}
+        };
+        return true;
+    }
+    return false;
+}
+
+} // namespace nbody
@@ -0,0 +1,152 @@
+#include "physics/KDTree.h"
+#include "core/Body.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace nbody {
+
+void KDTree::BuildTree(const std::vector<std::unique_ptr<Body>>& bodies) {
+    const int count = static_cast<int>(bodies.size());
+    m_items.resize(count);
+    m_nodes.clear();
+    m_stats = TreeStats();
+    if (count == 0) return;
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; ++i) {
+        m_items[i] = {bodies[i]->GetPosition(), bodies[i]->GetMass(), i};
+    }
+
+    // Every split leaves at least one body on each side, so there are at most 2N - 1 nodes
+    m_nodes.resize(2 * static_cast<size_t>(count));
+    m_nodeCount = 1;
+
+    #pragma omp parallel
+    #pragma omp single
+    Build(0, 0, count);
+
+    m_nodes.resize(m_nodeCount);
+    CountNodes();
+}
+
+void KDTree::Build(int nodeIndex, int first, int count) {
+    KDTreeNode& node = m_nodes[nodeIndex];
+    node.first = first;
+    node.count = count;
+
+    const Item* items = m_items.data() + first;
+    node.boundsMin = node.boundsMax = items[0].position;
+    for (int i = 1; i < count; ++i) {
+        node.boundsMin = glm::min(node.boundsMin, items[i].position);
+        node.boundsMax = glm::max(node.boundsMax, items[i].position);
+    }
+
+    if (count > LEAF_SIZE) {
+        // Median along the longer side of the bounds
+        const glm::vec2 extent = node.boundsMax - node.boundsMin;
+        const int axis = extent.x >= extent.y ? 0 : 1;
+        const int half = count / 2;
+        Item* begin = m_items.data() + first;
+        std::nth_element(begin, begin + half, begin + count,
+                         [axis](const Item& a, const Item& b) { return a.position[axis] < b.position[axis]; });
+
+        node.children = m_nodeCount.fetch_add(2);
+        const int left = node.children;
+        if (count > PARALLEL_BUILD_SIZE) {
+            #pragma omp task
+            Build(left, first, half);
+            Build(left + 1, first + half, count - half);
+            #pragma omp taskwait
+        } else {
+            Build(left, first, half);
+            Build(left + 1, first + half, count - half);
+        }
+    }
+
+    // Mass moments, from the bodies for leaves and from the children otherwise
+    float totalMass = 0.0f;
+    glm::vec2 weightedPositionSum(0.0f);
+    if (node.IsLeaf()) {
+        for (int i = 0; i < count; ++i) {
+            totalMass += items[i].mass;
+            weightedPositionSum += items[i].position * items[i].mass;
+        }
+    } else {
+        for (int c = 0; c < 2; ++c) {
+            const KDTreeNode& child = m_nodes[node.children + c];
+            totalMass += child.totalMass;
+            weightedPositionSum += child.centerOfMass * child.totalMass;
+        }
+    }
+    node.totalMass = totalMass;
+    node.centerOfMass = totalMass > 1e-9f ? weightedPositionSum / totalMass
+                                          : (node.boundsMin + node.boundsMax) * 0.5f;
+
+    glm::vec2 farthest = glm::max(node.centerOfMass - node.boundsMin, node.boundsMax - node.centerOfMass);
+    node.bmax = glm::length(farthest);
+}
+
+void KDTree::CountNodes() {
+    m_stats.totalNodes = static_cast<int>(m_nodes.size());
+
+    std::vector<std::pair<int, int>> stack{{0, 0}};
+    while (!stack.empty()) {
+        auto [index, depth] = stack.back();
+        stack.pop_back();
+        m_stats.maxDepth = std::max(m_stats.maxDepth, depth);
+        const KDTreeNode& node = m_nodes[index];
+        if (node.IsLeaf()) {
+            m_stats.leafNodes++;
+        } else {
+            stack.push_back({node.children, depth + 1});
+            stack.push_back({node.children + 1, depth + 1});
+        }
+    }
+}
+
+glm::vec2 KDTree::CalculateForce(const glm::vec2& position, int bodyIndex, float theta, float G,
+                                 float softeningLength, int& interactions) const {
+    glm::vec2 totalForce(0.0f);
+    if (m_nodes.empty()) return totalForce;
+
+    // The quadtree's size / d < theta is bmax / d < theta / sqrt(2) for a square centred on its
+    // mass, so the same theta gives about the same accuracy with either tree
+    const float theta2 = 0.5f * theta * theta;
+    const float softeningSq = softeningLength * softeningLength;
+
+    int stack[MAX_STACK];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const KDTreeNode& node = m_nodes[stack[--top]];
+        if (node.totalMass <= 0.0f) continue;
+
+        glm::vec2 bodyToNode = node.centerOfMass - position;
+        float distanceSq = glm::dot(bodyToNode, bodyToNode);
+
+        // Bmax opening criterion; a node around the body is never replaced by its centre of mass
+        if (node.bmax * node.bmax < theta2 * distanceSq && !node.Contains(position)) {
+            float distance = std::sqrt(distanceSq);
+            totalForce += (G * node.totalMass / (distanceSq + softeningSq)) * bodyToNode / distance;
+            interactions++;
+        } else if (node.IsLeaf()) {
+            const Item* items = m_items.data() + node.first;
+            for (int i = 0; i < node.count; ++i) {
+                if (items[i].index == bodyIndex) continue;
+                glm::vec2 delta = items[i].position - position;
+                float deltaSq = glm::dot(delta, delta);
+                if (deltaSq <= 1e-10f) continue;
+                totalForce += (G * items[i].mass / (deltaSq + softeningSq)) * delta / std::sqrt(deltaSq);
+                interactions++;
+            }
+        } else {
+            stack[top++] = node.children + 1;
+            stack[top++] = node.children;
+        }
+    }
+    return totalForce;
+}
+
+} // namespace nbody
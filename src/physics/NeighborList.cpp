@@ -0,0 +1,120 @@
+#include "physics/NeighborList.h"
+#include "core/Body.h"
+#include <omp.h>
+#include <algorithm>
+
+namespace nbody {
+
+bool ContactNeighborList::Update(const std::vector<std::unique_ptr<Body>>& bodies, float skin) {
+    skin = std::max(skin, 0.0f);
+    if (!NeedsRebuild(bodies, skin)) {
+        m_stepsSinceRebuild++;
+        return false;
+    }
+    Rebuild(bodies, skin);
+    return true;
+}
+
+bool ContactNeighborList::NeedsRebuild(const std::vector<std::unique_ptr<Body>>& bodies, float skin) const {
+    if (skin != m_skin || bodies.size() != m_referenceBodies.size()) return true;
+
+    const float limitSq = 0.25f * skin * skin;
+    const int count = static_cast<int>(bodies.size());
+    bool rebuild = false;
+
+    // Replaced bodies or changed radii invalidate the lists as much as movement does
+    #pragma omp parallel for reduction(||:rebuild) schedule(static)
+    for (int i = 0; i < count; ++i) {
+        const Body& body = *bodies[i];
+        glm::vec2 displacement = body.GetPosition() - m_referencePositions[i];
+        rebuild = rebuild || &body != m_referenceBodies[i] || body.GetRadius() != m_referenceRadii[i] ||
+                  glm::dot(displacement, displacement) > limitSq;
+    }
+    return rebuild;
+}
+
+void ContactNeighborList::Rebuild(const std::vector<std::unique_ptr<Body>>& bodies, float skin) {
+    const size_t count = bodies.size();
+    const int n = static_cast<int>(count);
+
+    m_skin = skin;
+    m_stepsSinceRebuild = 0;
+    m_referenceBodies.resize(count);
+    m_referencePositions.resize(count);
+    m_referenceRadii.resize(count);
+    float maxRadius = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        m_referenceBodies[i] = bodies[i].get();
+        m_referencePositions[i] = bodies[i]->GetPosition();
+        m_referenceRadii[i] = bodies[i]->GetRadius();
+        maxRadius = std::max(maxRadius, m_referenceRadii[i]);
+    }
+
+    m_offsets.assign(count + 1, 0);
+    m_neighbors.clear();
+    if (count == 0) return;
+
+    // Candidates from the tree into per-thread buffers. The tree only finds
+    // partners it holds, so pairs whose higher index was dropped are added below.
+    m_tree.BuildTree(bodies);
+    m_threadPairs.resize(omp_get_max_threads());
+    for (auto& pairs : m_threadPairs) {
+        pairs.clear();
+    }
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int i = 0; i < n; ++i) {
+        auto& pairs = m_threadPairs[omp_get_thread_num()];
+        const float radius = m_referenceRadii[i];
+        m_tree.ForEachBodyInRadius(m_referencePositions[i], radius + maxRadius + skin,
+            [&, i](const Body& other, int j) {
+                if (j <= i) return;
+                float reach = radius + other.GetRadius() + skin;
+                glm::vec2 delta = other.GetPosition() - m_referencePositions[i];
+                if (glm::dot(delta, delta) <= reach * reach) {
+                    pairs.emplace_back(static_cast<uint32_t>(i), static_cast<uint32_t>(j));
+                }
+            });
+    }
+
+    // Bodies the tree left out (coincident with another) are checked against every lower index
+    const std::vector<int>& dropped = m_tree.GetDroppedIndices();
+    const int droppedCount = static_cast<int>(dropped.size());
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int d = 0; d < droppedCount; ++d) {
+        auto& pairs = m_threadPairs[omp_get_thread_num()];
+        const int j = dropped[d];
+        for (int i = 0; i < j; ++i) {
+            float reach = m_referenceRadii[i] + m_referenceRadii[j] + skin;
+            glm::vec2 delta = m_referencePositions[j] - m_referencePositions[i];
+            if (glm::dot(delta, delta) <= reach * reach) {
+                pairs.emplace_back(static_cast<uint32_t>(i), static_cast<uint32_t>(j));
+            }
+        }
+    }
+
+    // Counting sort of the pairs into rows
+    for (const auto& pairs : m_threadPairs) {
+        for (const auto& pair : pairs) {
+            m_offsets[pair.first + 1]++;
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        m_offsets[i + 1] += m_offsets[i];
+    }
+    m_neighbors.resize(m_offsets[count]);
+    std::vector<uint32_t> cursor(m_offsets.begin(), m_offsets.end() - 1);
+    for (const auto& pairs : m_threadPairs) {
+        for (const auto& pair : pairs) {
+            m_neighbors[cursor[pair.first]++] = pair.second;
+        }
+    }
+
+    // Ascending rows visit pairs in the same order as the direct pass
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (int i = 0; i < n; ++i) {
+        std::sort(m_neighbors.begin() + m_offsets[i], m_neighbors.begin() + m_offsets[i + 1]);
+    }
+}
+
+} // namespace nbody
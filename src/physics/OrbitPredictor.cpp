@@ -0,0 +1,339 @@
+#include "physics/OrbitPredictor.h"
+#include "physics/BarnesHut.h"
+#include "core/Body.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace nbody {
+
+namespace {
+
+// Position and velocity of the predicted body
+struct State {
+    glm::dvec2 x{0.0};
+    glm::dvec2 v{0.0};
+};
+
+State operator+(const State& a, const State& b) { return {a.x + b.x, a.v + b.v}; }
+State operator*(double s, const State& a) { return {s * a.x, s * a.v}; }
+
+} // namespace
+
+void OrbitPredictor::Request(const std::vector<std::unique_ptr<Body>>& bodies, size_t index,
+                             const BarnesHutTree* tree, const Settings& settings, bool rebuildField) {
+    if (index >= bodies.size()) return;
+
+    if (rebuildField || !m_hasField) {
+        BuildField(bodies, index, tree, settings);
+        m_hasField = true;
+    }
+
+    const Body& body = *bodies[index];
+    Job job;
+    job.field = m_field;
+    job.position = glm::dvec2(body.GetPosition());
+    job.velocity = glm::dvec2(body.GetVelocity());
+    job.radius = body.GetRadius();
+    job.settings = settings;
+    m_worker.Submit(std::move(job));
+}
+
+void OrbitPredictor::Cancel() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_worker.Cancel();
+    m_hasField = false;
+    m_path.clear();
+    m_pathVersion++;
+}
+
+bool OrbitPredictor::FetchPath(std::vector<glm::vec2>& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_pathVersion == m_fetchedVersion) return false;
+    path = m_path;
+    m_fetchedVersion = m_pathVersion;
+    return true;
+}
+
+void OrbitPredictor::BuildField(const std::vector<std::unique_ptr<Body>>& bodies, size_t index,
+                                const BarnesHutTree* tree, const Settings& settings) {
+    m_field.clear();
+    m_cells.clear();
+    m_cellNodes.clear();
+
+    const size_t count = bodies.size();
+    const double softeningSq = static_cast<double>(settings.softeningLength) * settings.softeningLength;
+    auto exactSource = [&](const Body& body) {
+        return Source{glm::dvec2(body.GetPosition()), body.GetMass(), softeningSq, body.GetRadius()};
+    };
+
+    // Small systems are cheap enough to take exactly
+    if (count <= MAX_EXACT_FIELD) {
+        for (size_t i = 0; i < count; ++i) {
+            if (i != index) m_field.push_back(exactSource(*bodies[i]));
+        }
+        return;
+    }
+
+    // Far field: the top levels of the tree, or a uniform grid if the last step didn't build one
+    const int depth = std::clamp(settings.fieldDepth, 1, 8);
+    const int gridSize = 1 << depth;
+    const QuadTreeNode* root = tree ? tree->GetRoot() : nullptr;
+    const bool useTree = root && root->totalMass > 0.0f;
+    const glm::vec2 origin = bodies[index]->GetPosition();
+    const size_t exactCount = static_cast<size_t>(std::max(0, settings.exactBodies));
+    glm::vec2 gridOrigin(0.0f);
+    float cellWidth = 0.0f;
+
+    auto cellOf = [&](const glm::vec2& position) -> int {
+        if (useTree) return FindTreeCell(root, position, depth);
+        int x = std::clamp(static_cast<int>((position.x - gridOrigin.x) / cellWidth), 0, gridSize - 1);
+        int y = std::clamp(static_cast<int>((position.y - gridOrigin.y) / cellWidth), 0, gridSize - 1);
+        return y * gridSize + x;
+    };
+    auto removeFromCell = [&](double mass, const glm::vec2& position) {
+        int cell = cellOf(position);
+        if (cell < 0) return;
+        m_cells[cell].mass -= mass;
+        m_cells[cell].massMoment -= mass * glm::dvec2(position);
+    };
+
+    // Exact bodies and the predicted body itself come out of the aggregated mass
+    if (useTree) {
+        // Everything is read from the tree's own nodes, which describe the same
+        // state as the cells and stay readable after bodies were removed
+        CollectTreeCells(root, 0, depth, softeningSq);
+        cellWidth = root->size / gridSize;
+
+        const Body* target = bodies[index].get();
+        const QuadTreeNode* leaf = root->Contains(origin) ? root : nullptr;
+        while (leaf && !leaf->isLeaf) {
+            leaf = leaf->children[leaf->GetQuadrant(origin)].get();
+        }
+        if (leaf && leaf->body == target) {
+            removeFromCell(leaf->totalMass, leaf->centerOfMass);
+        } else {
+            // Moved since the tree was built, its old mass can't be located
+            removeFromCell(target->GetMass(), origin);
+        }
+
+        LeafHeap heaviest;
+        FindHeaviestLeaves(root, origin, 1.5f * cellWidth, EXACT_MASS_FRACTION * root->totalMass, target,
+                           exactCount, heaviest);
+        for (; !heaviest.empty(); heaviest.pop()) {
+            const QuadTreeNode* node = heaviest.top().second;
+            removeFromCell(node->totalMass, node->centerOfMass);
+            m_field.push_back({glm::dvec2(node->centerOfMass), node->totalMass, softeningSq, node->maxRadius});
+        }
+    } else {
+        glm::vec2 minimum = bodies[0]->GetPosition();
+        glm::vec2 maximum = minimum;
+        for (const auto& body : bodies) {
+            minimum = glm::min(minimum, body->GetPosition());
+            maximum = glm::max(maximum, body->GetPosition());
+        }
+        gridOrigin = minimum;
+        cellWidth = std::max(std::max(maximum.x - minimum.x, maximum.y - minimum.y) / gridSize, 1e-3f);
+        double halfWidth = 0.5 * cellWidth;
+        m_cells.assign(static_cast<size_t>(gridSize) * gridSize, Cell());
+        for (auto& cell : m_cells) {
+            cell.softeningSq = halfWidth * halfWidth + softeningSq;
+        }
+
+        // Bin every body while picking the heaviest ones near the predicted body (min-heap on mass)
+        const float nearRadius = 1.5f * cellWidth;
+        std::priority_queue<std::pair<float, size_t>, std::vector<std::pair<float, size_t>>, std::greater<>> heaviest;
+        for (size_t i = 0; i < count; ++i) {
+            const Body& body = *bodies[i];
+            Cell& cell = m_cells[cellOf(body.GetPosition())];
+            cell.mass += body.GetMass();
+            cell.massMoment += static_cast<double>(body.GetMass()) * glm::dvec2(body.GetPosition());
+
+            glm::vec2 delta = body.GetPosition() - origin;
+            if (i == index || exactCount == 0 || glm::dot(delta, delta) > nearRadius * nearRadius) continue;
+            heaviest.emplace(body.GetMass(), i);
+            if (heaviest.size() > exactCount) heaviest.pop();
+        }
+        for (auto& cell : m_cells) {
+            cell.initialMass = cell.mass;
+        }
+
+        removeFromCell(bodies[index]->GetMass(), origin);
+        for (; !heaviest.empty(); heaviest.pop()) {
+            const Body& body = *bodies[heaviest.top().second];
+            removeFromCell(body.GetMass(), body.GetPosition());
+            m_field.push_back(exactSource(body));
+        }
+    }
+
+    for (const auto& cell : m_cells) {
+        // Whatever is left of a cell emptied by the subtraction is rounding error
+        if (cell.mass <= 1e-6 * cell.initialMass) continue;
+        m_field.push_back({cell.massMoment / cell.mass, cell.mass, cell.softeningSq, 0.0});
+    }
+}
+
+void OrbitPredictor::CollectTreeCells(const QuadTreeNode* node, int depth, int maxDepth, double softeningSq) {
+    if (!node || node->totalMass <= 0.0f) return;
+
+    if (node->isLeaf || depth == maxDepth) {
+        // Single bodies stay points; aggregates are softened by their extent
+        double halfSize = 0.5 * node->size;
+        Cell cell;
+        cell.mass = node->totalMass;
+        cell.initialMass = cell.mass;
+        cell.massMoment = cell.mass * glm::dvec2(node->centerOfMass);
+        cell.softeningSq = node->isLeaf ? softeningSq : halfSize * halfSize + softeningSq;
+        m_cells.push_back(cell);
+        m_cellNodes.push_back(node);
+        return;
+    }
+    for (const auto& child : node->children) {
+        CollectTreeCells(child.get(), depth + 1, maxDepth, softeningSq);
+    }
+}
+
+int OrbitPredictor::FindTreeCell(const QuadTreeNode* root, const glm::vec2& position, int maxDepth) const {
+    if (!root->Contains(position)) return -1;
+
+    const QuadTreeNode* node = root;
+    for (int depth = 0; !node->isLeaf && depth < maxDepth; ++depth) {
+        node = node->children[node->GetQuadrant(position)].get();
+        if (!node) return -1;
+    }
+    auto found = std::find(m_cellNodes.begin(), m_cellNodes.end(), node);
+    return found == m_cellNodes.end() ? -1 : static_cast<int>(found - m_cellNodes.begin());
+}
+
+void OrbitPredictor::FindHeaviestLeaves(const QuadTreeNode* node, const glm::vec2& point, float radius,
+                                        float minMass, const Body* exclude, size_t limit, LeafHeap& heaviest) const {
+    // Subtrees too light to matter on their own stay in the aggregate
+    if (!node || limit == 0 || node->totalMass < minMass || node->totalMass <= 0.0f) return;
+
+    // Nothing in a subtree lighter than the lightest kept leaf can make the cut
+    if (heaviest.size() == limit && node->totalMass <= heaviest.top().first) return;
+
+    glm::vec2 gap = glm::max(glm::abs(point - node->center) - glm::vec2(0.5f * node->size), glm::vec2(0.0f));
+    if (glm::dot(gap, gap) > radius * radius) return;
+
+    if (node->isLeaf) {
+        glm::vec2 delta = node->centerOfMass - point;
+        if (!node->body || node->body == exclude || glm::dot(delta, delta) > radius * radius) return;
+        heaviest.emplace(node->totalMass, node);
+        if (heaviest.size() > limit) heaviest.pop();
+        return;
+    }
+    for (const auto& child : node->children) {
+        FindHeaviestLeaves(child.get(), point, radius, minMass, exclude, limit, heaviest);
+    }
+}
+
+void OrbitPredictor::Run(const Job& job, uint64_t generation) {
+    auto start = std::chrono::high_resolution_clock::now();
+    Integrate(job, generation);
+    auto end = std::chrono::high_resolution_clock::now();
+    m_lastDurationMs = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void OrbitPredictor::Integrate(const Job& job, uint64_t generation) {
+    const Settings& settings = job.settings;
+    const double G = settings.G;
+    const double horizon = settings.horizon;
+    const double tolerance = settings.tolerance;
+    const size_t maxPoints = static_cast<size_t>(std::max(2, settings.maxPoints));
+    const auto& field = job.field;
+
+    auto derivative = [&](const State& y) {
+        glm::dvec2 acceleration(0.0);
+        for (const Source& source : field) {
+            glm::dvec2 r = source.position - y.x;
+            double distanceSq = glm::dot(r, r) + source.softeningSq;
+            if (distanceSq <= 0.0) continue;
+            acceleration += (G * source.mass / (distanceSq * std::sqrt(distanceSq))) * r;
+        }
+        return State{y.v, acceleration};
+    };
+    auto touches = [&](const glm::dvec2& position) {
+        for (const Source& source : field) {
+            if (source.radius <= 0.0) continue;
+            double reach = job.radius + source.radius;
+            glm::dvec2 r = source.position - position;
+            if (glm::dot(r, r) < reach * reach) return true;
+        }
+        return false;
+    };
+    auto errorNorm = [&](const State& error, const State& a, const State& b) {
+        // Relative to the state, with an absolute floor for components near zero
+        double norm = 0.0;
+        for (int i = 0; i < 2; ++i) {
+            norm = std::max(norm, std::abs(error.x[i]) / (tolerance * std::max({1.0, std::abs(a.x[i]), std::abs(b.x[i])})));
+            norm = std::max(norm, std::abs(error.v[i]) / (tolerance * std::max({1.0, std::abs(a.v[i]), std::abs(b.v[i])})));
+        }
+        return norm;
+    };
+
+    std::vector<glm::vec2> path;
+    path.reserve(std::min<size_t>(maxPoints, 1024));
+    State y{job.position, job.velocity};
+    path.push_back(glm::vec2(y.x));
+    if (horizon <= 0.0) {
+        Publish(path, generation);
+        return;
+    }
+
+    // Long steps are accurate but draw as visible corners, so cap them
+    const double maxStep = horizon / 512.0;
+    double h = maxStep * 0.25;
+    double t = 0.0;
+    size_t lastPublished = 0;
+    State k1 = derivative(y);
+
+    for (int step = 0; step < MAX_STEPS && t < horizon; ++step) {
+        if (!m_worker.IsCurrent(generation)) return; // Superseded
+
+        h = std::min(h, horizon - t);
+
+        // Dormand-Prince 5(4), first same as last
+        State k2 = derivative(y + h * (1.0 / 5.0) * k1);
+        State k3 = derivative(y + h * ((3.0 / 40.0) * k1 + (9.0 / 40.0) * k2));
+        State k4 = derivative(y + h * ((44.0 / 45.0) * k1 + (-56.0 / 15.0) * k2 + (32.0 / 9.0) * k3));
+        State k5 = derivative(y + h * ((19372.0 / 6561.0) * k1 + (-25360.0 / 2187.0) * k2 +
+                                       (64448.0 / 6561.0) * k3 + (-212.0 / 729.0) * k4));
+        State k6 = derivative(y + h * ((9017.0 / 3168.0) * k1 + (-355.0 / 33.0) * k2 + (46732.0 / 5247.0) * k3 +
+                                       (49.0 / 176.0) * k4 + (-5103.0 / 18656.0) * k5));
+        State next = y + h * ((35.0 / 384.0) * k1 + (500.0 / 1113.0) * k3 + (125.0 / 192.0) * k4 +
+                              (-2187.0 / 6784.0) * k5 + (11.0 / 84.0) * k6);
+        State k7 = derivative(next);
+        State error = h * ((71.0 / 57600.0) * k1 + (-71.0 / 16695.0) * k3 + (71.0 / 1920.0) * k4 +
+                           (-17253.0 / 339200.0) * k5 + (22.0 / 525.0) * k6 + (-1.0 / 40.0) * k7);
+        double norm = errorNorm(error, y, next);
+
+        if (norm <= 1.0) {
+            t += h;
+            y = next;
+            k1 = k7;
+            path.push_back(glm::vec2(y.x));
+            if (touches(y.x) || path.size() >= maxPoints) break;
+            if (path.size() - lastPublished >= PUBLISH_INTERVAL) {
+                if (!Publish(path, generation)) return;
+                lastPublished = path.size();
+            }
+        }
+
+        double factor = norm > 0.0 ? 0.9 * std::pow(norm, -0.2) : 5.0;
+        h = std::min(h * std::clamp(factor, 0.2, 5.0), maxStep);
+        if (h < horizon * 1e-12) break; // Passing through a point mass
+    }
+
+    Publish(path, generation);
+}
+
+bool OrbitPredictor::Publish(const std::vector<glm::vec2>& path, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_worker.IsCurrent(generation)) return false;
+    m_path = path;
+    m_pathVersion++;
+    return true;
+}
+
+} // namespace nbody
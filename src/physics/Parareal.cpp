@@ -0,0 +1,377 @@
+#include "physics/Parareal.h"
+#include "physics/FewBodyPresets.h"
+#include "physics/PhysicsEngine.h"
+#include "core/ConfigFile.h"
+#include "core/Body.h"
+#include <omp.h>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <cstdlib>
+#include <cstdint>
+
+namespace nbody {
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int64_t StepCount(double duration, double step) {
+    // Capped below 2^63 so the conversion stays defined however small the step
+    const double steps = std::min(std::ceil(duration / step - 1e-9), 9.0e18);
+    return std::max<int64_t>(1, static_cast<int64_t>(steps));
+}
+
+} // namespace
+
+bool Parareal::LoadBodies(State& state) {
+    m_masses.clear();
+    state.clear();
+
+    if (!m_config.bodies.empty()) {
+        ConfigFile file;
+        if (!file.Load(m_config.bodies)) {
+            std::cerr << "Failed to open Parareal body file: " << m_config.bodies << std::endl;
+            return false;
+        }
+        std::vector<std::unique_ptr<Body>> bodies;
+        PhysicsConfig physics;
+        try {
+            file.CreateBodies(bodies);
+            file.ApplyPhysicsConfig(physics);
+        } catch (const std::exception& e) {
+            std::cerr << "Invalid Parareal body file " << m_config.bodies << ": " << e.what() << std::endl;
+            return false;
+        }
+        m_G = physics.gravitationalConstant;
+        m_softening2 = static_cast<double>(physics.softeningLength) * physics.softeningLength;
+
+        for (const auto& body : bodies) {
+            state.insert(state.end(), {body->GetPosition().x, body->GetPosition().y,
+                                       body->GetVelocity().x, body->GetVelocity().y});
+            m_masses.push_back(body->GetMass());
+        }
+    } else {
+        std::vector<FewBodyInitial> preset;
+        if (!GetFewBodyPreset(m_config.preset, preset)) {
+            std::cerr << "Unknown Parareal preset: " << m_config.preset << std::endl;
+            return false;
+        }
+        m_G = 1.0;
+        m_softening2 = 0.0;
+        for (const auto& body : preset) {
+            state.insert(state.end(), {body.x, body.y, body.vx, body.vy});
+            m_masses.push_back(body.m);
+        }
+    }
+
+    if (m_masses.size() < 2) {
+        std::cerr << "Parareal needs at least two bodies" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Parareal::ComputeAccelerations(const State& state, std::vector<double>& acceleration) const {
+    const size_t count = m_masses.size();
+    std::fill(acceleration.begin(), acceleration.end(), 0.0);
+
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = i + 1; j < count; ++j) {
+            double dx = state[j * 4] - state[i * 4];
+            double dy = state[j * 4 + 1] - state[i * 4 + 1];
+            double r2 = dx * dx + dy * dy + m_softening2;
+            double inv = m_G / (r2 * std::sqrt(r2));
+            acceleration[i * 2] += m_masses[j] * inv * dx;
+            acceleration[i * 2 + 1] += m_masses[j] * inv * dy;
+            acceleration[j * 2] -= m_masses[i] * inv * dx;
+            acceleration[j * 2 + 1] -= m_masses[i] * inv * dy;
+        }
+    }
+}
+
+void Parareal::Coarse(const State& start, double duration, State& end) const {
+    // Kick-drift-kick leapfrog
+    const size_t count = m_masses.size();
+    const int64_t steps = StepCount(duration, m_config.coarseStep);
+    const double dt = duration / static_cast<double>(steps);
+
+    end = start;
+    std::vector<double> acceleration(count * 2);
+    ComputeAccelerations(end, acceleration);
+    for (int64_t s = 0; s < steps; ++s) {
+        for (size_t i = 0; i < count; ++i) {
+            end[i * 4 + 2] += 0.5 * dt * acceleration[i * 2];
+            end[i * 4 + 3] += 0.5 * dt * acceleration[i * 2 + 1];
+            end[i * 4] += dt * end[i * 4 + 2];
+            end[i * 4 + 1] += dt * end[i * 4 + 3];
+        }
+        ComputeAccelerations(end, acceleration);
+        for (size_t i = 0; i < count; ++i) {
+            end[i * 4 + 2] += 0.5 * dt * acceleration[i * 2];
+            end[i * 4 + 3] += 0.5 * dt * acceleration[i * 2 + 1];
+        }
+    }
+}
+
+void Parareal::Fine(const State& start, double duration, State& end) const {
+    // Fourth-order Yoshida composition of drift-kick-drift leapfrogs
+    static const double cbrt2 = std::cbrt(2.0);
+    static const double w1 = 1.0 / (2.0 - cbrt2);
+    static const double w0 = -cbrt2 / (2.0 - cbrt2);
+    static const double drift[4] = {0.5 * w1, 0.5 * (w0 + w1), 0.5 * (w0 + w1), 0.5 * w1};
+    static const double kick[3] = {w1, w0, w1};
+
+    const size_t count = m_masses.size();
+    const int64_t steps = StepCount(duration, m_config.fineStep);
+    const double dt = duration / static_cast<double>(steps);
+
+    end = start;
+    std::vector<double> acceleration(count * 2);
+    for (int64_t s = 0; s < steps; ++s) {
+        for (int stage = 0; stage < 4; ++stage) {
+            for (size_t i = 0; i < count; ++i) {
+                end[i * 4] += drift[stage] * dt * end[i * 4 + 2];
+                end[i * 4 + 1] += drift[stage] * dt * end[i * 4 + 3];
+            }
+            if (stage == 3) break;
+            ComputeAccelerations(end, acceleration);
+            for (size_t i = 0; i < count; ++i) {
+                end[i * 4 + 2] += kick[stage] * dt * acceleration[i * 2];
+                end[i * 4 + 3] += kick[stage] * dt * acceleration[i * 2 + 1];
+            }
+        }
+    }
+}
+
+double Parareal::ComputeEnergy(const State& state) const {
+    const size_t count = m_masses.size();
+    double energy = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        energy += 0.5 * m_masses[i] * (state[i * 4 + 2] * state[i * 4 + 2] + state[i * 4 + 3] * state[i * 4 + 3]);
+        for (size_t j = i + 1; j < count; ++j) {
+            double dx = state[j * 4] - state[i * 4];
+            double dy = state[j * 4 + 1] - state[i * 4 + 1];
+            energy -= m_G * m_masses[i] * m_masses[j] / std::sqrt(dx * dx + dy * dy + m_softening2);
+        }
+    }
+    return energy;
+}
+
+double Parareal::Difference(const State& a, const State& b) const {
+    double change = 0.0;
+    for (size_t i = 0; i < m_masses.size(); ++i) {
+        double dx = std::hypot(a[i * 4] - b[i * 4], a[i * 4 + 1] - b[i * 4 + 1]) / m_lengthScale;
+        double dv = std::hypot(a[i * 4 + 2] - b[i * 4 + 2], a[i * 4 + 3] - b[i * 4 + 3]) / m_speedScale;
+        change = std::max(change, std::max(dx, dv));
+    }
+    return change;
+}
+
+bool Parareal::Run() {
+    State initial;
+    if (!LoadBodies(initial)) {
+        return false;
+    }
+
+    // Changes are measured against the system's extent and RMS speed
+    const size_t count = m_masses.size();
+    double mass = 0.0, cx = 0.0, cy = 0.0, speed2 = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        mass += m_masses[i];
+        cx += m_masses[i] * initial[i * 4];
+        cy += m_masses[i] * initial[i * 4 + 1];
+        speed2 += initial[i * 4 + 2] * initial[i * 4 + 2] + initial[i * 4 + 3] * initial[i * 4 + 3];
+    }
+    m_lengthScale = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        m_lengthScale = std::max(m_lengthScale, std::hypot(initial[i * 4] - cx / mass, initial[i * 4 + 1] - cy / mass));
+    }
+    m_lengthScale = m_lengthScale > 0.0 ? m_lengthScale : 1.0;
+    m_speedScale = speed2 > 0.0 ? std::sqrt(speed2 / count) : 1.0;
+
+    const int threads = m_config.threads > 0 ? m_config.threads : omp_get_max_threads();
+    const int windows = std::max(1, m_config.windows);
+    m_slices = m_config.slices > 0 ? m_config.slices : threads;
+    const int slices = m_slices;
+    const int maxIterations = m_config.maxIterations > 0 ? std::min(m_config.maxIterations, slices) : slices;
+    const double sliceDuration = m_config.duration / (static_cast<double>(windows) * slices);
+    const double initialEnergy = ComputeEnergy(initial);
+
+    m_iterations.clear();
+    double fineTime = 0.0;
+    int fineRuns = 0;
+
+    // U holds the slice boundary states, G and F the propagators' results from them
+    std::vector<State> U(slices + 1), G(slices), F(slices);
+    State coarse;
+    U[0] = initial;
+
+    auto start = Clock::now();
+
+    for (int window = 0; window < windows; ++window) {
+        auto windowStart = Clock::now();
+
+        // Initial guess from the coarse integrator alone
+        for (int n = 0; n < slices; ++n) {
+            Coarse(U[n], sliceDuration, G[n]);
+            U[n + 1] = G[n];
+        }
+
+        // Boundary states up to `exact` no longer change
+        int exact = 0;
+        for (int iteration = 1; iteration <= maxIterations; ++iteration) {
+            double iterationFineTime = 0.0;
+
+            #pragma omp parallel for schedule(dynamic, 1) num_threads(threads) reduction(+:iterationFineTime)
+            for (int n = exact; n < slices; ++n) {
+                auto fineStart = Clock::now();
+                Fine(U[n], sliceDuration, F[n]);
+                iterationFineTime += ElapsedMs(fineStart);
+            }
+            fineTime += iterationFineTime;
+            fineRuns += slices - exact;
+
+            // Serial correction sweep
+            double change = 0.0;
+            for (int n = exact; n < slices; ++n) {
+                State next;
+                if (n == exact) {
+                    next = F[n];
+                } else {
+                    Coarse(U[n], sliceDuration, coarse);
+                    next.resize(coarse.size());
+                    for (size_t c = 0; c < next.size(); ++c) {
+                        next[c] = coarse[c] + F[n][c] - G[n][c];
+                    }
+                    G[n] = coarse;
+                }
+                change = std::max(change, Difference(next, U[n + 1]));
+                U[n + 1] = std::move(next);
+            }
+            exact++;
+
+            PararealIteration result;
+            result.window = window;
+            result.iteration = iteration;
+            result.change = change;
+            result.energyError = std::abs(initialEnergy) > 0.0
+                ? std::abs(ComputeEnergy(U[slices]) - initialEnergy) / std::abs(initialEnergy)
+                : 0.0;
+            result.wallTime = ElapsedMs(windowStart);
+            m_iterations.push_back(result);
+
+            if (change < m_config.tolerance || exact == slices) break;
+        }
+
+        U[0] = U[slices];
+    }
+
+    m_wallTime = ElapsedMs(start);
+    m_fineSliceTime = fineRuns > 0 ? fineTime / fineRuns : 0.0;
+    m_energyError = m_iterations.empty() ? 0.0 : m_iterations.back().energyError;
+
+    if (m_config.reference) {
+        // The same fine steps run one slice after another
+        auto referenceStart = Clock::now();
+        State state = initial, next;
+        for (int s = 0; s < windows * slices; ++s) {
+            Fine(state, sliceDuration, next);
+            state.swap(next);
+        }
+        m_referenceTime = ElapsedMs(referenceStart);
+        m_referenceError = Difference(state, U[0]);
+    }
+    return true;
+}
+
+bool Parareal::WriteResults(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write Parareal results: " << filename << std::endl;
+        return false;
+    }
+
+    file << "window,iteration,change,energyError,wallTime\n";
+    for (const auto& iteration : m_iterations) {
+        file << iteration.window << "," << iteration.iteration << "," << iteration.change << ","
+             << iteration.energyError << "," << iteration.wallTime << "\n";
+    }
+    return true;
+}
+
+int Parareal::RunFromCommandLine(int argc, char** argv, int firstArg) {
+    // Remaining arguments are key=value pairs
+    ConfigFile args;
+    for (int i = firstArg; i < argc; ++i) {
+        args.ParseLine(argv[i]);
+    }
+
+    PararealConfig config;
+    try {
+        config.preset = args.GetString("preset", config.preset);
+        config.bodies = args.GetString("bodies", config.bodies);
+        config.duration = args.GetFloat("duration", static_cast<float>(config.duration));
+        config.windows = args.GetInt("windows", config.windows);
+        config.slices = args.GetInt("slices", config.slices);
+        config.fineStep = args.GetFloat("fineStep", static_cast<float>(config.fineStep));
+        config.coarseStep = args.GetFloat("coarseStep", static_cast<float>(config.coarseStep));
+        config.tolerance = args.GetFloat("tolerance", static_cast<float>(config.tolerance));
+        config.maxIterations = args.GetInt("maxIterations", config.maxIterations);
+        config.reference = args.GetBool("reference", config.reference);
+        config.threads = args.GetInt("threads", config.threads);
+        config.output = args.GetString("output", config.output);
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid argument: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    // Written so NaN fails too
+    const std::pair<const char*, double> positive[] = {
+        {"duration", config.duration}, {"fineStep", config.fineStep}, {"coarseStep", config.coarseStep}};
+    for (const auto& argument : positive) {
+        if (!(argument.second > 0.0)) {
+            std::cerr << "Invalid argument: " << argument.first << " must be positive, got " << argument.second
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    Parareal parareal(config);
+    if (!parareal.Run()) {
+        return EXIT_FAILURE;
+    }
+    parareal.WriteResults(config.output);
+
+    const auto& iterations = parareal.GetIterations();
+    const int windows = iterations.empty() ? 0 : iterations.back().window + 1;
+    // Slices timed while the threads ran, so it grows when they share cores and is no serial time
+    const double fineCpuTime = parareal.GetFineSliceTime() * windows * parareal.GetSlices();
+    const double wallTime = parareal.GetWallTime();
+
+    std::cout << "Parareal (" << (config.bodies.empty() ? config.preset : config.bodies) << "): "
+              << windows << " windows x " << parareal.GetSlices() << " slices, "
+              << (windows > 0 ? static_cast<double>(iterations.size()) / windows : 0.0)
+              << " iterations per window" << std::endl;
+    std::cout << "Energy error " << parareal.GetEnergyError() << " at t=" << config.duration << std::endl;
+    std::cout << "Wall time " << wallTime << " ms, fine CPU time per pass over the run " << fineCpuTime
+              << " ms" << std::endl;
+    if (config.reference) {
+        // Timed after the parallel run, with no other thread of this run competing
+        std::cout << "Serial fine run " << parareal.GetReferenceTime() << " ms (measured speedup "
+                  << (wallTime > 0.0 ? parareal.GetReferenceTime() / wallTime : 0.0)
+                  << "), end state differs by " << parareal.GetReferenceError() << std::endl;
+    } else {
+        std::cout << "Run with reference=1 to time the serial fine run for the speedup" << std::endl;
+    }
+    std::cout << "Results written to " << config.output << std::endl;
+    return EXIT_SUCCESS;
+}
+
+} // namespace nbody
@@ -1,6 +1,11 @@
 #include "physics/PhysicsEngine.h"
 #include "physics/BarnesHut.h"
+#include "physics/KDTree.h"
 #include "physics/GPUPhysicsSolver.h"
+#include "physics/CloseEncounterSolver.h"
+#include "physics/WisdomHolman.h"
+#include "physics/NeighborList.h"
+#include "physics/EventDrivenSolver.h"
 #include "core/Body.h"
 #include <GL/glew.h>
 #include <omp.h>
@@ -21,6 +26,12 @@ static constexpr float MAX_FORCE = 10000.0f; // Maximum force to prevent instabi
 PhysicsEngine::PhysicsEngine() {
     m_bodyArrays = std::make_unique<BodyArrays>();
     m_barnesHutTree = std::make_unique<BarnesHutTree>(); // Already in nbody namespace
+    m_kdTree = std::make_unique<KDTree>();
+    m_closeEncounters = std::make_unique<CloseEncounterSolver>();
+    m_wisdomHolman = std::make_unique<WisdomHolmanIntegrator>();
+    m_neighborList = std::make_unique<ContactNeighborList>();
+    m_sweepTree = std::make_unique<BarnesHutTree>();
+    m_eventDriven = std::make_unique<EventDrivenSolver>();
     
     // Configure OpenMP for maximum parallelization
     int numThreads = omp_get_max_threads();
@@ -78,22 +89,70 @@ void PhysicsEngine::Update(std::vector<std::unique_ptr<Body>>& bodies, float del
     // Apply time scale multiplier
     float scaledDeltaTime = deltaTime * m_config.timeScale;
     
-    // Use adaptive time stepping if enabled
+    // Planetary systems with a dominant mass can skip the force pass entirely
+    bool wisdomHolman = IsWisdomHolmanActive(bodies);
+    
+    // Contact-dominated scenes resolve every collision at its exact time instead
+    bool eventDriven = m_config.useEventDriven && m_config.enableCollisions && !wisdomHolman;
+    
+    // Use adaptive time stepping if enabled (the Wisdom-Holman map subdivides on its own)
     float actualDeltaTime = scaledDeltaTime;
-    if (m_config.adaptiveTimeStep) {
+    if (m_config.adaptiveTimeStep && !wisdomHolman) {
         actualDeltaTime = CalculateAdaptiveTimeStep(bodies) * m_config.timeScale;
     }
     
-    // Calculate forces
-    CalculateForces(bodies);
+    m_stats.regularizedPairs = 0;
+    m_stats.regularizedSubsteps = 0;
+    m_contactsFromTree = false;
+    if (wisdomHolman) {
+        for (auto& body : bodies) {
+            body->ClearForce();
+        }
+        m_closeEncounters->Clear();
+    } else {
+        // Calculate forces
+        CalculateForces(bodies);
+        
+        // Split off bound close pairs before anything moves
+        if (m_config.regularizeCloseEncounters && !eventDriven) {
+            CloseEncounterSolver::Settings settings;
+            settings.G = m_config.gravitationalConstant;
+            settings.timeStep = actualDeltaTime;
+            settings.dynamicalSteps = m_config.regularizationSteps;
+            settings.substepsPerOrbit = m_config.regularizationSubsteps;
+            m_closeEncounters->FindPairs(bodies, settings,
+                [this](const Body& target, const Body& source) { return CalculatePairAcceleration(target, source); });
+        } else {
+            m_closeEncounters->Clear();
+        }
+    }
     
     // Handle collisions
-    if (m_config.enableCollisions) {
+    m_stats.sweptCollisions = 0;
+    m_stats.collisionEvents = 0;
+    m_stats.cappedBodies = 0;
+    m_stats.eventLimitHit = false;
+    if (m_config.enableCollisions && !eventDriven) {
         HandleCollisions(bodies);
+        
+        // Impacts later in the step; the Wisdom-Holman map doesn't move bodies in straight lines
+        if (m_config.continuousCollisions && !wisdomHolman) {
+            HandleSweptCollisions(bodies, actualDeltaTime);
+        }
     }
     
     // Integrate motion
-    IntegrateMotion(bodies, actualDeltaTime);
+    if (wisdomHolman) {
+        IntegrateWisdomHolman(bodies, actualDeltaTime);
+    } else if (eventDriven) {
+        IntegrateEventDriven(bodies, actualDeltaTime);
+    } else {
+        IntegrateMotion(bodies, actualDeltaTime);
+    }
+    
+    // Advance simulation clock
+    ++m_stepCount;
+    m_simulationTime += actualDeltaTime;
     
     // Update statistics
     m_stats.bodyCount = static_cast<int>(bodies.size());
@@ -109,10 +168,14 @@ void PhysicsEngine::CalculateForces(std::vector<std::unique_ptr<Body>>& bodies)
     }
     
     // Choose calculation method based on body count and settings
+    const size_t treeThreshold = static_cast<size_t>(std::max(0, m_config.maxBodiesForDirect));
     if (m_config.useGPU && m_gpuAvailable) {
         CalculateForcesGPU(bodies);
         m_stats.method = "GPU";
-    } else if (m_config.useBarnesHut && bodies.size() > m_config.maxBodiesForDirect) {
+    } else if (m_config.useBarnesHut && m_config.useKDTree && bodies.size() > treeThreshold) {
+        CalculateForcesKDTree(bodies);
+        m_stats.method = "KD-Tree";
+    } else if (m_config.useBarnesHut && bodies.size() > treeThreshold) {
         CalculateForcesBarnesHut(bodies);
         m_stats.method = "Barnes-Hut";
     } else if (bodies.size() > 100) {
@@ -208,6 +271,44 @@ void PhysicsEngine::CalculateForcesBarnesHut(std::vector<std::unique_ptr<Body>>&
     }
     #endif
     
+    // Collisions ride along with the force walk when enabled
+    if (m_config.enableCollisions && m_config.treeCollisions && !m_config.useNeighborLists && !m_config.useEventDriven) {
+        m_contactBuffers.resize(omp_get_max_threads());
+        for (auto& buffer : m_contactBuffers) {
+            buffer.clear();
+        }
+        
+        #pragma omp parallel for schedule(dynamic, 32)
+        for (int i = 0; i < static_cast<int>(bodies.size()); ++i) {
+            auto& body = bodies[i];
+            auto& contacts = m_contactBuffers[omp_get_thread_num()];
+            glm::vec2 force = m_barnesHutTree->CalculateForceAndContacts(*body, i, theta, G,
+                                                                          m_config.softeningLength, contacts);
+            // Fixed bodies still walk so their contacts are found
+            if (!body->IsFixed()) {
+                body->ApplyForce(force);
+            }
+        }
+        
+        // The walks only reach bodies in the tree; ones it dropped are checked against every lower index
+        const std::vector<int>& dropped = m_barnesHutTree->GetDroppedIndices();
+        const int droppedCount = static_cast<int>(dropped.size());
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int d = 0; d < droppedCount; ++d) {
+            auto& contacts = m_contactBuffers[omp_get_thread_num()];
+            const int j = dropped[d];
+            for (int i = 0; i < j; ++i) {
+                if (bodies[i]->IsColliding(*bodies[j])) {
+                    contacts.push_back({i, j});
+                }
+            }
+        }
+        
+        m_contactsFromTree = true;
+        m_stats.forceCalculations = m_barnesHutTree->GetStats().forceCalculations;
+        return;
+    }
+    
     // Calculate forces using Barnes-Hut approximation
     // Use parallel execution for better performance with many bodies
     #pragma omp parallel for schedule(dynamic, 32)
@@ -240,6 +341,32 @@ void PhysicsEngine::CalculateForcesBarnesHut(std::vector<std::unique_ptr<Body>>&
     #endif
 }
 
+void PhysicsEngine::CalculateForcesKDTree(std::vector<std::unique_ptr<Body>>& bodies) {
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    m_kdTree->BuildTree(bodies);
+    
+    auto buildEnd = std::chrono::high_resolution_clock::now();
+    m_stats.barnesHutTime = std::chrono::duration<double, std::milli>(buildEnd - start).count();
+    
+    const float G = m_config.gravitationalConstant;
+    const float theta = m_config.barnesHutTheta;
+    const float softening = m_config.softeningLength;
+    
+    // Contacts are left to the neighbor lists or the direct pass
+    int interactions = 0;
+    #pragma omp parallel for schedule(dynamic, 32) reduction(+:interactions)
+    for (int i = 0; i < static_cast<int>(bodies.size()); ++i) {
+        auto& body = bodies[i];
+        if (body->IsFixed()) continue;
+        
+        glm::vec2 force = m_kdTree->CalculateForce(body->GetPosition(), i, theta, G, softening, interactions);
+        body->ApplyForce(force);
+    }
+    
+    m_stats.forceCalculations = interactions;
+}
+
 void PhysicsEngine::CalculateForcesGPU(std::vector<std::unique_ptr<Body>>& bodies) {
     // Initialize GPU solver if needed
     if (!m_gpuSolver) {
@@ -290,12 +417,60 @@ void PhysicsEngine::IntegrateMotion(std::vector<std::unique_ptr<Body>>& bodies,
     auto start = std::chrono::high_resolution_clock::now();
     
     // Use leapfrog integration for better stability
+    BeginConservationSums();
     IntegrateLeapfrog(bodies, deltaTime);
     
+    // Regularized pairs are skipped by the leapfrog and advanced here
+    IntegrateCloseEncounters(bodies, deltaTime);
+    for (const auto& pair : m_closeEncounters->GetPairs()) {
+        for (int index : {pair.first, pair.second}) {
+            const Body& body = *bodies[index];
+            m_threadConservation[0].Add(body.GetMass(), body.GetPosition(), body.GetVelocity());
+        }
+    }
+    FinishConservationSums(bodies.size());
+    
     auto end = std::chrono::high_resolution_clock::now();
     m_stats.integrationTime = std::chrono::duration<double, std::milli>(end - start).count();
 }
 
+void PhysicsEngine::IntegrateEventDriven(std::vector<std::unique_ptr<Body>>& bodies, float deltaTime) {
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    // Gravity enters as half kicks around the ballistic, event-driven drift
+    const float halfStep = deltaTime * 0.5f;
+    const float damping = m_config.dampingFactor;
+    const int count = static_cast<int>(bodies.size());
+    for (auto& body : bodies) {
+        if (body->IsFixed() || body->IsBeingDragged()) continue;
+        body->SetVelocity(body->GetVelocity() * damping + body->GetForce() * halfStep);
+    }
+    
+    EventDrivenSolver::Settings settings;
+    settings.restitution = m_config.restitution;
+    m_eventDriven->Advance(bodies, settings, deltaTime);
+    
+    // The closing kick leaves every body in its final state, so it carries the conservation sums
+    BeginConservationSums();
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; ++i) {
+        Body& body = *bodies[i];
+        if (!body.IsFixed() && !body.IsBeingDragged()) {
+            body.SetVelocity(body.GetVelocity() + body.GetForce() * halfStep);
+        }
+        m_threadConservation[omp_get_thread_num()].Add(body.GetMass(), body.GetPosition(), body.GetVelocity());
+    }
+    FinishConservationSums(bodies.size());
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    m_stats.collisionTime = std::chrono::duration<double, std::milli>(end - start).count();
+    m_stats.integrationTime = m_stats.collisionTime;
+    m_stats.collisions = static_cast<int>(m_eventDriven->GetCollisionCount());
+    m_stats.collisionEvents = static_cast<int>(m_eventDriven->GetCollisionCount() + m_eventDriven->GetCellCrossingCount());
+    m_stats.cappedBodies = m_eventDriven->GetCappedBodyCount();
+    m_stats.eventLimitHit = m_eventDriven->HitEventLimit();
+}
+
 void PhysicsEngine::IntegrateEuler(std::vector<std::unique_ptr<Body>>& bodies, float deltaTime) {
     for (auto& body : bodies) {
         body->Update(deltaTime);
@@ -307,17 +482,25 @@ void PhysicsEngine::IntegrateLeapfrog(std::vector<std::unique_ptr<Body>>& bodies
     const float dtDividedBy2 = deltaTime * 0.5f;
     const float damping = m_config.dampingFactor;
     const float maxVelocity = 500.0f; // Maximum velocity to prevent instability
+    const int count = static_cast<int>(bodies.size());
     
-    for (auto& body : bodies) {
-        if (body->IsFixed() || body->IsBeingDragged()) continue;
+    // Conserved quantities are summed while each body's final state is in registers
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; ++i) {
+        auto& body = bodies[i];
+        ConservationSums& sums = m_threadConservation[omp_get_thread_num()];
+        if (m_closeEncounters->IsRegularized(i)) continue; // Summed once the pair has moved
+        if (body->IsFixed() || body->IsBeingDragged()) {
+            sums.Add(body->GetMass(), body->GetPosition(), body->GetVelocity());
+            continue;
+        }
         
         // Get current state
         glm::vec2 position = body->GetPosition();
         glm::vec2 velocity = body->GetVelocity() * damping;
-        glm::vec2 force = body->GetForce();
         
-        // Calculate acceleration from force: F = ma -> a = F/m
-        glm::vec2 acceleration = force / body->GetMass();
+        // The force pass accumulates G * m_other / r^2, i.e. the acceleration already
+        glm::vec2 acceleration = body->GetForce();
         
         // Step 1: Compute velocity at half timestep (i + 1/2)
         velocity += acceleration * dtDividedBy2;
@@ -340,6 +523,7 @@ void PhysicsEngine::IntegrateLeapfrog(std::vector<std::unique_ptr<Body>>& bodies
         // Update body state
         body->SetPosition(position);
         body->SetVelocity(velocity);
+        sums.Add(body->GetMass(), position, velocity);
     }
 }
 
@@ -371,7 +555,20 @@ void PhysicsEngine::HandleCollisions(std::vector<std::unique_ptr<Body>>& bodies)
     
     m_stats.collisions = 0;
     
-    // Simple O(N²) collision detection
+    if (m_config.useNeighborLists) {
+        ResolveNeighborContacts(bodies);
+    } else if (m_contactsFromTree) {
+        ResolveTreeContacts(bodies);
+    } else {
+        // Simple O(N²) collision detection
+        HandleCollisionsDirect(bodies);
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    m_stats.collisionTime = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void PhysicsEngine::HandleCollisionsDirect(std::vector<std::unique_ptr<Body>>& bodies) {
     for (size_t i = 0; i < bodies.size(); ++i) {
         for (size_t j = i + 1; j < bodies.size(); ++j) {
             if (CheckCollision(*bodies[i], *bodies[j])) {
@@ -380,9 +577,233 @@ void PhysicsEngine::HandleCollisions(std::vector<std::unique_ptr<Body>>& bodies)
             }
         }
     }
+}
+
+void PhysicsEngine::ResolveTreeContacts(std::vector<std::unique_ptr<Body>>& bodies) {
+    // Same pair order as the direct pass, so results don't depend on the thread count
+    std::vector<ContactPair> contacts;
+    for (auto& buffer : m_contactBuffers) {
+        contacts.insert(contacts.end(), buffer.begin(), buffer.end());
+    }
+    std::sort(contacts.begin(), contacts.end(), [](const ContactPair& a, const ContactPair& b) {
+        return a.first != b.first ? a.first < b.first : a.second < b.second;
+    });
+    
+    for (const ContactPair& contact : contacts) {
+        Body& a = *bodies[contact.first];
+        Body& b = *bodies[contact.second];
+        // Earlier resolutions may already have separated this pair
+        if (CheckCollision(a, b)) {
+            ResolveCollision(a, b);
+            m_stats.collisions++;
+        }
+    }
+}
+
+void PhysicsEngine::ResolveNeighborContacts(std::vector<std::unique_ptr<Body>>& bodies) {
+    m_neighborList->Update(bodies, m_config.neighborSkin);
+    
+    // Narrow phase over the stored candidates only
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        for (const uint32_t* j = m_neighborList->BeginNeighbors(i); j != m_neighborList->EndNeighbors(i); ++j) {
+            if (CheckCollision(*bodies[i], *bodies[*j])) {
+                ResolveCollision(*bodies[i], *bodies[*j]);
+                m_stats.collisions++;
+            }
+        }
+    }
+    
+    m_stats.neighborPairs = static_cast<int>(m_neighborList->GetPairCount());
+    m_stats.neighborListAge = m_neighborList->GetStepsSinceRebuild();
+}
+
+void PhysicsEngine::HandleSweptCollisions(std::vector<std::unique_ptr<Body>>& bodies, float deltaTime) {
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    const int count = static_cast<int>(bodies.size());
+    if (count < 2 || deltaTime <= 0.0f) return;
+    
+    // The leapfrog drifts each body in a straight line with v * damping + a * dt / 2
+    const float damping = m_config.dampingFactor;
+    std::vector<glm::vec2> drift(count, glm::vec2(0.0f));
+    std::vector<float> sweep(count, 0.0f);
+    float maxRadius = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        const Body& body = *bodies[i];
+        maxRadius = std::max(maxRadius, body.GetRadius());
+        if (body.IsFixed() || body.IsBeingDragged() || m_closeEncounters->IsRegularized(i)) continue;
+        drift[i] = body.GetVelocity() * damping + body.GetForce() * (deltaTime * 0.5f);
+        sweep[i] = glm::length(drift[i]) * deltaTime;
+    }
+    
+    struct Impact {
+        float time;
+        int first;
+        int second;
+    };
+    std::vector<std::vector<Impact>> threadImpacts(omp_get_max_threads());
+    
+    // Broad phase: |p_i - p_j| <= r_i + r_j + s_i + s_j is needed for the swept circles
+    // to meet. Only the body with the larger sweep s searches, so its own sweep bounds
+    // the query radius and each pair is tested once.
+    m_sweepTree->BuildTree(bodies);
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < count; ++i) {
+        if (sweep[i] <= 0.0f) continue;
+        auto& impacts = threadImpacts[omp_get_thread_num()];
+        const Body& body = *bodies[i];
+        const glm::vec2 position = body.GetPosition();
+        
+        m_sweepTree->ForEachBodyInRadius(position, body.GetRadius() + maxRadius + 2.0f * sweep[i],
+            [&](const Body& other, int j) {
+                if (j == i || sweep[j] > sweep[i] || (sweep[j] == sweep[i] && j < i)) return;
+                
+                // Earliest t in [0, dt] with |p + w t| = r_i + r_j
+                glm::vec2 p = other.GetPosition() - position;
+                glm::vec2 w = drift[j] - drift[i];
+                float contact = body.GetRadius() + other.GetRadius();
+                float c = glm::dot(p, p) - contact * contact;
+                float b = glm::dot(p, w);
+                if (c <= 0.0f || b >= 0.0f) return; // Already touching (discrete pass) or separating
+                float a = glm::dot(w, w);
+                float discriminant = b * b - a * c;
+                if (discriminant < 0.0f) return;
+                float t = (-b - std::sqrt(discriminant)) / a;
+                if (t >= 0.0f && t <= deltaTime) {
+                    impacts.push_back({t, std::min(i, j), std::max(i, j)});
+                }
+            });
+    }
+    
+    std::vector<Impact> impacts;
+    for (const auto& buffer : threadImpacts) {
+        impacts.insert(impacts.end(), buffer.begin(), buffer.end());
+    }
+    std::sort(impacts.begin(), impacts.end(), [](const Impact& a, const Impact& b) {
+        if (a.time != b.time) return a.time < b.time;
+        return a.first != b.first ? a.first < b.first : a.second < b.second;
+    });
+    
+    // Resolve in time order. A body takes part in at most one impact per step: its
+    // path after the first one is no longer the swept path the later ones assumed.
+    std::vector<uint8_t> hit(count, 0);
+    const float restitution = m_config.restitution;
+    for (const Impact& impact : impacts) {
+        if (hit[impact.first] || hit[impact.second]) continue;
+        Body& a = *bodies[impact.first];
+        Body& b = *bodies[impact.second];
+        
+        bool aMoves = !a.IsFixed() && !a.IsBeingDragged() && !m_closeEncounters->IsRegularized(impact.first);
+        bool bMoves = !b.IsFixed() && !b.IsBeingDragged() && !m_closeEncounters->IsRegularized(impact.second);
+        float inverseMassA = aMoves ? 1.0f / a.GetMass() : 0.0f;
+        float inverseMassB = bMoves ? 1.0f / b.GetMass() : 0.0f;
+        if (inverseMassA + inverseMassB <= 0.0f) continue;
+        
+        // Positions at the time of impact
+        glm::vec2 impactA = a.GetPosition() + drift[impact.first] * impact.time;
+        glm::vec2 impactB = b.GetPosition() + drift[impact.second] * impact.time;
+        glm::vec2 delta = impactB - impactA;
+        float distance = glm::length(delta);
+        if (distance <= 0.0f) continue;
+        glm::vec2 normal = delta / distance;
+        
+        float velocityAlongNormal = glm::dot(drift[impact.second] - drift[impact.first], normal);
+        if (velocityAlongNormal >= 0.0f) continue;
+        float impulse = -(1.0f + restitution) * velocityAlongNormal / (inverseMassA + inverseMassB);
+        
+        // Shift the start of the step back along the new drift so the leapfrog carries
+        // each body from the impact point for the remainder of the step
+        auto redirect = [&](Body& body, int index, const glm::vec2& impactPosition, float inverseMass, float sign) {
+            if (inverseMass <= 0.0f) return;
+            glm::vec2 newDrift = drift[index] + sign * impulse * inverseMass * normal;
+            body.SetPosition(impactPosition - newDrift * impact.time);
+            glm::vec2 velocity = newDrift - body.GetForce() * (deltaTime * 0.5f);
+            body.SetVelocity(damping > 0.0f ? velocity / damping : velocity);
+            drift[index] = newDrift;
+        };
+        redirect(a, impact.first, impactA, inverseMassA, -1.0f);
+        redirect(b, impact.second, impactB, inverseMassB, 1.0f);
+        
+        hit[impact.first] = 1;
+        hit[impact.second] = 1;
+        m_stats.sweptCollisions++;
+        m_stats.collisions++;
+    }
     
     auto end = std::chrono::high_resolution_clock::now();
-    m_stats.collisionTime = std::chrono::duration<double, std::milli>(end - start).count();
+    m_stats.collisionTime += std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void PhysicsEngine::IntegrateCloseEncounters(std::vector<std::unique_ptr<Body>>& bodies, float deltaTime) {
+    if (m_closeEncounters->GetPairs().empty()) return;
+    
+    CloseEncounterSolver::Settings settings;
+    settings.G = m_config.gravitationalConstant;
+    settings.timeStep = deltaTime;
+    settings.substepsPerOrbit = m_config.regularizationSubsteps;
+    m_closeEncounters->Integrate(bodies, settings, deltaTime);
+    
+    m_stats.regularizedPairs = static_cast<int>(m_closeEncounters->GetPairs().size());
+    m_stats.regularizedSubsteps = m_closeEncounters->GetSubstepCount();
+}
+
+glm::vec2 PhysicsEngine::CalculatePairAcceleration(const Body& target, const Body& source) const {
+    // Must match the mutual term the active force method added for this pair
+    const float G = m_config.gravitationalConstant;
+    const float softening = m_config.softeningLength;
+    
+    if (m_stats.method == "Block-Optimized" || m_stats.method == "Spatial-Optimized") {
+        // Plummer-softened kernel used by the cache-optimized methods
+        glm::vec2 r = source.GetPosition() - target.GetPosition();
+        float denominator = std::pow(glm::dot(r, r) + softening * softening, 1.5f);
+        return denominator > 1e-10f ? (G * source.GetMass() / denominator) * r : glm::vec2(0.0f);
+    }
+    
+    glm::vec2 acceleration = CalculateGravitationalForce(
+        target.GetPosition(), source.GetPosition(), source.GetMass(), G, softening);
+    
+    if (m_stats.method == "Direct") {
+        // Direct summation clamps each pair term
+        float magnitude = glm::length(acceleration);
+        if (magnitude > MAX_FORCE) {
+            acceleration = (acceleration / magnitude) * MAX_FORCE;
+        }
+    }
+    return acceleration;
+}
+
+bool PhysicsEngine::IsWisdomHolmanActive(const std::vector<std::unique_ptr<Body>>& bodies) const {
+    if (!m_config.useWisdomHolman || (m_config.useGPU && m_gpuAvailable)) return false;
+    
+    WisdomHolmanIntegrator::Settings settings;
+    settings.minMassRatio = m_config.wisdomHolmanMassRatio;
+    return m_wisdomHolman->IsApplicable(bodies, settings);
+}
+
+void PhysicsEngine::IntegrateWisdomHolman(std::vector<std::unique_ptr<Body>>& bodies, float deltaTime) {
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    WisdomHolmanIntegrator::Settings settings;
+    settings.G = m_config.gravitationalConstant;
+    settings.softeningLength = m_config.softeningLength;
+    settings.dampingFactor = m_config.dampingFactor;
+    settings.orbitFraction = m_config.wisdomHolmanOrbitFraction;
+    settings.minMassRatio = m_config.wisdomHolmanMassRatio;
+    m_wisdomHolman->Step(bodies, settings, deltaTime);
+    
+    // The map works in heliocentric coordinates internally, so the sums are taken afterwards.
+    // Wisdom-Holman scenes are small planetary systems, where this pass costs nothing.
+    BeginConservationSums();
+    for (const auto& body : bodies) {
+        m_threadConservation[0].Add(body->GetMass(), body->GetPosition(), body->GetVelocity());
+    }
+    FinishConservationSums(bodies.size());
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    m_stats.integrationTime = std::chrono::duration<double, std::milli>(end - start).count();
+    m_stats.forceCalculationTime = 0.0;
+    m_stats.forceCalculations = m_wisdomHolman->GetInteractionCount();
+    m_stats.method = "Wisdom-Holman";
 }
 
 bool PhysicsEngine::CheckCollision(const Body& a, const Body& b) const {
@@ -431,7 +852,7 @@ float PhysicsEngine::CalculateAdaptiveTimeStep(const std::vector<std::unique_ptr
     float maxAcceleration = 0.0f;
     
     for (const auto& body : bodies) {
-        float acceleration = glm::length(body->GetAcceleration());
+        float acceleration = glm::length(body->GetForce());
         maxAcceleration = std::max(maxAcceleration, acceleration);
     }
     
@@ -444,32 +865,111 @@ float PhysicsEngine::CalculateAdaptiveTimeStep(const std::vector<std::unique_ptr
 }
 
 EnergyStats PhysicsEngine::CalculateEnergyStats(const std::vector<std::unique_ptr<Body>>& bodies) const {
-    EnergyStats stats;
+    EnergyStats stats = CalculateConservationStats(bodies);
     
-    // Calculate kinetic energy
-    for (const auto& body : bodies) {
-        stats.kinetic += body->GetKineticEnergy();
+    std::vector<glm::vec2> positions(bodies.size());
+    std::vector<float> masses(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        positions[i] = bodies[i]->GetPosition();
+        masses[i] = bodies[i]->GetMass();
+    }
+    stats.potential = CalculatePotentialRows(positions, masses, 0, bodies.size());
+    stats.total = stats.kinetic + stats.potential;
+    
+    return stats;
+}
+
+EnergyStats PhysicsEngine::CalculateConservationStats(const std::vector<std::unique_ptr<Body>>& bodies) const {
+    // Kinetic energy and momenta from the integration pass, or summed here if that is out of date
+    if (m_conservationValid && m_conservationBodyCount == bodies.size()) {
+        EnergyStats stats = m_conservation;
+        stats.total = stats.kinetic;
+        return stats;
     }
     
-    // Calculate potential energy
+    EnergyStats stats;
+    ConservationSums sums;
+    for (const auto& body : bodies) {
+        sums.Add(body->GetMass(), body->GetPosition(), body->GetVelocity());
+    }
+    FillConservation(sums, stats);
+    stats.total = stats.kinetic;
+    return stats;
+}
+
+double PhysicsEngine::CalculatePotentialRows(const std::vector<glm::vec2>& positions, const std::vector<float>& masses,
+                                             size_t firstRow, size_t lastRow) const {
     const float G = m_config.gravitationalConstant;
-    for (size_t i = 0; i < bodies.size(); ++i) {
-        for (size_t j = i + 1; j < bodies.size(); ++j) {
-            glm::vec2 r = bodies[j]->GetPosition() - bodies[i]->GetPosition();
+    const int64_t count = static_cast<int64_t>(positions.size());
+    const int64_t first = static_cast<int64_t>(firstRow);
+    const int64_t last = std::min(static_cast<int64_t>(lastRow), count);
+    double potential = 0.0;
+    
+    // Rows get shorter towards the end, hence the dynamic schedule
+    #pragma omp parallel for reduction(+:potential) schedule(dynamic, 16) if (last - first > 64)
+    for (int64_t i = first; i < last; ++i) {
+        double row = 0.0;
+        for (int64_t j = i + 1; j < count; ++j) {
+            glm::vec2 r = positions[j] - positions[i];
             float distance = glm::length(r);
             if (distance > MIN_DISTANCE) {
-                stats.potential -= G * bodies[i]->GetMass() * bodies[j]->GetMass() / distance;
+                row -= G * masses[i] * masses[j] / distance;
             }
         }
+        potential += row;
     }
     
-    stats.total = stats.kinetic + stats.potential;
-    
-    return stats;
+    return potential;
+}
+
+void PhysicsEngine::BeginConservationSums() {
+    m_threadConservation.assign(omp_get_max_threads(), ConservationSums());
+}
+
+void PhysicsEngine::FinishConservationSums(size_t bodyCount) {
+    // Fixed reduction order, so the result only depends on the thread count
+    ConservationSums total;
+    for (const auto& sums : m_threadConservation) {
+        total.Add(sums);
+    }
+    m_conservation = EnergyStats();
+    FillConservation(total, m_conservation);
+    m_conservationBodyCount = bodyCount;
+    m_conservationValid = true;
+}
+
+void PhysicsEngine::FillConservation(const ConservationSums& sums, EnergyStats& stats) {
+    stats.mass = sums.mass.Value();
+    stats.kinetic = sums.kinetic.Value();
+    stats.momentum = glm::dvec2(sums.momentumX.Value(), sums.momentumY.Value());
+    stats.angularMomentum = sums.angularMomentum.Value();
+    stats.centerOfMass = stats.mass > 0.0
+        ? glm::dvec2(sums.massMomentX.Value(), sums.massMomentY.Value()) / stats.mass
+        : glm::dvec2(0.0);
+}
+
+const BarnesHutTree* PhysicsEngine::GetBarnesHutTree() const {
+    // Other methods leave the tree of an earlier step behind
+    return m_stats.method == "Barnes-Hut" ? m_barnesHutTree.get() : nullptr;
+}
+
+const KDTree* PhysicsEngine::GetKDTree() const {
+    return m_stats.method == "KD-Tree" ? m_kdTree.get() : nullptr;
 }
 
 void PhysicsEngine::Reset() {
     m_stats = PhysicsStats();
+    m_neighborList->Invalidate();
+    m_conservationValid = false;
+    m_stepCount = 0;
+    m_simulationTime = 0.0;
+}
+
+void PhysicsEngine::SetSimulationClock(uint64_t stepCount, double simulationTime) {
+    // Called whenever the bodies are replaced (reset, rewind, checkpoint restore)
+    m_conservationValid = false;
+    m_stepCount = stepCount;
+    m_simulationTime = simulationTime;
 }
 
 void PhysicsEngine::StartTimer() {
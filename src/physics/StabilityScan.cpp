@@ -0,0 +1,195 @@
+#include "physics/StabilityScan.h"
+#include "physics/SmallNBatch.h"
+#include "physics/FewBodyPresets.h"
+#include "core/ConfigFile.h"
+#include <omp.h>
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
+#include <array>
+
+namespace nbody {
+
+namespace {
+
+constexpr int SCAN_BODIES = 3;
+
+using ScanBatch = SmallNBatch<SCAN_BODIES, StabilityScan::SCAN_LANES, double>;
+
+} // namespace
+
+bool StabilityScan::Run() {
+    std::vector<FewBodyInitial> preset;
+    if (!GetFewBodyPreset(m_config.preset, preset) || preset.size() != SCAN_BODIES) {
+        std::cerr << "Unknown stability scan preset: " << m_config.preset << std::endl;
+        return false;
+    }
+    std::array<FewBodyInitial, SCAN_BODIES> base;
+    std::copy(preset.begin(), preset.end(), base.begin());
+
+    // Perturbations are relative to the system size and RMS speed
+    double size = 0.0;
+    double speed2 = 0.0;
+    for (const auto& body : base) {
+        size = std::max(size, std::sqrt(body.x * body.x + body.y * body.y));
+        speed2 += body.vx * body.vx + body.vy * body.vy;
+    }
+    const double speed = std::sqrt(speed2 / SCAN_BODIES);
+
+    ScanBatch::Params params;
+    params.G = 1.0;
+    params.eta = m_config.eta;
+    params.maxTimeStep = m_config.maxTimeStep;
+    params.escapeRadius = m_config.escapeFactor * size;
+    params.collisionRadius = m_config.collisionRadius;
+
+    const int samples = std::max(0, m_config.samples);
+    const int batches = (samples + SCAN_LANES - 1) / SCAN_LANES;
+    const int threads = m_config.threads > 0 ? m_config.threads : omp_get_max_threads();
+
+    m_samples.assign(samples, StabilitySample());
+    m_totalSteps = 0;
+    uint64_t totalSteps = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(threads) reduction(+:totalSteps)
+    for (int batchIndex = 0; batchIndex < batches; ++batchIndex) {
+        ScanBatch batch;
+        double initialEnergy[SCAN_LANES];
+        double finalEnergy[SCAN_LANES];
+
+        for (int lane = 0; lane < SCAN_LANES; ++lane) {
+            int sample = batchIndex * SCAN_LANES + lane;
+            if (sample >= samples) break;
+
+            // Seeded per sample so results do not depend on the thread count
+            std::mt19937 gen(m_config.seed * 2654435761u + static_cast<uint32_t>(sample));
+            std::normal_distribution<double> noise(0.0, m_config.amplitude);
+
+            std::array<FewBodyInitial, SCAN_BODIES> bodies = base;
+            double perturbation2 = 0.0;
+            for (auto& body : bodies) {
+                double dx = noise(gen) * size, dy = noise(gen) * size;
+                double dvx = noise(gen) * speed, dvy = noise(gen) * speed;
+                body.x += dx;
+                body.y += dy;
+                body.vx += dvx;
+                body.vy += dvy;
+                perturbation2 += (dx * dx + dy * dy) / (size * size) + (dvx * dvx + dvy * dvy) / (speed * speed);
+            }
+
+            // Keep the centre of mass at rest at the origin
+            double mass = 0.0, cx = 0.0, cy = 0.0, px = 0.0, py = 0.0;
+            for (const auto& body : bodies) {
+                mass += body.m;
+                cx += body.m * body.x;
+                cy += body.m * body.y;
+                px += body.m * body.vx;
+                py += body.m * body.vy;
+            }
+            for (int i = 0; i < SCAN_BODIES; ++i) {
+                const auto& body = bodies[i];
+                batch.SetBody(lane, i, body.x - cx / mass, body.y - cy / mass,
+                              body.vx - px / mass, body.vy - py / mass, body.m);
+            }
+
+            batch.StartLane(lane, m_config.duration);
+            m_samples[sample].index = sample;
+            m_samples[sample].perturbation = std::sqrt(perturbation2 / (4 * SCAN_BODIES));
+        }
+
+        batch.ComputeEnergy(params, initialEnergy);
+        batch.Run(params);
+        batch.ComputeEnergy(params, finalEnergy);
+
+        for (int lane = 0; lane < SCAN_LANES; ++lane) {
+            int sample = batchIndex * SCAN_LANES + lane;
+            if (sample >= samples) break;
+
+            StabilitySample& result = m_samples[sample];
+            result.status = batch.status[lane];
+            result.survivalTime = batch.time[lane];
+            result.minSeparation = batch.minSeparation[lane];
+            result.steps = batch.steps[lane];
+            result.energyError = std::abs(initialEnergy[lane]) > 0.0
+                ? std::abs(finalEnergy[lane] - initialEnergy[lane]) / std::abs(initialEnergy[lane])
+                : 0.0;
+            totalSteps += batch.steps[lane];
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    m_wallTime = std::chrono::duration<double, std::milli>(end - start).count();
+    m_totalSteps = totalSteps;
+    return true;
+}
+
+bool StabilityScan::WriteResults(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write stability scan results: " << filename << std::endl;
+        return false;
+    }
+
+    static const char* statusNames[] = {"running", "stable", "escaped", "close_encounter"};
+
+    file << "index,perturbation,status,survivalTime,energyError,minSeparation,steps\n";
+    for (const auto& sample : m_samples) {
+        file << sample.index << "," << sample.perturbation << "," << statusNames[sample.status] << ","
+             << sample.survivalTime << "," << sample.energyError << "," << sample.minSeparation << ","
+             << sample.steps << "\n";
+    }
+    return true;
+}
+
+int StabilityScan::RunFromCommandLine(int argc, char** argv, int firstArg) {
+    // Remaining arguments are key=value pairs
+    ConfigFile args;
+    for (int i = firstArg; i < argc; ++i) {
+        args.ParseLine(argv[i]);
+    }
+
+    StabilityScanConfig config;
+    try {
+        config.preset = args.GetString("preset", config.preset);
+        config.samples = args.GetInt("samples", config.samples);
+        config.amplitude = args.GetFloat("amplitude", static_cast<float>(config.amplitude));
+        config.duration = args.GetFloat("duration", static_cast<float>(config.duration));
+        config.eta = args.GetFloat("eta", static_cast<float>(config.eta));
+        config.maxTimeStep = args.GetFloat("maxTimeStep", static_cast<float>(config.maxTimeStep));
+        config.escapeFactor = args.GetFloat("escapeFactor", static_cast<float>(config.escapeFactor));
+        config.collisionRadius = args.GetFloat("collisionRadius", static_cast<float>(config.collisionRadius));
+        config.seed = static_cast<uint32_t>(args.GetInt("seed", static_cast<int>(config.seed)));
+        config.threads = args.GetInt("threads", config.threads);
+        config.output = args.GetString("output", config.output);
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid argument: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    StabilityScan scan(config);
+    if (!scan.Run()) {
+        return EXIT_FAILURE;
+    }
+    scan.WriteResults(config.output);
+
+    int stable = 0;
+    for (const auto& sample : scan.GetSamples()) {
+        if (sample.status == ScanBatch::Finished) stable++;
+    }
+
+    double seconds = scan.GetWallTime() / 1000.0;
+    std::cout << "Stability scan (" << config.preset << "): " << stable << " / " << scan.GetSamples().size()
+              << " variants survived t=" << config.duration << std::endl;
+    std::cout << "Wall time " << scan.GetWallTime() << " ms, "
+              << (seconds > 0.0 ? scan.GetTotalSteps() / seconds : 0.0) << " system-steps/s" << std::endl;
+    std::cout << "Results written to " << config.output << std::endl;
+    return EXIT_SUCCESS;
+}
+
+} // namespace nbody
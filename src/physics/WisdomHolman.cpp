@@ -0,0 +1,342 @@
+#include "physics/WisdomHolman.h"
+#include "core/Body.h"
+#include <algorithm>
+#include <cmath>
+
+namespace nbody {
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr int MAX_SUBSTEPS = 1000;
+constexpr int MAX_KEPLER_ITERATIONS = 50;
+
+/**
+ * @brief Stumpff functions c0..c3 via argument quartering and the double-angle relations
+ */
+void Stumpff(double x, double c[4]) {
+    int halvings = 0;
+    while (std::abs(x) > 0.1) {
+        x *= 0.25;
+        ++halvings;
+    }
+
+    c[2] = (1.0 - x / 12.0 * (1.0 - x / 30.0 * (1.0 - x / 56.0 * (1.0 - x / 90.0 *
+           (1.0 - x / 132.0 * (1.0 - x / 182.0)))))) / 2.0;
+    c[3] = (1.0 - x / 20.0 * (1.0 - x / 42.0 * (1.0 - x / 72.0 * (1.0 - x / 110.0 *
+           (1.0 - x / 156.0 * (1.0 - x / 210.0)))))) / 6.0;
+    c[1] = 1.0 - x * c[3];
+    c[0] = 1.0 - x * c[2];
+
+    for (; halvings > 0; --halvings) {
+        c[3] = (c[2] + c[0] * c[3]) * 0.25;
+        c[2] = c[1] * c[1] * 0.5;
+        c[1] = c[0] * c[1];
+        c[0] = 2.0 * c[0] * c[0] - 1.0;
+    }
+}
+
+} // namespace
+
+void WisdomHolmanIntegrator::Clear() {
+    m_cachedBodies.clear();
+    m_substeps = 0;
+    m_interactions = 0;
+}
+
+int WisdomHolmanIntegrator::FindCentralBody(const std::vector<std::unique_ptr<Body>>& bodies,
+                                            const Settings& settings) const {
+    if (bodies.size() < 2) return -1;
+
+    int central = 0;
+    double totalMass = 0.0;
+    for (int i = 0; i < static_cast<int>(bodies.size()); ++i) {
+        totalMass += bodies[i]->GetMass();
+        if (bodies[i]->GetMass() > bodies[central]->GetMass()) central = i;
+    }
+
+    double centralMass = bodies[central]->GetMass();
+    if (centralMass <= 0.0 || centralMass < settings.minMassRatio * (totalMass - centralMass)) return -1;
+
+    // Pinned or dragged planets would break the map; a pinned central body is fine
+    for (int i = 0; i < static_cast<int>(bodies.size()); ++i) {
+        if (bodies[i]->IsBeingDragged()) return -1;
+        if (i != central && bodies[i]->IsFixed()) return -1;
+    }
+    return central;
+}
+
+bool WisdomHolmanIntegrator::IsApplicable(const std::vector<std::unique_ptr<Body>>& bodies,
+                                          const Settings& settings) const {
+    return FindCentralBody(bodies, settings) >= 0;
+}
+
+void WisdomHolmanIntegrator::LoadState(const std::vector<std::unique_ptr<Body>>& bodies) {
+    // Keep the double state if nothing touched the bodies since the last step
+    bool valid = m_cachedBodies.size() == bodies.size();
+    for (size_t i = 0; valid && i < bodies.size(); ++i) {
+        const Body& body = *bodies[i];
+        valid = m_cachedBodies[i] == &body &&
+                m_writtenPositions[i] == body.GetPosition() &&
+                m_writtenVelocities[i] == body.GetVelocity() &&
+                m_masses[i] == body.GetMass();
+    }
+    if (valid) return;
+
+    const size_t count = bodies.size();
+    m_cachedBodies.resize(count);
+    m_positions.resize(count);
+    m_velocities.resize(count);
+    m_masses.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        m_cachedBodies[i] = bodies[i].get();
+        m_positions[i] = glm::dvec2(bodies[i]->GetPosition());
+        m_velocities[i] = glm::dvec2(bodies[i]->GetVelocity());
+        m_masses[i] = bodies[i]->GetMass();
+    }
+}
+
+void WisdomHolmanIntegrator::StoreState(std::vector<std::unique_ptr<Body>>& bodies) {
+    m_writtenPositions.resize(bodies.size());
+    m_writtenVelocities.resize(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        m_writtenPositions[i] = glm::vec2(m_positions[i]);
+        m_writtenVelocities[i] = glm::vec2(m_velocities[i]);
+        bodies[i]->SetPosition(m_writtenPositions[i]);
+        bodies[i]->SetVelocity(m_writtenVelocities[i]);
+    }
+}
+
+void WisdomHolmanIntegrator::Kick(const Settings& settings, double deltaTime) {
+    // Planet-planet interactions only; the central body is handled by the Kepler drift
+    const int planets = static_cast<int>(m_heliocentric.size());
+    const double G = settings.G;
+    const double softeningSq = static_cast<double>(settings.softeningLength) * settings.softeningLength;
+
+    #pragma omp parallel for schedule(dynamic) if(planets > 256)
+    for (int i = 0; i < planets; ++i) {
+        glm::dvec2 acceleration(0.0);
+        for (int j = 0; j < planets; ++j) {
+            if (i == j) continue;
+            glm::dvec2 r = m_heliocentric[j] - m_heliocentric[i];
+            double distanceSq = glm::dot(r, r) + softeningSq;
+            acceleration += r * (G * m_planetMasses[j] / (distanceSq * std::sqrt(distanceSq)));
+        }
+        m_accelerations[i] = acceleration;
+    }
+
+    for (int i = 0; i < planets; ++i) {
+        m_barycentric[i] += m_accelerations[i] * deltaTime;
+    }
+    m_interactions += planets * (planets - 1);
+}
+
+bool WisdomHolmanIntegrator::Step(std::vector<std::unique_ptr<Body>>& bodies, const Settings& settings,
+                                  float deltaTime) {
+    m_substeps = 0;
+    m_interactions = 0;
+
+    const int central = FindCentralBody(bodies, settings);
+    if (central < 0) return false;
+    if (deltaTime <= 0.0f) return true;
+
+    LoadState(bodies);
+
+    const int count = static_cast<int>(bodies.size());
+    const int planets = count - 1;
+    const double centralMass = m_masses[central];
+    const double mu = static_cast<double>(settings.G) * centralMass;
+    const bool centralFixed = bodies[central]->IsFixed();
+
+    // Barycentre moves uniformly; a pinned central body is the inertial origin instead
+    double totalMass = 0.0;
+    glm::dvec2 barycentre(0.0), barycentreVelocity(0.0);
+    for (int i = 0; i < count; ++i) {
+        totalMass += m_masses[i];
+        barycentre += m_positions[i] * m_masses[i];
+        barycentreVelocity += m_velocities[i] * m_masses[i];
+    }
+    barycentre /= totalMass;
+    barycentreVelocity /= totalMass;
+    if (centralFixed) barycentreVelocity = glm::dvec2(0.0);
+
+    m_heliocentric.resize(planets);
+    m_barycentric.resize(planets);
+    m_accelerations.resize(planets);
+    m_planetMasses.resize(planets);
+
+    double shortestPeriod = 0.0;
+    for (int i = 0, p = 0; i < count; ++i) {
+        if (i == central) continue;
+        m_heliocentric[p] = m_positions[i] - m_positions[central];
+        m_barycentric[p] = (m_velocities[i] - barycentreVelocity) * static_cast<double>(settings.dampingFactor);
+        m_planetMasses[p] = m_masses[i];
+
+        // Local dynamical time 2 pi sqrt(r^3 / mu) equals the period for circular orbits
+        double r = glm::length(m_heliocentric[p]);
+        double period = 2.0 * PI * std::sqrt(r * r * r / mu);
+        if (period > 0.0 && (shortestPeriod == 0.0 || period < shortestPeriod)) shortestPeriod = period;
+        ++p;
+    }
+
+    const double dt = deltaTime;
+    int substeps = 1;
+    if (shortestPeriod > 0.0 && settings.orbitFraction > 0.0f) {
+        double maxStep = settings.orbitFraction * shortestPeriod;
+        substeps = std::clamp(static_cast<int>(std::ceil(dt / maxStep)), 1, MAX_SUBSTEPS);
+    }
+    const double h = dt / substeps;
+
+    for (int step = 0; step < substeps; ++step) {
+        Kick(settings, 0.5 * h);
+
+        // Linear drift from the central body's recoil (absent when it is pinned)
+        glm::dvec2 jump(0.0);
+        if (!centralFixed) {
+            for (int p = 0; p < planets; ++p) jump += m_barycentric[p] * m_planetMasses[p];
+            jump *= 0.5 * h / centralMass;
+            for (int p = 0; p < planets; ++p) m_heliocentric[p] += jump;
+        }
+
+        #pragma omp parallel for schedule(dynamic, 64) if(planets > 256)
+        for (int p = 0; p < planets; ++p) {
+            if (!SolveKepler(m_heliocentric[p], m_barycentric[p], mu, h)) {
+                // Degenerate orbit (e.g. sitting on the central body): plain drift
+                m_heliocentric[p] += m_barycentric[p] * h;
+            }
+        }
+
+        if (!centralFixed) {
+            jump = glm::dvec2(0.0);
+            for (int p = 0; p < planets; ++p) jump += m_barycentric[p] * m_planetMasses[p];
+            jump *= 0.5 * h / centralMass;
+            for (int p = 0; p < planets; ++p) m_heliocentric[p] += jump;
+        }
+
+        Kick(settings, 0.5 * h);
+    }
+    m_substeps = substeps;
+
+    // Back to inertial coordinates
+    if (centralFixed) {
+        for (int i = 0, p = 0; i < count; ++i) {
+            if (i == central) continue;
+            m_positions[i] = m_positions[central] + m_heliocentric[p];
+            m_velocities[i] = m_barycentric[p];
+            ++p;
+        }
+    } else {
+        barycentre += barycentreVelocity * dt;
+
+        glm::dvec2 weightedPosition(0.0), momentum(0.0);
+        for (int p = 0; p < planets; ++p) {
+            weightedPosition += m_heliocentric[p] * m_planetMasses[p];
+            momentum += m_barycentric[p] * m_planetMasses[p];
+        }
+        m_positions[central] = barycentre - weightedPosition / totalMass;
+        m_velocities[central] = barycentreVelocity - momentum / centralMass;
+
+        for (int i = 0, p = 0; i < count; ++i) {
+            if (i == central) continue;
+            m_positions[i] = m_positions[central] + m_heliocentric[p];
+            m_velocities[i] = barycentreVelocity + m_barycentric[p];
+            ++p;
+        }
+    }
+
+    StoreState(bodies);
+    return true;
+}
+
+bool WisdomHolmanIntegrator::SolveKepler(glm::dvec2& position, glm::dvec2& velocity, double mu, double deltaTime) {
+    const double r0 = glm::length(position);
+    if (r0 <= 0.0 || mu <= 0.0) return false;
+    if (deltaTime == 0.0) return true;
+
+    const double eta0 = glm::dot(position, velocity);
+    const double beta = 2.0 * mu / r0 - glm::dot(velocity, velocity);
+    const double zeta0 = mu - beta * r0;
+
+    // Kepler's equation in universal variables: f(s) = r0 G1 + eta0 G2 + mu G3 - dt,
+    // monotone in s since f'(s) = r > 0
+    double c[4];
+    auto evaluate = [&](double sv, double& f, double& fp, double& fpp) {
+        Stumpff(beta * sv * sv, c);
+        const double G0 = c[0];
+        const double G1 = sv * c[1];
+        const double G2 = sv * sv * c[2];
+        const double G3 = sv * sv * sv * c[3];
+        f = r0 * G1 + eta0 * G2 + mu * G3 - deltaTime;
+        fp = r0 * G0 + eta0 * G1 + mu * G2;
+        fpp = eta0 * G0 + zeta0 * G1;
+    };
+
+    // Second-order series guess, then bracket the root so Laguerre-Conway can fall back to bisection
+    double s = deltaTime / r0 * (1.0 - deltaTime * eta0 / (2.0 * r0 * r0));
+    if (s * deltaTime <= 0.0) s = deltaTime / r0;
+
+    double f, fp, fpp;
+    double lo = 0.0, hi = 0.0;
+    double edge = s;
+    for (int expansion = 0; expansion < 64; ++expansion) {
+        evaluate(edge, f, fp, fpp);
+        if ((deltaTime > 0.0) ? f >= 0.0 : f <= 0.0) break;
+        edge *= 2.0;
+    }
+    if (deltaTime > 0.0) {
+        hi = edge;
+    } else {
+        lo = edge;
+    }
+
+    bool converged = false;
+    for (int iteration = 0; iteration < MAX_KEPLER_ITERATIONS; ++iteration) {
+        evaluate(s, f, fp, fpp);
+        if (f == 0.0) {
+            converged = true;
+            break;
+        }
+        if (f < 0.0) {
+            lo = s;
+        } else {
+            hi = s;
+        }
+
+        const double n = 5.0;
+        double root = std::sqrt(std::abs((n - 1.0) * (n - 1.0) * fp * fp - n * (n - 1.0) * f * fpp));
+        double denominator = fp + (fp >= 0.0 ? root : -root);
+        double next = denominator != 0.0 ? s - n * f / denominator : 0.5 * (lo + hi);
+        if (!(next > lo && next < hi)) {
+            next = 0.5 * (lo + hi);
+        }
+
+        double ds = next - s;
+        s = next;
+        if (std::abs(ds) <= 1e-14 * std::abs(s) || hi - lo <= 1e-15 * std::abs(s)) {
+            converged = true;
+            break;
+        }
+    }
+    if (!converged) return false;
+
+    // Recompute the G functions at the converged anomaly
+    Stumpff(beta * s * s, c);
+    const double G1 = s * c[1];
+    const double G2 = s * s * c[2];
+    const double G3 = s * s * s * c[3];
+    const double r = r0 * c[0] + eta0 * G1 + mu * G2;
+    if (!(r > 0.0)) return false;
+
+    // Gauss f and g functions
+    const double gaussF = 1.0 - mu * G2 / r0;
+    const double gaussG = deltaTime - mu * G3;
+    const double gaussFDot = -mu * G1 / (r0 * r);
+    const double gaussGDot = 1.0 - mu * G2 / r;
+
+    glm::dvec2 newPosition = gaussF * position + gaussG * velocity;
+    velocity = gaussFDot * position + gaussGDot * velocity;
+    position = newPosition;
+    return true;
+}
+
+} // namespace nbody
@@ -2,6 +2,7 @@
 #include "core/Body.h"
 #include "physics/PhysicsEngine.h"
 #include "physics/BarnesHut.h"
+#include "physics/KDTree.h"
 #include <iostream>
 #include <cmath>
 #include <fstream>
@@ -340,6 +341,24 @@ bool Renderer::InitializeBuffers() {
     glEnableVertexAttribArray(0);
     glBindVertexArray(0);
     
+    // Predicted path VAO and VBO (drawn with the trail shader)
+    glGenVertexArrays(1, &m_predictionVAO);
+    glGenBuffers(1, &m_predictionVBO);
+    glBindVertexArray(m_predictionVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_predictionVBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    
+    // Field contour VAO and VBO (drawn with the trail shader)
+    glGenVertexArrays(1, &m_fieldVAO);
+    glGenBuffers(1, &m_fieldVBO);
+    glBindVertexArray(m_fieldVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_fieldVBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    
     CheckGLError("Buffer initialization");
     return true;
 }
@@ -351,6 +370,11 @@ RenderStats Renderer::Render(const std::vector<std::unique_ptr<Body>>& bodies,
     
     // Update camera
     m_camera.Update(1.0f / 60.0f); // Assume 60 FPS for smooth camera
+    TrackCameraChanges();
+    if (selectedBody != m_lastSelectedBody) {
+        m_lastSelectedBody = selectedBody;
+        ++m_appearanceGeneration;
+    }
     
     // Clear screen
     glClear(GL_COLOR_BUFFER_BIT);
@@ -359,8 +383,19 @@ RenderStats Renderer::Render(const std::vector<std::unique_ptr<Body>>& bodies,
     glm::mat4 projection = m_camera.GetProjectionMatrix(static_cast<float>(m_windowWidth), static_cast<float>(m_windowHeight));
     glm::mat4 view = m_camera.GetViewMatrix();
     
-    // Render bodies
-    UpdateBodyInstances(bodies, selectedBody);
+    // Contours go underneath everything else
+    if (!m_fieldSegments.empty()) {
+        RenderFieldContours();
+    }
+    
+    // Render bodies; instances are rebuilt and uploaded only when something changed
+    if (m_instanceStamp.Refresh(m_stateGeneration, m_appearanceGeneration)) {
+        UpdateBodyInstances(bodies, selectedBody);
+        glBindBuffer(GL_ARRAY_BUFFER, m_bodyInstanceVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0,
+                        m_bodyInstances.size() * sizeof(BodyInstance),
+                        m_bodyInstances.data());
+    }
     RenderBodies();
     
     // Render visualization features
@@ -380,6 +415,10 @@ RenderStats Renderer::Render(const std::vector<std::unique_ptr<Body>>& bodies,
         RenderQuadTree(physics);
     }
     
+    if (!m_predictedPath.empty()) {
+        RenderPredictedPath();
+    }
+    
     // Update statistics
     EndTimer();
     
@@ -394,11 +433,13 @@ void Renderer::UpdateBodyInstances(const std::vector<std::unique_ptr<Body>>& bod
     m_bodyInstances.clear();
     m_bodyInstances.reserve(bodies.size());
     
-    for (const auto& body : bodies) {
+    const bool useOverride = !m_bodyColorOverride.empty() && m_bodyColorOverride.size() == bodies.size();
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        const auto& body = bodies[i];
         BodyInstance instance;
         instance.position = body->GetPosition();
         instance.radius = body->GetRadius();
-        instance.color = body->GetColor();
+        instance.color = useOverride ? m_bodyColorOverride[i] : body->GetColor();
         instance.selected = (body.get() == selectedBody) ? 1.0f : 0.0f;
         
         m_bodyInstances.push_back(instance);
@@ -418,12 +459,6 @@ void Renderer::RenderBodies() {
     m_bodyShader->SetMat4("uView", view);
     m_bodyShader->SetFloat("uZoom", m_camera.zoom);
     
-    // Update instance buffer
-    glBindBuffer(GL_ARRAY_BUFFER, m_bodyInstanceVBO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, 
-                    m_bodyInstances.size() * sizeof(BodyInstance), 
-                    m_bodyInstances.data());
-    
     // Render
     glBindVertexArray(m_bodyVAO);
     glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(m_bodyInstances.size()));
@@ -464,6 +499,12 @@ glm::vec2 Renderer::WorldToScreen(const glm::vec2& worldPos) const {
     return glm::vec2(x, y);
 }
 
+void Renderer::GetVisibleWorldBounds(glm::vec2& minimum, glm::vec2& maximum) const {
+    // Screen y points down, so the bottom-left corner is the world minimum
+    minimum = ScreenToWorld(glm::vec2(0.0f, static_cast<float>(m_windowHeight)));
+    maximum = ScreenToWorld(glm::vec2(static_cast<float>(m_windowWidth), 0.0f));
+}
+
 void Renderer::FitAllBodies(const std::vector<std::unique_ptr<Body>>& bodies) {
     if (bodies.empty()) return;
     
@@ -495,6 +536,17 @@ void Renderer::CenterOnBody(const Body* body) {
     }
 }
 
+void Renderer::TrackCameraChanges() {
+    glm::ivec2 windowSize(m_windowWidth, m_windowHeight);
+    if (m_camera.position != m_lastCameraPosition || m_camera.zoom != m_lastCameraZoom ||
+        windowSize != m_lastWindowSize) {
+        m_lastCameraPosition = m_camera.position;
+        m_lastCameraZoom = m_camera.zoom;
+        m_lastWindowSize = windowSize;
+        ++m_cameraGeneration;
+    }
+}
+
 void Renderer::StartTimer() {
     m_frameStart = std::chrono::high_resolution_clock::now();
 }
@@ -546,6 +598,10 @@ void Renderer::CleanupGL() {
     if (m_bodyVAO) glDeleteVertexArrays(1, &m_bodyVAO);
     if (m_bodyVBO) glDeleteBuffers(1, &m_bodyVBO);
     if (m_bodyInstanceVBO) glDeleteBuffers(1, &m_bodyInstanceVBO);
+    if (m_predictionVAO) glDeleteVertexArrays(1, &m_predictionVAO);
+    if (m_predictionVBO) glDeleteBuffers(1, &m_predictionVBO);
+    if (m_fieldVAO) glDeleteVertexArrays(1, &m_fieldVAO);
+    if (m_fieldVBO) glDeleteBuffers(1, &m_fieldVBO);
 }
 
 void Renderer::RenderTrails(const std::vector<std::unique_ptr<Body>>& bodies) {
@@ -553,8 +609,13 @@ void Renderer::RenderTrails(const std::vector<std::unique_ptr<Body>>& bodies) {
         return;
     }
     
-    // Update trail vertices
-    UpdateTrailVertices(bodies);
+    // Trails only grow while the simulation steps
+    if (m_trailStamp.Refresh(m_stateGeneration)) {
+        UpdateTrailVertices(bodies);
+        glBindBuffer(GL_ARRAY_BUFFER, m_trailVBO);
+        glBufferData(GL_ARRAY_BUFFER, m_trailVertices.size() * sizeof(glm::vec2),
+                     m_trailVertices.data(), GL_DYNAMIC_DRAW);
+    }
     
     if (m_trailVertices.empty()) {
         return;
@@ -570,33 +631,56 @@ void Renderer::RenderTrails(const std::vector<std::unique_ptr<Body>>& bodies) {
     m_trailShader->SetMat4("uProjection", projection);
     m_trailShader->SetMat4("uView", view);
     
-    // Bind VAO and update VBO
     glBindVertexArray(m_trailVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_trailVBO);
-    glBufferData(GL_ARRAY_BUFFER, m_trailVertices.size() * sizeof(glm::vec2), 
-                 m_trailVertices.data(), GL_DYNAMIC_DRAW);
     
     // Enable blending for trail transparency
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
     // Render trails for each body
-    size_t vertexOffset = 0;
-    for (const auto& body : bodies) {
-        const auto& trail = body->GetTrail();
-        if (trail.GetSize() < 2) {
-            continue;
-        }
-        
-        // Set trail color (dimmed body color)
-        const auto& color = body->GetColor();
-        m_trailShader->SetVec3("uColor", glm::vec3(color.r * 0.7f, color.g * 0.7f, color.b * 0.7f));
-        
-        // Draw trail as line strip
-        size_t trailVertexCount = (trail.GetSize() - 1) * 2; // Each segment = 2 vertices
-        glDrawArrays(GL_LINES, static_cast<GLint>(vertexOffset), static_cast<GLsizei>(trailVertexCount));
-        
-        vertexOffset += trailVertexCount;
+    for (const TrailBatch& batch : m_trailBatches) {
+        m_trailShader->SetVec3("uColor", batch.color);
+        glDrawArrays(GL_LINES, batch.first, batch.count);
+    }
+    
+    glDisable(GL_BLEND);
+    glBindVertexArray(0);
+    m_trailShader->Unuse();
+}
+
+void Renderer::RenderPredictedPath() {
+    if (!m_trailShader || !m_trailShader->IsValid() || m_predictedPath.size() < 2) {
+        return;
+    }
+    
+    m_trailShader->Use();
+    
+    glm::mat4 projection = m_camera.GetProjectionMatrix(static_cast<float>(m_windowWidth), static_cast<float>(m_windowHeight));
+    glm::mat4 view = m_camera.GetViewMatrix();
+    m_trailShader->SetMat4("uProjection", projection);
+    m_trailShader->SetMat4("uView", view);
+    
+    glBindVertexArray(m_predictionVAO);
+    if (m_predictedPathDirty) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_predictionVBO);
+        glBufferData(GL_ARRAY_BUFFER, m_predictedPath.size() * sizeof(glm::vec2),
+                     m_predictedPath.data(), GL_DYNAMIC_DRAW);
+        m_predictedPathDirty = false;
+    }
+    
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    
+    // The trail shader has a flat color, so fade by drawing consecutive bands
+    // of the strip progressively darker (bands share their end vertex)
+    const size_t segments = m_predictedPath.size() - 1;
+    const size_t bands = std::min<size_t>(PREDICTION_FADE_BANDS, segments);
+    for (size_t band = 0; band < bands; ++band) {
+        size_t first = segments * band / bands;
+        size_t last = segments * (band + 1) / bands;
+        float brightness = 1.0f - 0.85f * static_cast<float>(band) / static_cast<float>(bands);
+        m_trailShader->SetVec3("uColor", m_predictedPathColor * brightness);
+        glDrawArrays(GL_LINE_STRIP, static_cast<GLint>(first), static_cast<GLsizei>(last - first + 1));
     }
     
     glDisable(GL_BLEND);
@@ -604,13 +688,56 @@ void Renderer::RenderTrails(const std::vector<std::unique_ptr<Body>>& bodies) {
     m_trailShader->Unuse();
 }
 
+void Renderer::RenderFieldContours() {
+    if (!m_trailShader || !m_trailShader->IsValid() || m_fieldLevelOffsets.size() < 2) {
+        return;
+    }
+    
+    m_trailShader->Use();
+    
+    glm::mat4 projection = m_camera.GetProjectionMatrix(static_cast<float>(m_windowWidth), static_cast<float>(m_windowHeight));
+    glm::mat4 view = m_camera.GetViewMatrix();
+    m_trailShader->SetMat4("uProjection", projection);
+    m_trailShader->SetMat4("uView", view);
+    
+    glBindVertexArray(m_fieldVAO);
+    if (m_fieldContoursDirty) {
+        // Only re-upload when the sampler published new contours
+        glBindBuffer(GL_ARRAY_BUFFER, m_fieldVBO);
+        glBufferData(GL_ARRAY_BUFFER, m_fieldSegments.size() * sizeof(glm::vec2),
+                     m_fieldSegments.data(), GL_DYNAMIC_DRAW);
+        m_fieldContoursDirty = false;
+    }
+    
+    // Levels run from the shallowest potential to the deepest
+    const size_t levels = m_fieldLevelOffsets.size() - 1;
+    const glm::vec3 shallow(0.15f, 0.25f, 0.55f);
+    const glm::vec3 deep(0.75f, 0.35f, 0.1f);
+    for (size_t level = 0; level < levels; ++level) {
+        uint32_t first = m_fieldLevelOffsets[level];
+        uint32_t last = m_fieldLevelOffsets[level + 1];
+        if (last <= first) continue;
+        float t = levels > 1 ? static_cast<float>(level) / static_cast<float>(levels - 1) : 0.0f;
+        m_trailShader->SetVec3("uColor", glm::mix(shallow, deep, t));
+        glDrawArrays(GL_LINES, static_cast<GLint>(first), static_cast<GLsizei>(last - first));
+    }
+    
+    glBindVertexArray(0);
+    m_trailShader->Unuse();
+}
+
 void Renderer::RenderGrid() {
     if (!m_gridShader || !m_gridShader->IsValid()) {
         return;
     }
     
-    // Update grid vertices
-    UpdateGridVertices();
+    // The grid only depends on the view
+    if (m_gridStamp.Refresh(m_cameraGeneration)) {
+        UpdateGridVertices();
+        glBindBuffer(GL_ARRAY_BUFFER, m_gridVBO);
+        glBufferData(GL_ARRAY_BUFFER, m_gridVertices.size() * sizeof(glm::vec2),
+                     m_gridVertices.data(), GL_DYNAMIC_DRAW);
+    }
     
     if (m_gridVertices.empty()) {
         return;
@@ -626,11 +753,7 @@ void Renderer::RenderGrid() {
     m_gridShader->SetMat4("uProjection", projection);
     m_gridShader->SetMat4("uView", view);
     
-    // Bind VAO and update VBO
     glBindVertexArray(m_gridVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_gridVBO);
-    glBufferData(GL_ARRAY_BUFFER, m_gridVertices.size() * sizeof(glm::vec2), 
-                 m_gridVertices.data(), GL_DYNAMIC_DRAW);
     
     // Enable blending for grid transparency
     glEnable(GL_BLEND);
@@ -649,8 +772,13 @@ void Renderer::RenderForces(const std::vector<std::unique_ptr<Body>>& bodies, co
         return;
     }
     
-    // Update force vertices
-    UpdateForceVertices(bodies, physics);
+    // Arrow lengths are scaled with the zoom
+    if (m_forceStamp.Refresh(m_stateGeneration, m_cameraGeneration)) {
+        UpdateForceVertices(bodies, physics);
+        glBindBuffer(GL_ARRAY_BUFFER, m_forceVBO);
+        glBufferData(GL_ARRAY_BUFFER, m_forceVertices.size() * sizeof(glm::vec2),
+                     m_forceVertices.data(), GL_DYNAMIC_DRAW);
+    }
     
     if (m_forceVertices.empty()) {
         return;
@@ -666,11 +794,7 @@ void Renderer::RenderForces(const std::vector<std::unique_ptr<Body>>& bodies, co
     m_forceShader->SetMat4("uProjection", projection);
     m_forceShader->SetMat4("uView", view);
     
-    // Bind VAO and update VBO
     glBindVertexArray(m_forceVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_forceVBO);
-    glBufferData(GL_ARRAY_BUFFER, m_forceVertices.size() * sizeof(glm::vec2), 
-                 m_forceVertices.data(), GL_DYNAMIC_DRAW);
     
     // Enable blending for force transparency
     glEnable(GL_BLEND);
@@ -689,15 +813,22 @@ void Renderer::RenderQuadTree(const PhysicsEngine& physics) {
         return;
     }
     
-    // Get the Barnes-Hut tree from physics engine
+    // Whichever tree the last force pass built
     const auto* tree = physics.GetBarnesHutTree();
-    if (!tree) return;
-    
-    const auto* rootNode = tree->GetRoot();
-    if (!rootNode) return;
-    
-    // Update quadtree vertices
-    UpdateQuadTreeVertices(rootNode);
+    const auto* kdTree = physics.GetKDTree();
+    if (!tree && !kdTree) return;
+    
+    // The tree is rebuilt by the force pass of every step
+    if (m_quadTreeStamp.Refresh(m_stateGeneration)) {
+        if (tree) {
+            UpdateQuadTreeVertices(tree->GetRoot());
+        } else {
+            UpdateKDTreeVertices(kdTree->GetNodes());
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, m_quadTreeVBO);
+        glBufferData(GL_ARRAY_BUFFER, m_quadTreeVertices.size() * sizeof(glm::vec2),
+                     m_quadTreeVertices.data(), GL_DYNAMIC_DRAW);
+    }
     
     if (m_quadTreeVertices.empty()) {
         return;
@@ -713,11 +844,7 @@ void Renderer::RenderQuadTree(const PhysicsEngine& physics) {
     m_quadTreeShader->SetMat4("uProjection", projection);
     m_quadTreeShader->SetMat4("uView", view);
     
-    // Bind VAO and update VBO
     glBindVertexArray(m_quadTreeVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_quadTreeVBO);
-    glBufferData(GL_ARRAY_BUFFER, m_quadTreeVertices.size() * sizeof(glm::vec2), 
-                 m_quadTreeVertices.data(), GL_DYNAMIC_DRAW);
     
     // Enable blending for quadtree transparency
     glEnable(GL_BLEND);
@@ -734,11 +861,20 @@ void Renderer::RenderQuadTree(const PhysicsEngine& physics) {
 // Update methods for vertex generation
 void Renderer::UpdateTrailVertices(const std::vector<std::unique_ptr<Body>>& bodies) {
     m_trailVertices.clear();
+    m_trailBatches.clear();
     
     for (const auto& body : bodies) {
         const auto& trail = body->GetTrail();
         if (trail.GetSize() < 2) continue;
         
+        // Dimmed body color; each segment is 2 vertices
+        const auto& color = body->GetColor();
+        TrailBatch batch;
+        batch.first = static_cast<GLint>(m_trailVertices.size());
+        batch.count = static_cast<GLsizei>((trail.GetSize() - 1) * 2);
+        batch.color = glm::vec3(color.r * 0.7f, color.g * 0.7f, color.b * 0.7f);
+        m_trailBatches.push_back(batch);
+        
         // Use efficient iterator-based access for CircularTrail
         auto it = trail.begin();
         if (it != trail.end()) {
@@ -863,6 +999,31 @@ void Renderer::UpdateQuadTreeVertices(const QuadTreeNode* root) {
     TraverseQuadTree(root, m_quadTreeVertices);
 }
 
+void Renderer::UpdateKDTreeVertices(const std::vector<KDTreeNode>& nodes) {
+    m_quadTreeVertices.clear();
+    if (nodes.empty()) return;
+    
+    // Node 0 is the root; children are stored as pairs
+    std::vector<std::pair<int, int>> stack = {{0, 0}};  // (node, depth)
+    while (!stack.empty()) {
+        auto [index, depth] = stack.back();
+        stack.pop_back();
+        const KDTreeNode& node = nodes[index];
+        
+        const glm::vec2 corners[4] = {node.boundsMin, glm::vec2(node.boundsMax.x, node.boundsMin.y),
+                                      node.boundsMax, glm::vec2(node.boundsMin.x, node.boundsMax.y)};
+        for (int edge = 0; edge < 4; ++edge) {
+            m_quadTreeVertices.push_back(corners[edge]);
+            m_quadTreeVertices.push_back(corners[(edge + 1) % 4]);
+        }
+        
+        if (!node.IsLeaf() && depth < MAX_KD_TREE_DRAW_DEPTH) {
+            stack.push_back({node.children, depth + 1});
+            stack.push_back({node.children + 1, depth + 1});
+        }
+    }
+}
+
 void Renderer::TraverseQuadTree(const QuadTreeNode* node, std::vector<glm::vec2>& vertices) {
     if (!node) return;
     
@@ -0,0 +1,165 @@
+#include "ui/MetricHistory.h"
+#include <algorithm>
+#include <limits>
+
+namespace nbody {
+
+void MetricHistory::Bucket::Merge(const Bucket& other) {
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    start = std::min(start, other.start);
+    end = std::max(end, other.end);
+    sum += other.sum;
+    minimum = std::min(minimum, other.minimum);
+    maximum = std::max(maximum, other.maximum);
+    count += other.count;
+}
+
+MetricHistory::MetricHistory(size_t bucketsPerLevel, int levels)
+    : m_levels(std::max(1, levels)), m_capacity(std::max<size_t>(bucketsPerLevel, 2)) {
+    for (auto& level : m_levels) {
+        level.buckets.resize(m_capacity);
+    }
+}
+
+void MetricHistory::Add(double time, float value) {
+    if (m_count == 0) m_startTime = time;
+    m_endTime = time;
+    m_latest = value;
+    m_count++;
+
+    Bucket sample;
+    sample.start = time;
+    sample.end = time;
+    sample.sum = value;
+    sample.minimum = value;
+    sample.maximum = value;
+    sample.count = 1;
+    Push(0, sample);
+}
+
+void MetricHistory::Clear() {
+    for (auto& level : m_levels) {
+        level.next = 0;
+        level.size = 0;
+        level.pending = Bucket();
+        level.pendingInputs = 0;
+    }
+    m_lastLevelFanIn = 1;
+    m_count = 0;
+    m_startTime = 0.0;
+    m_endTime = 0.0;
+    m_latest = 0.0f;
+}
+
+void MetricHistory::Push(size_t levelIndex, const Bucket& bucket) {
+    Level& level = m_levels[levelIndex];
+
+    if (levelIndex + 1 == m_levels.size()) {
+        // Last level: collect inputs until a bucket is complete, never overwrite
+        level.pending.Merge(bucket);
+        if (++level.pendingInputs < m_lastLevelFanIn) return;
+        level.buckets[level.size++] = level.pending;
+        level.pending = Bucket();
+        level.pendingInputs = 0;
+        if (level.size == m_capacity) {
+            CompactLastLevel();
+        }
+        return;
+    }
+
+    level.buckets[level.next] = bucket;
+    level.next = (level.next + 1) % m_capacity;
+    level.size = std::min(level.size + 1, m_capacity);
+
+    level.pending.Merge(bucket);
+    if (++level.pendingInputs == FAN_IN) {
+        Bucket merged = level.pending;
+        level.pending = Bucket();
+        level.pendingInputs = 0;
+        Push(levelIndex + 1, merged);
+    }
+}
+
+void MetricHistory::CompactLastLevel() {
+    Level& level = m_levels.back();
+    size_t merged = 0;
+    for (size_t i = 0; i < level.size; i += 2) {
+        Bucket bucket = level.buckets[i];
+        if (i + 1 < level.size) bucket.Merge(level.buckets[i + 1]);
+        level.buckets[merged++] = bucket;
+    }
+    level.size = merged;
+    m_lastLevelFanIn *= 2;
+}
+
+template <typename Function>
+void MetricHistory::ForEachBucket(const Level& level, Function&& function) const {
+    for (size_t i = 0; i < level.size; ++i) {
+        function(level.buckets[i]);
+    }
+    // The partial last-level bucket may hold inputs the level below has already dropped
+    if (&level == &m_levels.back() && level.pending.count > 0) {
+        function(level.pending);
+    }
+}
+
+void MetricHistory::Resample(double start, double end, std::vector<Column>& columns) const {
+    const size_t columnCount = columns.size();
+    std::fill(columns.begin(), columns.end(), Column());
+    if (columnCount == 0 || m_count == 0 || end <= start) return;
+
+    std::vector<double> sums(columnCount, 0.0);
+    std::vector<double> weights(columnCount, 0.0);
+    const double scale = columnCount / (end - start);
+    const int lastColumn = static_cast<int>(columnCount) - 1;
+
+    // Finest level first; each coarser level only fills in what is older than
+    // everything the finer levels still hold
+    double coveredFrom = std::numeric_limits<double>::infinity();
+    for (const Level& level : m_levels) {
+        double oldest = coveredFrom;
+        ForEachBucket(level, [&](const Bucket& bucket) {
+            oldest = std::min(oldest, bucket.start);
+            if (bucket.start >= coveredFrom || bucket.end < start || bucket.start > end) return;
+
+            // A bucket straddling coveredFrom shares samples with the finer levels; only
+            // the older part counts, weighted by the share of its span that part takes up
+            double bucketEnd = bucket.end;
+            double count = bucket.count;
+            if (bucketEnd >= coveredFrom) {
+                count *= (coveredFrom - bucket.start) / (bucket.end - bucket.start);
+                bucketEnd = coveredFrom;
+            }
+
+            int first = std::clamp(static_cast<int>((bucket.start - start) * scale), 0, lastColumn);
+            int last = std::clamp(static_cast<int>((bucketEnd - start) * scale), 0, lastColumn);
+            double weight = count / (last - first + 1);
+            float mean = static_cast<float>(bucket.sum / bucket.count);
+            for (int c = first; c <= last; ++c) {
+                Column& column = columns[c];
+                if (!column.valid) {
+                    column.minimum = bucket.minimum;
+                    column.maximum = bucket.maximum;
+                    column.valid = true;
+                } else {
+                    column.minimum = std::min(column.minimum, bucket.minimum);
+                    column.maximum = std::max(column.maximum, bucket.maximum);
+                }
+                sums[c] += mean * weight;
+                weights[c] += weight;
+            }
+        });
+        coveredFrom = oldest;
+    }
+
+    for (size_t c = 0; c < columnCount; ++c) {
+        if (columns[c].valid) {
+            columns[c].mean = static_cast<float>(sums[c] / weights[c]);
+        }
+    }
+}
+
+} // namespace nbody
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <limits>
 
 namespace nbody {
 
@@ -30,10 +31,6 @@ bool UIManager::Initialize(GLFWwindow* window) {
     ImGui_ImplGlfw_InitForOpenGL(window, false); // Don't install callbacks automatically
     ImGui_ImplOpenGL3_Init("#version 330");
     
-    // Initialize history buffers
-    m_fpsHistory.resize(m_maxHistorySize, 0.0f);
-    m_energyHistory.resize(m_maxHistorySize, 0.0f);
-    
     return true;
 }
 
@@ -90,8 +87,16 @@ void UIManager::SyncFromEngines(const PhysicsEngine& physics, const Renderer& re
     m_softeningLength = config.softeningLength;
     m_useBarnesHut = config.useBarnesHut;
     m_barnesHutTheta = config.barnesHutTheta;
+    m_useKDTree = config.useKDTree;
     m_enableCollisions = config.enableCollisions;
+    m_treeCollisions = config.treeCollisions;
+    m_useNeighborLists = config.useNeighborLists;
+    m_continuousCollisions = config.continuousCollisions;
+    m_useEventDriven = config.useEventDriven;
+    m_neighborSkin = config.neighborSkin;
     m_restitution = config.restitution;
+    m_regularizeCloseEncounters = config.regularizeCloseEncounters;
+    m_useWisdomHolman = config.useWisdomHolman;
     
     // Sync render parameters from renderer
     m_showTrails = renderer.GetShowTrails();
@@ -130,6 +135,16 @@ void UIManager::Render(const std::vector<std::unique_ptr<Body>>& bodies,
         RenderBodyPanel(selectedBody);
     }
     
+    // The table is only sorted while its window is open
+    if (m_showBodyTableWindow != m_bodyTableActive) {
+        m_bodyTableActive = m_showBodyTableWindow;
+        if (!m_bodyTableActive) m_bodyTableRows = BodyTableRows();
+        if (OnBodyTableChanged) OnBodyTableChanged(m_bodyTableActive, m_bodyTableQuery);
+    }
+    if (m_showBodyTableWindow) {
+        RenderBodyTablePanel(bodies, selectedBody);
+    }
+    
     if (m_showDebugWindow) {
         RenderDebugPanel();
     }
@@ -206,6 +221,7 @@ void UIManager::RenderMainMenuBar() {
             ImGui::MenuItem("Controls", nullptr, &m_showControlsWindow);
             ImGui::MenuItem("Statistics", nullptr, &m_showStatsWindow);
             ImGui::MenuItem("Body Properties", nullptr, &m_showBodyWindow);
+            ImGui::MenuItem("Body Table", nullptr, &m_showBodyTableWindow);
             ImGui::MenuItem("Debug Info", nullptr, &m_showDebugWindow);
             ImGui::MenuItem("Barnes-Hut Tree", nullptr, &m_showBarnesHutWindow);
             ImGui::EndMenu();
@@ -253,6 +269,106 @@ void UIManager::RenderControlPanel() {
         if (ImGui::Button("Clear", ImVec2(buttonWidth, 0))) {
             if (OnClear) OnClear();
         }
+        
+        // Fast forward: physics runs flat out, the view only refreshes a few times a second
+        if (ImGui::Checkbox("Fast Forward", &m_fastForward)) {
+            if (OnFastForwardChanged) OnFastForwardChanged(m_fastForward);
+        }
+        ImGui::SameLine();
+        ShowHelpMarker("Step the physics as fast as the hardware allows (key F). The view is redrawn a few times a second and not at all while the window is minimized; trails and diagnostics keep sampling by simulated time.");
+        ImGui::Text("%.2fx real time, %.0f steps/s", m_simulationRate, m_stepsPerSecond);
+        
+        // Rewind scrub bar
+        if (m_rewindFrameCount > 0) {
+            ImGui::Separator();
+            ImGui::Text("Rewind");
+            ImGui::SameLine();
+            ShowHelpMarker("Drag to restore an earlier captured state. Resuming from a restored frame discards the newer history.");
+            
+            ImGui::SetNextItemWidth(-1);
+            int frame = m_rewindFrame;
+            if (ImGui::SliderInt("##rewind", &frame, 0, m_rewindFrameCount - 1, "Frame %d")) {
+                m_rewindFrame = frame;
+                if (OnRewindToFrame) OnRewindToFrame(frame);
+            }
+            ImGui::Text("%d frames, %.1f MB", m_rewindFrameCount,
+                        m_rewindMemoryBytes / (1024.0 * 1024.0));
+        }
+        
+        // Checkpoints
+        ImGui::Separator();
+        ImGui::Text("Checkpoints");
+        ImGui::SameLine();
+        ShowHelpMarker("Checkpoints are written to disk in the background from a forked copy of the simulation.");
+        
+        float checkpointButtonWidth = (ImGui::GetContentRegionAvail().x - ImGui::GetStyle().ItemSpacing.x) / 2.0f;
+        ImGui::BeginDisabled(m_checkpointStatus.state == CheckpointStatus::Writing);
+        if (ImGui::Button("Checkpoint Now", ImVec2(checkpointButtonWidth, 0))) {
+            if (OnCheckpoint) OnCheckpoint();
+        }
+        ImGui::EndDisabled();
+        ImGui::SameLine();
+        ImGui::BeginDisabled(m_checkpointStatus.completed == 0);
+        if (ImGui::Button("Restore Latest", ImVec2(checkpointButtonWidth, 0))) {
+            if (OnRestoreCheckpoint) OnRestoreCheckpoint();
+        }
+        ImGui::EndDisabled();
+        
+        float interval = m_checkpointInterval;
+        ImGui::SetNextItemWidth(-1);
+        if (ImGui::SliderFloat("##checkpointInterval", &interval, 0.0f, 600.0f,
+                               interval > 0.0f ? "Auto every %.0f s" : "Auto off")) {
+            m_checkpointInterval = interval;
+            if (OnCheckpointIntervalChanged) OnCheckpointIntervalChanged(interval);
+        }
+        
+        // Shared memory publishing for external viewers and analysis tools
+        ImGui::Separator();
+        bool sharedChanged = ImGui::Checkbox("Publish Shared State", &m_publishSharedState);
+        ImGui::SameLine();
+        ShowHelpMarker("Publish positions and velocities to the POSIX shared memory ring /nbody_state for external readers.");
+        if (m_publishSharedState) {
+            ImGui::SetNextItemWidth(-1);
+            sharedChanged |= ImGui::SliderInt("##sharedInterval", &m_sharedStateInterval, 1, 60, "Every %d steps");
+            ImGui::Text("%llu frames published", static_cast<unsigned long long>(m_sharedFramesPublished));
+        }
+        if (sharedChanged && OnSharedStateChanged) {
+            OnSharedStateChanged(m_publishSharedState, m_sharedStateInterval);
+        }
+        
+        // In-situ analysis
+        bool analysisChanged = ImGui::Checkbox("In-situ Analysis", &m_analysisEnabled);
+        ImGui::SameLine();
+        ShowHelpMarker("Compute radial profiles, Lagrangian radii, velocity dispersion and angular momentum in the background. Results go to the analysis/ directory.");
+        if (m_analysisEnabled) {
+            ImGui::SetNextItemWidth(-1);
+            analysisChanged |= ImGui::SliderInt("##analysisInterval", &m_analysisInterval, 1, 1000, "Every %d steps");
+            ImGui::Text("%llu analyzed, %llu skipped, %.1f ms",
+                        static_cast<unsigned long long>(m_analysisCompleted),
+                        static_cast<unsigned long long>(m_analysisDropped), m_analysisLastMs);
+        }
+        if (analysisChanged && OnAnalysisChanged) {
+            OnAnalysisChanged(m_analysisEnabled, m_analysisInterval);
+        }
+        
+        // Friends-of-friends group finder
+        bool groupsChanged = ImGui::Checkbox("Find Groups", &m_groupFinderEnabled);
+        ImGui::SameLine();
+        ShowHelpMarker("Link bodies closer than the linking length into friends-of-friends groups (clusters, clumps, merged systems).");
+        if (m_groupFinderEnabled) {
+            ImGui::SetNextItemWidth(-1);
+            groupsChanged |= ImGui::SliderFloat("##linkingLength", &m_groupFinderConfig.linkingLength, 0.1f, 50.0f,
+                                                "Linking length %.1f");
+            ImGui::SetNextItemWidth(-1);
+            groupsChanged |= ImGui::SliderInt("##minMembers", &m_groupFinderConfig.minMembers, 2, 1000, "Min %d members");
+            ImGui::SetNextItemWidth(-1);
+            groupsChanged |= ImGui::SliderInt("##groupInterval", &m_groupFinderInterval, 1, 1000, "Every %d steps");
+            groupsChanged |= ImGui::Checkbox("Color by Group", &m_colorByGroup);
+            ImGui::Text("%zu groups, %d ungrouped, %.1f ms", m_groupCount, m_ungroupedCount, m_groupFinderMs);
+        }
+        if (groupsChanged && OnGroupFinderChanged) {
+            OnGroupFinderChanged(m_groupFinderEnabled, m_groupFinderConfig, m_groupFinderInterval, m_colorByGroup);
+        }
     }
     
     // Physics parameters with change detection
@@ -297,6 +413,33 @@ void UIManager::RenderControlPanel() {
                                     "Lower theta = more accurate but slower")) {
                 if (OnPhysicsParameterChanged) OnPhysicsParameterChanged();
             }
+            if (CheckboxWithReset("KD-Tree", &m_useKDTree, DEFAULT_USE_KD_TREE,
+                                 "Balanced tree with tight bounding boxes instead of the quadtree. Faster and more accurate on thin disks and streams")) {
+                if (OnPhysicsParameterChanged) OnPhysicsParameterChanged();
+            }
+            if (CheckboxWithReset("Event-Driven", &m_useEventDriven, DEFAULT_USE_EVENT_DRIVEN,
+                                 "Move bodies ballistically between exact collision times (hard spheres). Best for rings and granular scenes where contacts dominate gravity")) {
+                if (OnPhysicsParameterChanged) OnPhysicsParameterChanged();
+            }
+            ImGui::BeginDisabled(m_useEventDriven);
+            if (CheckboxWithReset("Continuous (Swept)", &m_continuousCollisions, DEFAULT_CONTINUOUS_COLLISIONS,
+                                 "Also catch impacts part-way through a step, so fast bodies can't pass through each other at large time steps")) {
+                if (OnPhysicsParameterChanged) OnPhysicsParameterChanged();
+            }
+            if (CheckboxWithReset("Neighbor Lists", &m_useNeighborLists, DEFAULT_USE_NEIGHBOR_LISTS,
+                                 "Keep contact candidates between steps and only search again once a body has moved half the skin distance")) {
+                if (OnPhysicsParameterChanged) OnPhysicsParameterChanged();
+            }
+            if (m_useNeighborLists) {
+                if (SliderFloatWithInput("Skin", &m_neighborSkin, 0.0f, 20.0f, DEFAULT_NEIGHBOR_SKIN, "%.1f",
+                                        "Extra distance kept in the lists; larger skins rebuild less often but check more pairs")) {
+                    if (OnPhysicsParameterChanged) OnPhysicsParameterChanged();
+                }
+            } else if (CheckboxWithReset("Detect in Tree Walk", &m_treeCollisions, DEFAULT_TREE_COLLISIONS,
+                                        "Find contacts while walking the Barnes-Hut tree for forces instead of testing every pair")) {
+                if (OnPhysicsParameterChanged) OnPhysicsParameterChanged();
+            }
+            ImGui::EndDisabled();
             ImGui::Unindent();
         }
         
@@ -315,6 +458,16 @@ void UIManager::RenderControlPanel() {
             ImGui::Unindent();
         }
         
+        if (CheckboxWithReset("Regularize Close Pairs", &m_regularizeCloseEncounters, DEFAULT_REGULARIZE_CLOSE_ENCOUNTERS,
+                             "Integrate tight bound pairs in regularized coordinates instead of softening and clamping")) {
+            if (OnPhysicsParameterChanged) OnPhysicsParameterChanged();
+        }
+        
+        if (CheckboxWithReset("Wisdom-Holman (Planetary)", &m_useWisdomHolman, DEFAULT_USE_WISDOM_HOLMAN,
+                             "Analytic Kepler drifts around a dominant central mass; allows much larger time steps for planetary systems")) {
+            if (OnPhysicsParameterChanged) OnPhysicsParameterChanged();
+        }
+        
         ImGui::BeginDisabled(!m_gpuAvailable);
         if (CheckboxWithReset("GPU Compute", &m_useGPU, DEFAULT_USE_GPU, 
                              "Use GPU acceleration for force calculations")) {
@@ -385,10 +538,11 @@ void UIManager::RenderControlPanel() {
             m_spawnMass = DEFAULT_SPAWN_MASS;
             m_spawnSpeed = DEFAULT_SPAWN_SPEED;
             m_spawnPattern = 0; // Random
+            m_spawnSeed = DEFAULT_SPAWN_SEED;
         }
         
         ImGui::InputInt("Number of Bodies", &m_spawnCount, 10, 100);
-        m_spawnCount = std::max(1, std::min(m_spawnCount, 100000)); // Limit to reasonable range
+        m_spawnCount = std::max(1, std::min(m_spawnCount, 1000000)); // Limit to reasonable range
         
         SliderFloatWithInput("Base Spawn Radius", &m_spawnRadius, 5.0f, 50.0f, DEFAULT_SPAWN_RADIUS, "%.1f",
                            "Base radius - will be scaled automatically for large body counts");
@@ -411,9 +565,27 @@ void UIManager::RenderControlPanel() {
         const char* spawnTypes[] = { "Random", "Circle", "Grid", "Spiral" };
         ImGui::Combo("Pattern", &m_spawnPattern, spawnTypes, 4);
         
+        ImGui::InputInt("Seed", &m_spawnSeed);
+        m_spawnSeed = std::max(0, m_spawnSeed);
+        ImGui::SameLine(); ShowHelpMarker("Spawns with the same settings and seed are identical. Advances after each spawn.");
+        
         if (ImGui::Button("Spawn Bodies", ImVec2(-1, 0))) {
             if (OnSpawnBodies) OnSpawnBodies(m_spawnCount, m_spawnPattern);
         }
+        
+        if (ImGui::Checkbox("Cache Generated Bodies", &m_usePresetCache)) {
+            if (OnPresetCacheChanged) OnPresetCacheChanged(m_usePresetCache);
+        }
+        ImGui::SameLine(); ShowHelpMarker("Generated presets and spawns are saved to assets/cache and reloaded from there.");
+        if (m_usePresetCache) {
+            ImGui::Text("Cache: %.1f MB, %d hits", m_presetCacheBytes / (1024.0 * 1024.0), m_presetCacheHits);
+            if (m_presetCacheHits > 0) {
+                ImGui::Text("Last load: %.1f ms", m_presetCacheLoadMs);
+            }
+            if (ImGui::Button("Clear Cache", ImVec2(-1, 0))) {
+                if (OnClearPresetCache) OnClearPresetCache();
+            }
+        }
     }
     
     // Rendering options
@@ -435,6 +607,35 @@ void UIManager::RenderControlPanel() {
         if (ImGui::Checkbox("Show QuadTree", &m_showQuadTree)) {
             if (OnRenderParameterChanged) OnRenderParameterChanged();
         }
+        ImGui::SameLine();
+        ShowHelpMarker("Cells of the tree the last force step built: quadtree squares, or KD-tree boxes with the KD-tree selected.");
+        
+        // Predicted path of the selected body, integrated in the background
+        bool predictionChanged = ImGui::Checkbox("Predict Orbit", &m_predictOrbit);
+        ImGui::SameLine();
+        ShowHelpMarker("Show where the selected body is heading (click a body to select it). The rest of the system is frozen into a coarse field; dragging the body updates the path live.");
+        if (m_predictOrbit) {
+            ImGui::SetNextItemWidth(-1);
+            predictionChanged |= ImGui::SliderFloat("##predictionHorizon", &m_predictionHorizon, 1.0f, 500.0f,
+                                                    "Look ahead %.0f");
+            ImGui::Text("%zu points, %zu sources, %.1f ms", m_predictionPoints, m_predictionSources, m_predictionMs);
+        }
+        if (predictionChanged && OnOrbitPredictionChanged) {
+            OnOrbitPredictionChanged(m_predictOrbit, m_predictionHorizon);
+        }
+        
+        // Contours of the gravitational potential over the view, refined in the background
+        bool fieldChanged = ImGui::Checkbox("Potential Field", &m_showPotentialField);
+        ImGui::SameLine();
+        ShowHelpMarker("Contour lines of the gravitational potential across the view, blue where it is shallow and orange in the wells. A coarse grid appears first and is refined over the next frames where the potential changes quickly.");
+        if (m_showPotentialField) {
+            ImGui::SetNextItemWidth(-1);
+            fieldChanged |= ImGui::SliderInt("##fieldContourLevels", &m_fieldContourLevels, 4, 48, "%d contours");
+            ImGui::Text("%zu samples, refinement %d, %.1f ms", m_fieldSamples, m_fieldRefinementLevel, m_fieldMs);
+        }
+        if (fieldChanged && OnFieldOverlayChanged) {
+            OnFieldOverlayChanged(m_showPotentialField, m_fieldContourLevels);
+        }
     }
     
     // Camera controls
@@ -485,6 +686,24 @@ void UIManager::RenderStatsPanel(const std::vector<std::unique_ptr<Body>>& bodie
         ImGui::Text("Collisions: %.2f ms", physicsStats.collisionTime);
         ImGui::Text("Force Calculations: %d", physicsStats.forceCalculations);
         ImGui::Text("Collisions: %d", physicsStats.collisions);
+        if (physicsStats.collisionEvents > 0) {
+            ImGui::Text("Collision Events: %d", physicsStats.collisionEvents);
+        }
+        if (physicsStats.cappedBodies > 0) {
+            ImGui::Text("Collision-Capped Bodies: %d (passing through)", physicsStats.cappedBodies);
+        }
+        if (physicsStats.eventLimitHit) {
+            ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "Event limit reached, step finished ballistically");
+        }
+        if (physicsStats.sweptCollisions > 0) {
+            ImGui::Text("Swept Impacts: %d", physicsStats.sweptCollisions);
+        }
+        if (physicsStats.neighborPairs > 0) {
+            ImGui::Text("Neighbor Pairs: %d (rebuilt %d steps ago)", physicsStats.neighborPairs, physicsStats.neighborListAge);
+        }
+        if (physicsStats.regularizedPairs > 0) {
+            ImGui::Text("Regularized Pairs: %d (%d substeps)", physicsStats.regularizedPairs, physicsStats.regularizedSubsteps);
+        }
         
         // Method information
         ImGui::Separator();
@@ -507,33 +726,200 @@ void UIManager::RenderStatsPanel(const std::vector<std::unique_ptr<Body>>& bodie
         }
     }
     
-    // Energy stats
-    auto energyStats = physics.CalculateEnergyStats(bodies);
+    // Energy from the energy job, which spreads the O(N²) potential over frames;
+    // the momenta are linear and stay live
     if (ImGui::CollapsingHeader("Energy", ImGuiTreeNodeFlags_DefaultOpen)) {
-        ImGui::Text("Kinetic: %.2e", energyStats.kinetic);
-        ImGui::Text("Potential: %.2e", energyStats.potential);
-        ImGui::Text("Total: %.2e", energyStats.total);
-        
-        // Update energy history
-        m_energyHistory[m_energyHistoryIndex] = static_cast<float>(energyStats.total);
-        m_energyHistoryIndex = (m_energyHistoryIndex + 1) % m_maxHistorySize;
-        
-        // Plot energy graph
-        ImGui::PlotLines("Energy##plot", m_energyHistory.data(), static_cast<int>(m_energyHistory.size()), 0, nullptr, FLT_MAX, FLT_MAX, ImVec2(0, 80));
+        auto conservation = physics.CalculateConservationStats(bodies);
+        if (m_hasEnergy) {
+            ImGui::Text("Kinetic: %.2e", m_kineticEnergy);
+            ImGui::Text("Potential: %.2e", m_potentialEnergy);
+            ImGui::Text("Total: %.2e", m_totalEnergy);
+            ImGui::TextDisabled("At step %llu", static_cast<unsigned long long>(m_energyStep));
+        } else {
+            ImGui::TextDisabled("Computing energy...");
+        }
+        ImGui::Text("Momentum: (%.3e, %.3e)", conservation.momentum.x, conservation.momentum.y);
+        ImGui::Text("Angular Momentum: %.3e", conservation.angularMomentum);
+        ImGui::Text("Center of Mass: (%.2f, %.2f)", conservation.centerOfMass.x, conservation.centerOfMass.y);
+        ShowEnergyGraph();
+    }
+    
+    // Latest in-situ analysis scalars
+    if (m_analysisEnabled && m_analysisCompleted > 0 && ImGui::CollapsingHeader("Analysis")) {
+        for (const auto& result : m_analysisResults) {
+            if (result.scalars.empty()) continue;
+            if (ImGui::TreeNode(result.module.c_str())) {
+                ImGui::Text("Step %llu", static_cast<unsigned long long>(result.step));
+                for (const auto& scalar : result.scalars) {
+                    ImGui::Text("%s: %.4g", scalar.first.c_str(), scalar.second);
+                }
+                ImGui::TreePop();
+            }
+        }
+    }
+    
+    // Largest friends-of-friends groups
+    if (m_groupFinderEnabled && !m_largestGroups.empty() && ImGui::CollapsingHeader("Groups")) {
+        for (size_t i = 0; i < m_largestGroups.size(); ++i) {
+            const FoFGroup& group = m_largestGroups[i];
+            glm::vec3 color = FriendsOfFriends::GetGroupColor(static_cast<int>(i));
+            ImGui::TextColored(ImVec4(color.r, color.g, color.b, 1.0f), "#%zu: %d bodies, mass %.3g at (%.1f, %.1f)",
+                               i, group.memberCount, group.mass, group.centerOfMass.x, group.centerOfMass.y);
+        }
+    }
+    
+    // Periodic jobs and the time they may take per frame
+    if (!m_jobStatus.empty() && ImGui::CollapsingHeader("Background Jobs")) {
+        ImGui::SetNextItemWidth(-1);
+        if (ImGui::SliderFloat("##jobBudget", &m_jobBudgetMs, 0.5f, 10.0f, "%.1f ms per frame") &&
+            OnJobBudgetChanged) {
+            OnJobBudgetChanged(m_jobBudgetMs);
+        }
+        for (const JobStatus& job : m_jobStatus) {
+            ImGui::ProgressBar(job.progress, ImVec2(-1.0f, 0.0f), job.name.c_str());
+            if (job.completed > 0) {
+                ImGui::TextDisabled("Last run: %d frames, %.1f ms", job.lastFrames, job.lastWorkMs);
+            }
+        }
+    }
+    
+    // Checkpoint stats
+    if (m_checkpointStatus.state != CheckpointStatus::Idle && ImGui::CollapsingHeader("Checkpoints")) {
+        switch (m_checkpointStatus.state) {
+            case CheckpointStatus::Writing:
+                ImGui::Text("Writing step %llu...", static_cast<unsigned long long>(m_checkpointStatus.step));
+                break;
+            case CheckpointStatus::Succeeded:
+                ImGui::Text("Saved step %llu", static_cast<unsigned long long>(m_checkpointStatus.step));
+                break;
+            case CheckpointStatus::Failed:
+                ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Failed at step %llu",
+                                   static_cast<unsigned long long>(m_checkpointStatus.step));
+                break;
+            default:
+                break;
+        }
+        ImGui::Text("Pause: %.2f ms", m_checkpointStatus.pauseMs);
+        if (m_checkpointStatus.state != CheckpointStatus::Writing) {
+            ImGui::Text("Duration: %.1f ms", m_checkpointStatus.durationMs);
+        }
+        ImGui::Text("Completed: %d, Failed: %d", m_checkpointStatus.completed, m_checkpointStatus.failed);
+        ImGui::TextWrapped("%s", m_checkpointStatus.filename.c_str());
     }
     
     // Performance stats
     const auto& renderStats = renderer.GetStats();
+    m_fpsHistory.Add(ImGui::GetTime(), renderStats.fps);
     if (ImGui::CollapsingHeader("Rendering", ImGuiTreeNodeFlags_DefaultOpen)) {
         ImGui::Text("FPS: %.1f", renderStats.fps);
         ImGui::Text("Render Time: %.2f ms", renderStats.renderTime);
         ImGui::Text("Bodies Rendered: %d", renderStats.bodiesRendered);
         ImGui::Text("Draw Calls: %d", renderStats.drawCalls);
+        ShowPerformanceGraph();
     }
     
     ImGui::End();
 }
 
+void UIManager::ShowHistorySpanSelector(const char* id, bool simulatedTime) {
+    static const char* const wallNames[HISTORY_SPAN_COUNT] = {"Last minute", "Last 10 minutes", "Last hour", "Whole session"};
+    static const char* const simulatedNames[HISTORY_SPAN_COUNT] = {"Last 60 time units", "Last 600 time units",
+                                                                   "Last 3600 time units", "Whole run"};
+    ImGui::SetNextItemWidth(-1);
+    ImGui::Combo(id, &m_historySpan, simulatedTime ? simulatedNames : wallNames, HISTORY_SPAN_COUNT);
+}
+
+void UIManager::ShowPerformanceGraph() {
+    ShowHistorySpanSelector("##fpsSpan", false);
+    PlotHistory("##fpsHistory", m_fpsHistory, 60.0f, "%.0f FPS");
+}
+
+void UIManager::SetEnergyStats(const EnergyStats& stats, uint64_t step, double simulationTime) {
+    m_kineticEnergy = stats.kinetic;
+    m_potentialEnergy = stats.potential;
+    m_totalEnergy = stats.total;
+    m_energyStep = step;
+    m_hasEnergy = true;
+    if (stats.mass > 0.0) {
+        // Rewinding goes back in simulated time and starts a new branch of the history
+        if (!m_energyHistory.IsEmpty() && simulationTime < m_energyHistory.GetEndTime()) {
+            m_energyHistory.Clear();
+        }
+        m_energyHistory.Add(simulationTime, static_cast<float>(stats.total));
+    }
+}
+
+void UIManager::ShowEnergyGraph() {
+    ShowHistorySpanSelector("##energySpan", true);
+    PlotHistory("##energyHistory", m_energyHistory, 80.0f, "%.4e");
+}
+
+void UIManager::PlotHistory(const char* id, const MetricHistory& history, float height, const char* format) {
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    float width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+    ImGui::InvisibleButton(id, ImVec2(width, height));
+    
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    drawList->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + height),
+                            ImGui::GetColorU32(ImGui::GetStyle().Colors[ImGuiCol_FrameBg]));
+    if (history.IsEmpty()) return;
+    
+    // One column per pixel, each holding the min, max and mean of its samples
+    double end = history.GetEndTime();
+    double span = HISTORY_SPANS[m_historySpan];
+    double start = span > 0.0 ? end - span : history.GetStartTime();
+    m_plotColumns.resize(static_cast<size_t>(width));
+    history.Resample(start, end, m_plotColumns);
+    
+    float low = std::numeric_limits<float>::max();
+    float high = std::numeric_limits<float>::lowest();
+    for (const auto& column : m_plotColumns) {
+        if (!column.valid) continue;
+        low = std::min(low, column.minimum);
+        high = std::max(high, column.maximum);
+    }
+    if (low > high) return;
+    if (high - low < 1e-12f * std::max(std::abs(low), 1.0f)) {
+        low -= 0.5f;
+        high += 0.5f;
+    }
+    auto toY = [&](float value) { return origin.y + height - 1.0f - (value - low) / (high - low) * (height - 2.0f); };
+    
+    // Min-max band first, then the mean on top; gaps stay open
+    const ImU32 bandColor = IM_COL32(110, 150, 230, 110);
+    const ImU32 meanColor = IM_COL32(160, 200, 255, 255);
+    ImVec2 previous;
+    bool hasPrevious = false;
+    for (size_t c = 0; c < m_plotColumns.size(); ++c) {
+        const auto& column = m_plotColumns[c];
+        if (!column.valid) {
+            hasPrevious = false;
+            continue;
+        }
+        float x = origin.x + static_cast<float>(c) + 0.5f;
+        drawList->AddLine(ImVec2(x, toY(column.maximum)), ImVec2(x, toY(column.minimum) + 1.0f), bandColor);
+        ImVec2 point(x, toY(column.mean));
+        if (hasPrevious) {
+            drawList->AddLine(previous, point, meanColor);
+        }
+        previous = point;
+        hasPrevious = true;
+    }
+    
+    char label[64];
+    std::snprintf(label, sizeof(label), format, history.GetLatest());
+    drawList->AddText(ImVec2(origin.x + 4.0f, origin.y + 2.0f), IM_COL32(255, 255, 255, 200), label);
+    
+    if (ImGui::IsItemHovered()) {
+        size_t c = std::min(static_cast<size_t>(std::max(ImGui::GetMousePos().x - origin.x, 0.0f)), m_plotColumns.size() - 1);
+        const auto& column = m_plotColumns[c];
+        double age = (end - start) * (1.0 - (c + 0.5) / m_plotColumns.size());
+        if (column.valid) {
+            ImGui::SetTooltip("%.0f s ago\nmin %.6g\nmean %.6g\nmax %.6g", age, column.minimum, column.mean, column.maximum);
+        }
+    }
+}
+
 void UIManager::RenderBodyPanel(const Body* selectedBody) {
     // Position panel on the bottom right
     float panelWidth = std::min(300.0f, m_windowWidth * 0.25f);
@@ -604,6 +990,98 @@ void UIManager::RenderBodyPanel(const Body* selectedBody) {
     ImGui::End();
 }
 
+void UIManager::RenderBodyTablePanel(const std::vector<std::unique_ptr<Body>>& bodies, const Body* selectedBody) {
+    ImGui::SetNextWindowSize(ImVec2(420.0f, m_windowHeight * 0.4f), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Body Table", &m_showBodyTableWindow)) {
+        ImGui::End();
+        return;
+    }
+    
+    // Filters apply to the column the table is sorted by
+    bool queryChanged = ImGui::Checkbox("In view only", &m_bodyTableQuery.inRegion);
+    ImGui::SameLine();
+    ShowHelpMarker("Sorting and filtering run in the background, so the table lags the simulation by a moment. Min and Max limit the sorted column; a Max of 0 means no limit. Click a row to select the body and center the camera on it.");
+    ImGui::SetNextItemWidth(120.0f);
+    queryChanged |= ImGui::InputFloat("Min", &m_bodyTableQuery.minValue, 0.0f, 0.0f, "%.4g");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    queryChanged |= ImGui::InputFloat("Max", &m_bodyTableMax, 0.0f, 0.0f, "%.4g");
+    
+    ImGui::Text("%zu of %zu bodies match, sorted at step %llu in %.1f ms", m_bodyTableRows.matched,
+                m_bodyTableRows.total, static_cast<unsigned long long>(m_bodyTableRows.step),
+                m_bodyTableRows.elapsedMs);
+    if (m_bodyTableRows.matched > m_bodyTableRows.indices.size()) {
+        ImGui::TextDisabled("Showing the first %zu", m_bodyTableRows.indices.size());
+    }
+    
+    ImGuiTableFlags flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg |
+                            ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable;
+    if (ImGui::BeginTable("##bodyTable", 5, flags)) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("#", ImGuiTableColumnFlags_WidthFixed, 0.0f, static_cast<ImGuiID>(BodyTableKey::Index));
+        ImGui::TableSetupColumn("Mass", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending,
+                                0.0f, static_cast<ImGuiID>(BodyTableKey::Mass));
+        ImGui::TableSetupColumn("Speed", ImGuiTableColumnFlags_PreferSortDescending, 0.0f,
+                                static_cast<ImGuiID>(BodyTableKey::Speed));
+        ImGui::TableSetupColumn("Kinetic E", ImGuiTableColumnFlags_PreferSortDescending, 0.0f,
+                                static_cast<ImGuiID>(BodyTableKey::KineticEnergy));
+        ImGui::TableSetupColumn("Position", ImGuiTableColumnFlags_NoSort);
+        ImGui::TableHeadersRow();
+        
+        ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs();
+        if (sortSpecs && sortSpecs->SpecsDirty && sortSpecs->SpecsCount > 0) {
+            m_bodyTableQuery.key = static_cast<BodyTableKey>(sortSpecs->Specs[0].ColumnUserID);
+            m_bodyTableQuery.descending = sortSpecs->Specs[0].SortDirection == ImGuiSortDirection_Descending;
+            sortSpecs->SpecsDirty = false;
+            queryChanged = true;
+        }
+        
+        // Bodies removed since the last sort are dropped here, since the clipper expects every row it lays out
+        std::vector<uint32_t>& rows = m_bodyTableRows.indices;
+        if (bodies.size() < m_bodyTableCheckedCount) {
+            const size_t count = bodies.size();
+            rows.erase(std::remove_if(rows.begin(), rows.end(), [count](uint32_t index) { return index >= count; }),
+                       rows.end());
+            m_bodyTableCheckedCount = count;
+        }
+        
+        // Only the rows on screen read their bodies; values are live, the order is as of the last sort
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(rows.size()));
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                const uint32_t index = rows[row];
+                const Body& body = *bodies[index];
+                
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                char label[32];
+                std::snprintf(label, sizeof(label), "%u", index);
+                if (ImGui::Selectable(label, &body == selectedBody, ImGuiSelectableFlags_SpanAllColumns)) {
+                    if (OnSelectBody) OnSelectBody(index);
+                }
+                ImGui::TableNextColumn();
+                ImGui::Text("%.4g", body.GetMass());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.4g", body.GetSpeed());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.4g", body.GetKineticEnergy());
+                ImGui::TableNextColumn();
+                ImGui::Text("(%.1f, %.1f)", body.GetPosition().x, body.GetPosition().y);
+            }
+        }
+        clipper.End();
+        ImGui::EndTable();
+    }
+    
+    if (queryChanged) {
+        m_bodyTableQuery.maxValue = m_bodyTableMax > 0.0f ? m_bodyTableMax : std::numeric_limits<float>::infinity();
+        if (OnBodyTableChanged) OnBodyTableChanged(true, m_bodyTableQuery);
+    }
+    
+    ImGui::End();
+}
+
 void UIManager::RenderDebugPanel() {
     ImGui::Begin("Debug Info", &m_showDebugWindow);
     
@@ -635,6 +1113,7 @@ void UIManager::RenderAboutPanel() {
     ImGui::BulletText("Space: Play/Pause");
     ImGui::BulletText("R: Reset");
     ImGui::BulletText("C: Clear all");
+    ImGui::BulletText("F5: Write checkpoint");
     
     ImGui::End();
 }
@@ -720,8 +1199,9 @@ void UIManager::RenderBarnesHutPanel(const std::vector<std::unique_ptr<Body>>& b
         return;
     }
     
-    // Check if we're using Barnes-Hut
-    if (physics.GetStats().method != "Barnes-Hut") {
+    // Check if we're using Barnes-Hut, with either tree
+    const bool kdTree = physics.GetStats().method == "KD-Tree";
+    if (physics.GetStats().method != "Barnes-Hut" && !kdTree) {
         ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "Barnes-Hut not active");
         ImGui::Text("Barnes-Hut will be used when:");
         ImGui::BulletText("More than %d bodies", physics.GetConfig().maxBodiesForDirect);
@@ -731,7 +1211,7 @@ void UIManager::RenderBarnesHutPanel(const std::vector<std::unique_ptr<Body>>& b
     }
     
     // Show Barnes-Hut statistics
-    ImGui::Text("Barnes-Hut Statistics");
+    ImGui::Text(kdTree ? "Barnes-Hut Statistics (KD-Tree)" : "Barnes-Hut Statistics");
     ImGui::Separator();
     
     const auto& stats = physics.GetStats();
@@ -748,9 +1228,14 @@ void UIManager::RenderBarnesHutPanel(const std::vector<std::unique_ptr<Body>>& b
     // Visualization controls
     ImGui::Separator();
     ImGui::Text("Visualization");
+    // The overlay below draws quadtree cells only
+    ImGui::BeginDisabled(kdTree);
     ImGui::Checkbox("Show Barnes-Hut Tree", &m_visualizeBarnesHut);
+    ImGui::EndDisabled();
     
-    if (m_visualizeBarnesHut) {
+    if (kdTree) {
+        ImGui::TextDisabled("Show QuadTree under Visualization draws the KD-tree boxes");
+    } else if (m_visualizeBarnesHut) {
         // Use fixed values for now since we've inlined the visualization
         ImGui::Text("Tree visualization enabled");
         ImGui::Text("Using default visualization settings");
@@ -960,8 +1445,16 @@ void UIManager::ResetPhysicsParameters() {
     m_softeningLength = DEFAULT_SOFTENING_LENGTH;
     m_useBarnesHut = DEFAULT_USE_BARNES_HUT;
     m_barnesHutTheta = DEFAULT_BARNES_HUT_THETA;
+    m_useKDTree = DEFAULT_USE_KD_TREE;
     m_enableCollisions = DEFAULT_ENABLE_COLLISIONS;
+    m_treeCollisions = DEFAULT_TREE_COLLISIONS;
+    m_useNeighborLists = DEFAULT_USE_NEIGHBOR_LISTS;
+    m_continuousCollisions = DEFAULT_CONTINUOUS_COLLISIONS;
+    m_useEventDriven = DEFAULT_USE_EVENT_DRIVEN;
+    m_neighborSkin = DEFAULT_NEIGHBOR_SKIN;
     m_restitution = DEFAULT_RESTITUTION;
+    m_regularizeCloseEncounters = DEFAULT_REGULARIZE_CLOSE_ENCOUNTERS;
+    m_useWisdomHolman = DEFAULT_USE_WISDOM_HOLMAN;
     m_useGPU = DEFAULT_USE_GPU;
     
     // Trigger callback to update physics engine